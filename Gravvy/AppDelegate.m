@@ -441,8 +441,7 @@ static NSString *const kRemoteNotificationSoundFileExtension = @"caf";
                         GRVAlertBannerView *banner =
                         [GRVAlertBannerView alertBannerForView:[self viewForBannerAlert]
                                                          title:alertTitle message:alertMessage
-                                               avatarThumbnail:userAvatarView.thumbnail
-                                                  withInitials:userAvatarView.userInitials
+                                                    avatarView:userAvatarView
                                                    tappedBlock:^(GRVAlertBannerView *alertBanner)
                         {
                             // Hide alert banner
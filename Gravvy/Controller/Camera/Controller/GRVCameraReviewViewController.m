@@ -9,6 +9,8 @@
 #import "GRVCameraReviewViewController.h"
 #import "SCRecordSession.h"
 #import "GRVPlayerView.h"
+#import "GRVImageEncoder.h"
+#import "GRVConstants.h"
 
 #pragma mark - Constants
 // Define these constant for the key-value observation context.
@@ -40,6 +42,17 @@ static const NSString *PlayerRateContext;
 
 @implementation GRVCameraReviewViewController
 #pragma mark - Properties
+- (void)setPreviewImage:(UIImage *)previewImage
+{
+    _previewImage = previewImage;
+    
+    // Get the upload-ready JPEG bytes going in the background now so they are
+    // ready by the time the user is done reviewing.
+    [[GRVImageEncoder sharedEncoder] prepareJPEGDataForImage:_previewImage
+                                                 maximumSize:CGSizeMake(kGRVVideoSizeWidth, kGRVVideoSizeHeight)
+                                          compressionQuality:kGRVVideoPhotoCompressionQuality];
+}
+
 - (void)setPlayerReadyToPlay:(BOOL)playerReadyToPlay
 {
     _playerReadyToPlay = playerReadyToPlay;
@@ -16,6 +16,7 @@
 #import "GRVContact+AddressBook.h"
 #import "GRVAddressBookManager.h"
 #import "GRVUserViewHelper.h"
+#import "GRVContactNameIndex.h"
 #import "GRVUserAvatarView.h"
 #import "GRVMultiContactPickerViewController.h"
 #import "GRVConstants.h"
@@ -347,42 +348,30 @@ static NSString *const kFilteredContactCellNibName    = @"GRVFilteredContactPick
         return;
     }
     
-    // break up the search terms (separated by spaces)
-    NSArray *searchItems = [strippedSearchString componentsSeparatedByString:@" "];
-    
-    // build all the expressions for each value in the searchString
-    NSPredicate *firstNameStartsWithQuery = [NSPredicate predicateWithFormat:@"contact.firstName BEGINSWITH[c] %@", strippedSearchString];
-    NSPredicate *firstNameAndLastNameInQuery =[ NSPredicate predicateWithFormat:@"(contact.firstName BEGINSWITH[c] %@) && (contact.lastName BEGINSWITH[c] %@)", [searchItems firstObject], [searchItems lastObject]];
-    NSPredicate *lastNameStartsWithQuery = [NSPredicate predicateWithFormat:@"contact.lastName BEGINSWITH[c] %@", strippedSearchString];
-    
-    NSArray *fullNamePredicates = @[firstNameStartsWithQuery, firstNameAndLastNameInQuery, lastNameStartsWithQuery];
-    
-    // combine all the match predicates by "OR"s
-    NSCompoundPredicate *fullNameMatchPredicate = (NSCompoundPredicate *)[NSCompoundPredicate orPredicateWithSubpredicates:fullNamePredicates];
+    // The name index only holds users with an associated Address book contact.
+    NSArray *matchingUsers = [[GRVContactNameIndex sharedIndex] usersMatchingSearchString:strippedSearchString];
     
     // Don't forget that we are in a View Controller where we only show results
     // that meet the following conditions:
     // - users have an associated Address book contact.
     // - user is not already in list of selected numbers
     // - user is not excluded
-    NSMutableArray *selectedPhoneNumbers = [NSMutableArray array];
+    NSMutableSet *hiddenPhoneNumbers = [NSMutableSet set];
     for (GRVUser *selectedUser in self.privateSelectedContacts) {
-        [selectedPhoneNumbers addObject:selectedUser.phoneNumber];
+        [hiddenPhoneNumbers addObject:[selectedUser.phoneNumber lowercaseString]];
+    }
+    for (NSString *excludedPhoneNumber in self.excludedContactPhoneNumbers) {
+        [hiddenPhoneNumbers addObject:[excludedPhoneNumber lowercaseString]];
     }
-    NSPredicate *inAddressBookAndUnselectedAndNotExcludedPredicate = [NSPredicate predicateWithFormat:@"(contact != nil) AND (NOT (phoneNumber IN[c] %@)) AND (NOT (phoneNumber IN[c] %@))", selectedPhoneNumbers, self.excludedContactPhoneNumbers];
-    
-    NSCompoundPredicate *finalCompoundPredicate = (NSCompoundPredicate *)[NSCompoundPredicate andPredicateWithSubpredicates:@[fullNameMatchPredicate, inAddressBookAndUnselectedAndNotExcludedPredicate]];
-    
-    // Finally make fetch request
-    NSManagedObjectContext *managedObjectContext = [GRVModelManager sharedManager].managedObjectContext;
-    NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:@"GRVUser"];
-    request.relationshipKeyPathsForPrefetching = @[@"contact"];
     
-    request.sortDescriptors = [GRVUserViewHelper userNameSortDescriptors];
-    request.predicate = finalCompoundPredicate;
+    NSMutableArray *filteredContacts = [NSMutableArray arrayWithCapacity:[matchingUsers count]];
+    for (GRVUser *user in matchingUsers) {
+        if (![hiddenPhoneNumbers containsObject:[user.phoneNumber lowercaseString]]) {
+            [filteredContacts addObject:user];
+        }
+    }
     
-    NSError *error;
-    self.filteredContacts = [managedObjectContext executeFetchRequest:request error:&error];
+    self.filteredContacts = filteredContacts;
     [self refreshTableView];
 }
 
@@ -473,8 +462,7 @@ static NSString *const kFilteredContactCellNibName    = @"GRVFilteredContactPick
     // Configure the cell...
     // Avatar first
     GRVUserAvatarView *avatarView = [GRVUserViewHelper userAvatarView:user];
-    cell.avatarView.thumbnail = avatarView.thumbnail;
-    cell.avatarView.userInitials = avatarView.userInitials;
+    [cell.avatarView setAvatarFromAvatarView:avatarView];
     
     // Display name
     cell.displayNameLabel.text = [GRVUserViewHelper userFullName:user];
@@ -30,7 +30,9 @@
             if (self.debug) NSLog(@"[%@ %@] fetching all %@ (i.e., no predicate)", NSStringFromClass([self class]), NSStringFromSelector(_cmd), self.fetchedResultsController.fetchRequest.entityName);
         }
         NSError *error;
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
         [self.fetchedResultsController performFetch:&error];
+        if (self.debug) NSLog(@"[%@ %@] fetched %lu objects in %.1fms", NSStringFromClass([self class]), NSStringFromSelector(_cmd), (unsigned long)[self.fetchedResultsController.fetchedObjects count], (CFAbsoluteTimeGetCurrent() - startTime) * 1000.0);
         if (error) NSLog(@"[%@ %@] %@ (%@)", NSStringFromClass([self class]), NSStringFromSelector(_cmd), [error localizedDescription], [error localizedFailureReason]);
     } else {
         if (self.debug) NSLog(@"[%@ %@] no NSFetchedResultsController (yet?)", NSStringFromClass([self class]), NSStringFromSelector(_cmd));
@@ -24,14 +24,26 @@
 @property (copy, nonatomic, readwrite) NSString *password;
 @property (copy, nonatomic, readwrite) NSString *authenticationToken;
 @property (nonatomic, readwrite, getter=isAuthenticated) BOOL authenticated;
+@property (copy, atomic, readwrite) NSDictionary *authorizationHeaders;
 
 @property (strong, nonatomic) KeychainItemWrapper *keychain;
 
+/**
+ * Callbacks of the authentication request in flight, if any. These are nil
+ * when there's no authentication in flight.
+ */
+@property (strong, nonatomic) NSMutableArray *authenticationSuccessCallbacks;
+@property (strong, nonatomic) NSMutableArray *authenticationFailureCallbacks;
+
 @end
 
 
 @implementation GRVAccountManager
 
+// The authentication token is cached in memory, as it's needed for every
+// request, and written through to the keychain.
+@synthesize authenticationToken = _authenticationToken;
+
 #pragma mark - Properties
 #pragma mark Public
 - (NSString *)phoneNumber
@@ -76,13 +88,27 @@
 
 - (NSString *)authenticationToken
 {
-    // value changes frequently so no point in lazy instantiation
-    return  [self.keychain objectForKey:(__bridge id)(kSecAttrGeneric)];
+    @synchronized(self) {
+        if (!_authenticationToken) {
+            _authenticationToken = [self.keychain objectForKey:(__bridge id)(kSecAttrGeneric)];
+        }
+        return _authenticationToken;
+    }
 }
 
 - (void)setAuthenticationToken:(NSString *)authenticationToken
 {
-    [self.keychain setObject:[authenticationToken copy] forKey:(__bridge id)(kSecAttrGeneric)];
+    @synchronized(self) {
+        _authenticationToken = [authenticationToken copy];
+        [self.keychain setObject:_authenticationToken forKey:(__bridge id)(kSecAttrGeneric)];
+    }
+    [self updateAuthorizationHeaders];
+}
+
+- (void)setAuthenticated:(BOOL)authenticated
+{
+    _authenticated = authenticated;
+    [self updateAuthorizationHeaders];
 }
 
 - (BOOL)isRegistered
@@ -138,6 +164,9 @@
         // setup keychain... will be accessing it a lot here.
         self.keychain = [[KeychainItemWrapper alloc] initWithIdentifier:kGRVLoginKeychainIdentifier
                                                             accessGroup:nil];
+        
+        // not authenticated yet
+        self.authorizationHeaders = @{};
     }
     return self;
 }
@@ -210,15 +239,37 @@
 {
     // only bother an authentication attempt if there's a saved phone number and password
     if ([self.phoneNumber length] && [self.password length]) {
+        // If an authentication is already in flight just wait for its result
+        BOOL authenticationInFlight = (self.authenticationSuccessCallbacks != nil);
+        if (!authenticationInFlight) {
+            self.authenticationSuccessCallbacks = [NSMutableArray array];
+            self.authenticationFailureCallbacks = [NSMutableArray array];
+        }
+        if (success) [self.authenticationSuccessCallbacks addObject:[success copy]];
+        if (failure) [self.authenticationFailureCallbacks addObject:[failure copy]];
+        if (authenticationInFlight) return;
+        
         [self authenticatePhoneNumber:self.phoneNumber
                              password:self.password
                               success:^{
-                                  if (success) success();
+                                  NSArray *successCallbacks = self.authenticationSuccessCallbacks;
+                                  self.authenticationSuccessCallbacks = nil;
+                                  self.authenticationFailureCallbacks = nil;
+                                  
+                                  for (void (^successCallback)() in successCallbacks) {
+                                      successCallback();
+                                  }
                               }
                               failure:^(NSUInteger statusCode) {
                                   // failed to authentiate with current credentials
                                   // so maybe prompt user to register
-                                  if (failure) failure(statusCode);
+                                  NSArray *failureCallbacks = self.authenticationFailureCallbacks;
+                                  self.authenticationSuccessCallbacks = nil;
+                                  self.authenticationFailureCallbacks = nil;
+                                  
+                                  for (void (^failureCallback)(NSUInteger statusCode) in failureCallbacks) {
+                                      failureCallback(statusCode);
+                                  }
                               }
          ];
         
@@ -229,14 +280,54 @@
     }
 }
 
+- (void)reauthenticateAfterUnauthorizedRequestWithHeaders:(NSDictionary *)authorizationHeaders
+{
+    // authentication callbacks are only tracked on the main queue
+    if (![NSThread isMainThread]) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self reauthenticateAfterUnauthorizedRequestWithHeaders:authorizationHeaders];
+        });
+        return;
+    }
+    
+    // Requests made without credentials, or before the credentials were last
+    // replaced, don't call for another authentication. Every change of
+    // credentials makes a new snapshot, even if the token is the same.
+    if (![authorizationHeaders count] || (authorizationHeaders != self.authorizationHeaders)) return;
+    
+    // The token was rejected so stop sending it, which also keeps it off the
+    // authentication request itself.
+    self.authenticated = NO;
+    [self authenticateWithSuccess:nil failure:nil];
+}
+
 #pragma mark Public: Credentials
 - (void)resetCredentials
 {
-    [self.keychain resetKeychainItem];
+    @synchronized(self) {
+        [self.keychain resetKeychainItem];
+        _authenticationToken = nil;
+    }
+    [self updateAuthorizationHeaders];
 }
 
 
 #pragma mark Private
+/**
+ * Replace the authorization headers snapshot to match the current
+ * authentication status and token.
+ */
+- (void)updateAuthorizationHeaders
+{
+    NSString *authenticationToken = self.authenticationToken;
+    if (self.isAuthenticated && [authenticationToken length]) {
+        NSString *authorizationHeader = [NSString stringWithFormat:@"Token %@", authenticationToken];
+        self.authorizationHeaders = @{@"Authorization" : authorizationHeader};
+    } else {
+        self.authorizationHeaders = @{};
+    }
+}
+
 /**
  * Authenticate a given phone number and password.
  * Successful authentication results in the authenticated flag being set
@@ -263,6 +354,9 @@
                   forURL:kGRVRESTAccountObtainAuthToken
               parameters:parameters
                  success:^(NSURLSessionDataTask *task, id responseObject) {
+                     // extract token and save it before anyone is told of the
+                     // authentication, so their requests use it
+                     self.authenticationToken = [responseObject objectForKey:@"token"];
                      self.authenticated = YES;
                      
                      // Inform listeners that HTTP authentication is completed
@@ -273,9 +367,6 @@
                      // Set Crashlytics user information which is now available
                      [[Crashlytics sharedInstance] setUserName:phoneNumber];
                      
-                     // extract token and save it
-                     self.authenticationToken = [responseObject objectForKey:@"token"];;
-                     
                      // If you haven't already done so, register for push notifications
                      if (!self.apnsRegistered) {
                          
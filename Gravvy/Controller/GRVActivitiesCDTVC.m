@@ -183,8 +183,7 @@ static NSUInteger const kMaxDisplayedVideoTitleLength = 30;
     
     // Setup avatar first
     GRVUserAvatarView *avatarView = [GRVUserViewHelper userAvatarView:activity.actor];
-    cell.actorAvatarView.thumbnail = avatarView.thumbnail;
-    cell.actorAvatarView.userInitials = avatarView.userInitials;
+    [cell.actorAvatarView setAvatarFromAvatarView:avatarView];
     
     // Setup Video Image which is either the target or the object
     GRVVideo *video = activity.targetVideo ? activity.targetVideo : activity.objectVideo;
@@ -339,10 +338,8 @@ static NSUInteger const kMaxDisplayedVideoTitleLength = 30;
                 NSUInteger clipIndex = [video.currentClipIndex integerValue];
                 
                 // Use the video's ordered clips and update clipIndex appropriately
-                NSSortDescriptor *orderSd = [NSSortDescriptor sortDescriptorWithKey:@"order" ascending:YES];
-                NSArray *clips = [video.clips sortedArrayUsingDescriptors:@[orderSd]];
                 NSUInteger i = 0;
-                for (GRVClip *clip in clips) {
+                for (GRVClip *clip in video.clips) {
                     if ([clip.identifier integerValue] ==
                         [activity.objectClip.identifier integerValue]) {
                         clipIndex = i;
@@ -15,6 +15,7 @@
 #import "GRVClip+HTTP.h"
 #import "GRVModelManager.h"
 #import "GRVUserViewHelper.h"
+#import "GRVImageEncoder.h"
 
 #pragma mark - Constants
 /**
@@ -65,26 +66,41 @@ static NSString *const kUnwindSegueIdentifier = @"addedClip";
     }
 }
 
-#pragma mark - Target/Action Methods
-- (IBAction)addClip:(UIBarButtonItem *)sender
+/**
+ * Let the user know the clip couldn't be added so they can try again.
+ */
+- (void)clipUploadFailed
 {
-    // Generate complete video details parameters
-    NSTimeInterval duration = CMTimeGetSeconds(self.recordSession.duration);
-    NSDictionary *parameters = @{kGRVRESTClipDurationKey: @(duration)};
-    
-    // temporarily disable add buttons
-    self.addButton.enabled = NO;
+    [GRVHTTPManager alertWithFailedResponse:nil
+                         withAlternateTitle:@"Can't add clip to video."
+                                 andMessage:@"Something went wrong. Please try again."];
+    // enable button
+    self.addButton.enabled = YES;
     
-    // inform user of server activity.
-    [self.spinner startAnimating];
-    self.videoTitleLabel.hidden = YES;
+    // inform user server activity is done
+    [self.spinner stopAnimating];
+    self.videoTitleLabel.hidden = NO;
+}
+
+/**
+ * Upload the recorded clip to the server.
+ *
+ * @param parameters    Clip details parameters
+ * @param photoData     JPEG bytes of the clip's preview image. The upload is
+ *      abandoned if this is nil as clips must have a photo.
+ */
+- (void)uploadClipWithParameters:(NSDictionary *)parameters photoData:(NSData *)photoData
+{
+    if (!photoData) {
+        [self clipUploadFailed];
+        return;
+    }
     
-    // Upload video to the server
     NSString *videoClipListURL = [GRVRestUtils videoClipListURL:self.video.hashKey];
-    [[GRVHTTPManager sharedManager] operationRequest:GRVHTTPMethodPOST
-                                              forURL:videoClipListURL
-                                          parameters:[parameters copy]
-                           constructingBodyWithBlock:^(id<AFMultipartFormData> formData)
+    [[GRVHTTPManager sharedManager] request:GRVHTTPMethodPOST
+                                     forURL:videoClipListURL
+                                 parameters:parameters
+                  constructingBodyWithBlock:^(id<AFMultipartFormData> formData)
     {
         // Come up with a random file name. Doesn't have
         // to be unique as the server will handle that
@@ -96,14 +112,15 @@ static NSString *const kUnwindSegueIdentifier = @"addedClip";
                                     name:kGRVRESTClipMp4Key
                                 fileName:mp4FileName
                                 mimeType:@"video/mp4"];
-        [formData appendPartWithFileData:UIImageJPEGRepresentation(self.previewImage,
-                                                                   kGRVVideoPhotoCompressionQuality)
+        [formData appendPartWithFileData:photoData
                                     name:kGRVRESTClipPhotoKey
                                 fileName:photoFileName
                                 mimeType:@"image/jpeg"];
     }
-                                             success:^(AFHTTPRequestOperation *operation, id responseObject)
+                                    success:^(NSURLSessionDataTask *task, id responseObject)
     {
+        [[GRVImageEncoder sharedEncoder] discardJPEGDataForImage:self.previewImage];
+        
         // Sync new clip
         self.addedClip = [GRVClip clipWithClipInfo:responseObject
                                    associatedVideo:self.video
@@ -113,19 +130,35 @@ static NSString *const kUnwindSegueIdentifier = @"addedClip";
         [self performSegueWithIdentifier:kUnwindSegueIdentifier sender:self];
         
     }
-                                             failure:^(AFHTTPRequestOperation *operation, NSError *error)
+                                    failure:^(NSURLSessionDataTask *task, NSError *error, id responseObject)
     {
-        [GRVHTTPManager alertWithFailedResponse:nil
-                             withAlternateTitle:@"Can't add clip to video."
-                                     andMessage:@"Something went wrong. Please try again."];
-        // enable button
-        self.addButton.enabled = YES;
-        
-        // inform user server activity is done
-        [self.spinner stopAnimating];
-        self.videoTitleLabel.hidden = NO;
-    }
-                                 operationDependency:nil];
+        [self clipUploadFailed];
+    }];
+}
+
+#pragma mark - Target/Action Methods
+- (IBAction)addClip:(UIBarButtonItem *)sender
+{
+    // Generate complete video details parameters
+    NSTimeInterval duration = CMTimeGetSeconds(self.recordSession.duration);
+    NSDictionary *parameters = @{kGRVRESTClipDurationKey: @(duration)};
+    
+    // temporarily disable add buttons
+    self.addButton.enabled = NO;
+    
+    // inform user of server activity.
+    [self.spinner startAnimating];
+    self.videoTitleLabel.hidden = YES;
+    
+    // Upload video to the server once the preview image's JPEG bytes are
+    // ready. These are encoded in the background so are typically already
+    // done by now.
+    [[GRVImageEncoder sharedEncoder] JPEGDataForImage:self.previewImage
+                                          maximumSize:CGSizeMake(kGRVVideoSizeWidth, kGRVVideoSizeHeight)
+                                   compressionQuality:kGRVVideoPhotoCompressionQuality
+                                           completion:^(NSData *jpegData) {
+                                               [self uploadClipWithParameters:parameters photoData:jpegData];
+                                           }];
 }
 
 @end
@@ -0,0 +1,83 @@
+//
+//  GRVAvatarImageCache.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/14/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+
+/**
+ * GRVAvatarImageCache renders circular user avatar bitmaps in the background
+ * and keeps the results around so avatar views only have to display a ready
+ * bitmap.
+ *
+ * @discussion Bitmaps are keyed by an avatar identifier, which captures both
+ *      the user and the version of the avatar's source image, along with the
+ *      diameter and scale they were rendered at. The cache is bounded by bitmap
+ *      bytes and is emptied on memory warnings.
+ */
+@interface GRVAvatarImageCache : NSObject
+
+#pragma mark - Class Methods
+/**
+ * Single instance.
+ * It creates the instance if this hasn't been done or simply returns it.
+ *
+ * @return An initialized GRVAvatarImageCache object.
+ */
++ (instancetype)sharedCache;
+
+/**
+ * Key of a rendered avatar bitmap in the cache.
+ *
+ * @param avatarIdentifier  Identity and version of the avatar's source image
+ * @param diameter          Diameter, in points, of the avatar circle
+ * @param scale             Scale factor of the bitmap
+ *
+ * @return cache key, or nil if there isn't an avatar identifier.
+ */
++ (NSString *)cacheKeyForAvatarIdentifier:(NSString *)avatarIdentifier
+                                 diameter:(CGFloat)diameter
+                                    scale:(CGFloat)scale;
+
+#pragma mark - Instance Methods
+/**
+ * Get an already rendered avatar bitmap. This is cheap enough to be called on
+ * the main thread while configuring cells.
+ *
+ * @param cacheKey  Key generated by cacheKeyForAvatarIdentifier:diameter:scale:
+ *
+ * @return cached avatar image, or nil if it hasn't been rendered.
+ */
+- (UIImage *)avatarImageForKey:(NSString *)cacheKey;
+
+/**
+ * Render a circular avatar image in the background.
+ *
+ * If there's a thumbnail it is cropped to a circle, else if there are initials
+ * they are drawn on a circular background, else the default avatar is used.
+ *
+ * @param thumbnail     Avatar thumbnail image
+ * @param initials      User initials to use if there's no thumbnail
+ * @param diameter      Diameter, in points, of the avatar circle. Must be > 0.
+ * @param scale         Scale factor of the rendered bitmap
+ * @param cacheKey      Key to save the rendered bitmap under. Pass nil to skip
+ *      caching the result.
+ * @param completion    block to be called on the main queue with the rendered
+ *      avatar image.
+ */
+- (void)renderAvatarWithThumbnail:(UIImage *)thumbnail
+                         initials:(NSString *)initials
+                         diameter:(CGFloat)diameter
+                            scale:(CGFloat)scale
+                         cacheKey:(NSString *)cacheKey
+                       completion:(void (^)(UIImage *avatarImage))completion;
+
+/**
+ * Evict all rendered avatar bitmaps.
+ */
+- (void)removeAllAvatarImages;
+
+@end
@@ -0,0 +1,300 @@
+//
+//  GRVAvatarImageCache.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/14/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVAvatarImageCache.h"
+#import "GRVConstants.h"
+
+#pragma mark - Constants
+/**
+ * Maximum number of bytes of rendered avatar bitmaps to hold on to.
+ */
+static NSUInteger const kAvatarCacheTotalCostLimit = 8 * 1024 * 1024; // 8mb
+
+// max # of characters in initials.
+static NSUInteger const kMaxUserInitialsLength  = 3;
+
+/**
+ * Avatar view user initials text font size and corresponding diameter, as this
+ * font must scale with size
+ */
+static CGFloat const kUserAvatarFontSize = 12.0f;
+static CGFloat const kUserAvatarMaxFontSize = 13.0f;
+static CGFloat const kUserAvatarFontScale = 1.0f/28.0;
+
+
+@interface GRVAvatarImageCache ()
+
+#pragma mark - Properties
+/**
+ * Rendered avatar bitmaps keyed by cache key, with a cost of bitmap bytes.
+ */
+@property (strong, nonatomic) NSCache *avatarImages;
+
+/**
+ * Serial queue on which all avatar rendering happens. Because it is serial,
+ * duplicate requests for the same avatar find it cached by the time they run.
+ */
+@property (strong, nonatomic) dispatch_queue_t renderingQueue;
+
+/**
+ * Avatar used when there's neither a thumbnail nor initials. This is loaded
+ * upfront as asset catalog lookups aren't safe off the main thread.
+ */
+@property (strong, nonatomic) UIImage *defaultAvatarImage;
+
+@end
+
+@implementation GRVAvatarImageCache
+
+#pragma mark - Class Methods
++ (instancetype)sharedCache
+{
+    static GRVAvatarImageCache *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[self alloc] initPrivate];
+    });
+    return sharedInstance;
+}
+
++ (NSString *)cacheKeyForAvatarIdentifier:(NSString *)avatarIdentifier
+                                 diameter:(CGFloat)diameter
+                                    scale:(CGFloat)scale
+{
+    if (![avatarIdentifier length]) return nil;
+    return [NSString stringWithFormat:@"%@|%.1f@%.0fx", avatarIdentifier, diameter, scale];
+}
+
+#pragma mark - Initializers
+/*
+ * ideally we would make the designated initializer of the superclass call
+ *   the new designated initializer, but that doesn't make sense in this case.
+ * if a programmer calls [GRVAvatarImageCache alloc] init], let him know the
+ *   error of his ways.
+ */
+- (instancetype)init
+{
+    @throw [NSException exceptionWithName:@"Singleton"
+                                   reason:@"Use +[GRVAvatarImageCache sharedCache]"
+                                 userInfo:nil];
+    return nil;
+}
+
+// here is the real (secret) initializer
+// this is the official designated initializer so call the designated
+// initializer of the superclass
+- (instancetype)initPrivate
+{
+    self = [super init];
+    if (self) {
+        _avatarImages = [[NSCache alloc] init];
+        _avatarImages.totalCostLimit = kAvatarCacheTotalCostLimit;
+        _renderingQueue = dispatch_queue_create("com.nceruchalu.gravvy.avatarrendering", DISPATCH_QUEUE_SERIAL);
+        _defaultAvatarImage = [UIImage imageNamed:@"defaultAvatar"];
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(removeAllAvatarImages)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+
+#pragma mark - Instance Methods
+#pragma mark Public
+- (UIImage *)avatarImageForKey:(NSString *)cacheKey
+{
+    if (!cacheKey) return nil;
+    return [self.avatarImages objectForKey:cacheKey];
+}
+
+- (void)renderAvatarWithThumbnail:(UIImage *)thumbnail
+                         initials:(NSString *)initials
+                         diameter:(CGFloat)diameter
+                            scale:(CGFloat)scale
+                         cacheKey:(NSString *)cacheKey
+                       completion:(void (^)(UIImage *avatarImage))completion
+{
+    dispatch_async(self.renderingQueue, ^{
+        UIImage *avatarImage = [self avatarImageForKey:cacheKey];
+
+        if (!avatarImage && (diameter > 0)) {
+            @autoreleasepool {
+                avatarImage = [self renderAvatarWithThumbnail:thumbnail
+                                                     initials:initials
+                                                     diameter:diameter
+                                                        scale:scale];
+            }
+
+            if (avatarImage && cacheKey) {
+                NSUInteger cost = (NSUInteger)(avatarImage.size.width * avatarImage.scale *
+                                               avatarImage.size.height * avatarImage.scale * 4);
+                [self.avatarImages setObject:avatarImage forKey:cacheKey cost:cost];
+            }
+        }
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (completion) completion(avatarImage);
+        });
+    });
+}
+
+- (void)removeAllAvatarImages
+{
+    [self.avatarImages removeAllObjects];
+}
+
+#pragma mark Private
+/**
+ * Generate a circular avatar image.
+ *
+ * @warning This does the actual drawing so should not be called on the main
+ *      thread.
+ */
+- (UIImage *)renderAvatarWithThumbnail:(UIImage *)thumbnail
+                              initials:(NSString *)initials
+                              diameter:(CGFloat)diameter
+                                 scale:(CGFloat)scale
+{
+    UIImage *avatarImage = nil;
+    if (thumbnail) {
+        // Convert thumbnail to a circular image
+        avatarImage = [GRVAvatarImageCache circularImage:thumbnail
+                                            withDiameter:diameter
+                                                   scale:scale];
+
+    } else if ([initials length]) {
+        if ([initials length] > kMaxUserInitialsLength) {
+            initials = @"...";
+        }
+        CGFloat fontSize = kUserAvatarFontSize * diameter *kUserAvatarFontScale;
+        fontSize = MIN(fontSize, kUserAvatarMaxFontSize);
+        UIFont *font = [UIFont boldSystemFontOfSize:fontSize];
+        avatarImage = [GRVAvatarImageCache imageWithInitials:initials
+                                             backgroundColor:kGRVUserAvatarBackgroundColor
+                                                   textColor:kGRVUserAvatarTextColor
+                                                        font:font
+                                                    diameter:diameter
+                                                       scale:scale];
+    } else if (self.defaultAvatarImage) {
+        // No thumbnail or initials?, use a default avatar image
+        avatarImage = [GRVAvatarImageCache circularImage:self.defaultAvatarImage
+                                            withDiameter:diameter
+                                                   scale:scale];
+    }
+    return avatarImage;
+}
+
+/**
+ * Generate a circular image from provided initials
+ *
+ * Derived from JSQMessagesViewController's
+ * jsq_imageWitInitials:backgroundColor:textColor:font:diameter:
+ *
+ * @param initials          intials to be used to generate an avatar image
+ * @param backgroundColor   background color of avatar image.
+ * @param textColor         color of initials in avatar image
+ * @param font              font of initials in avatar image
+ * @param diameter          diameter of avatar image circle.
+ * @param scale             scale factor of the avatar image
+ *
+ * @return a composed UIImage.
+ */
++ (UIImage *)imageWithInitials:(NSString *)initials
+               backgroundColor:(UIColor *)backgroundColor
+                     textColor:(UIColor *)textColor
+                          font:(UIFont *)font
+                      diameter:(CGFloat)diameter
+                         scale:(CGFloat)scale
+{
+    NSParameterAssert(initials != nil);
+    NSParameterAssert(backgroundColor != nil);
+    NSParameterAssert(textColor != nil);
+    NSParameterAssert(font != nil);
+    NSParameterAssert(diameter > 0);
+
+    CGRect frame = CGRectMake(0.0f, 0.0f, diameter, diameter);
+
+    NSString *text = [initials uppercaseStringWithLocale:[NSLocale currentLocale]];
+
+    NSDictionary *attributes = @{ NSFontAttributeName : font,
+                                  NSForegroundColorAttributeName : textColor };
+
+    CGRect textFrame = [text boundingRectWithSize:frame.size
+                                          options:(NSStringDrawingUsesLineFragmentOrigin | NSStringDrawingUsesFontLeading)
+                                       attributes:attributes
+                                          context:nil];
+
+    CGPoint frameMidPoint = CGPointMake(CGRectGetMidX(frame), CGRectGetMidY(frame));
+    CGPoint textFrameMidPoint = CGPointMake(CGRectGetMidX(textFrame), CGRectGetMidY(textFrame));
+
+    CGFloat dx = frameMidPoint.x - textFrameMidPoint.x;
+    CGFloat dy = frameMidPoint.y - textFrameMidPoint.y;
+    CGPoint drawPoint = CGPointMake(dx, dy);
+    UIImage *image = nil;
+
+    // Draw straight into the circle rather than compositing an intermediate
+    // square image.
+    UIGraphicsBeginImageContextWithOptions(frame.size, NO, scale);
+    {
+        [[UIBezierPath bezierPathWithOvalInRect:frame] addClip];
+
+        [backgroundColor setFill];
+        UIRectFill(frame);
+        [text drawAtPoint:drawPoint withAttributes:attributes];
+
+        image = UIGraphicsGetImageFromCurrentImageContext();
+    }
+    UIGraphicsEndImageContext();
+
+    return image;
+}
+
+
+/**
+ * Generate a circular image from provided rectangular image
+ *
+ * Derived from JSQMessagesViewController's
+ * jsq_circularImage:withDiamter:highlightedColor:
+ *
+ * @param image             Image to be cropped to a circular view.
+ * @param diameter          diameter of avatar image circle. Must be > 0.
+ * @param scale             scale factor of the avatar image
+ *
+ * @return a composed UIImage.
+ */
++ (UIImage *)circularImage:(UIImage *)image
+              withDiameter:(CGFloat)diameter
+                     scale:(CGFloat)scale
+{
+    NSParameterAssert(image != nil);
+    NSParameterAssert(diameter > 0);
+
+    CGRect frame = CGRectMake(0.0f, 0.0f, diameter, diameter);
+    UIImage *newImage = nil;
+
+    UIGraphicsBeginImageContextWithOptions(frame.size, NO, scale);
+    {
+        UIBezierPath *imgPath = [UIBezierPath bezierPathWithOvalInRect:frame];
+        [imgPath addClip];
+        [image drawInRect:frame];
+
+        newImage = UIGraphicsGetImageFromCurrentImageContext();
+    }
+    UIGraphicsEndImageContext();
+
+    return newImage;
+}
+
+@end
@@ -211,10 +211,7 @@ static NSString *const kDeleteClipsButtonTitleDeleting = @"Deleting... Please Wa
     // Configure deleteClipsButton
     self.deleteClipsButton.enabled = NO;
     
-    NSSortDescriptor *orderSd = [NSSortDescriptor sortDescriptorWithKey:@"order" ascending:YES];
-    NSArray *clips = [self.video.clips sortedArrayUsingDescriptors:@[orderSd]];
-    
-    for (GRVClip *clip in clips) {
+    for (GRVClip *clip in self.video.clips) {
         
         // Confirm that clip hasn't been deleted
         if ([clip hasBeenDeleted]) {
@@ -334,10 +331,15 @@ static NSString *const kDeleteClipsButtonTitleDeleting = @"Deleting... Please Wa
         self.deleteClipsButton.title = kDeleteClipsButtonTitleDeleting;
         self.view.userInteractionEnabled = NO;
         
-        [self.video deleteClips:clipsToDelete withCompletion:^(NSError *error, id responseObject) {
+        [self.video deleteClips:clipsToDelete withCompletion:^(NSError *error, id responseObject, NSDictionary *clipErrors) {
             self.view.userInteractionEnabled = YES;
-            if (error) {
+            if ([clipErrors count] == [clipsToDelete count]) {
                 [GRVHTTPManager alertWithFailedResponse:responseObject withAlternateTitle:@"Something went wrong" andMessage:@"Please try that again."];
+            } else if ([clipErrors count]) {
+                NSUInteger failedClipsCount = [clipErrors count];
+                [GRVHTTPManager alertWithFailedResponse:responseObject
+                                     withAlternateTitle:@"Some clips weren't deleted"
+                                             andMessage:[NSString stringWithFormat:@"%lu of %lu clips couldn't be deleted. Please try those again.", (unsigned long)failedClipsCount, (unsigned long)[clipsToDelete count]]];
             } else {
                 [self showProgressHUDSuccessMessage:@"Deleted clips"];
             }
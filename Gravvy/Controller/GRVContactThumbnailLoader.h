@@ -0,0 +1,77 @@
+//
+//  GRVContactThumbnailLoader.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/28/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+
+/**
+ * GRVContactThumbnailLoader reads address book contact thumbnails on demand,
+ * by record ID, when they are about to be displayed. Contacts sync doesn't
+ * copy image data into Core Data.
+ *
+ * @discussion Thumbnails are read from the address book and decoded on a
+ *      background queue, then kept in a cache whose limit is in bytes
+ *      (kGRVContactThumbnailCacheMemoryCapacity) and which is emptied on
+ *      memory warnings. Thumbnails are keyed by record ID and the contact's
+ *      modification date, as the address book touches a record whenever its
+ *      image changes. Records found to have no image are remembered so they
+ *      aren't read again.
+ *
+ *      When a thumbnail is loaded a kGRVContactThumbnailLoadedNotification is
+ *      posted on the main queue so avatar views waiting on it can be updated.
+ *
+ * @warning Only use this on the main thread.
+ */
+@interface GRVContactThumbnailLoader : NSObject
+
+#pragma mark - Class Methods
+/**
+ * Single instance.
+ * It creates the instance if this hasn't been done or simply returns it.
+ *
+ * @return An initialized GRVContactThumbnailLoader object.
+ */
++ (instancetype)sharedLoader;
+
+/**
+ * Identifier of a contact thumbnail avatar, as used by GRVUserAvatarView.
+ *
+ * @param recordId      Record identifier of the contact in the address book
+ * @param updatedAt     Modification date of the contact
+ *
+ * @return avatar identifier that changes whenever the contact's image does.
+ */
++ (NSString *)avatarIdentifierForRecordId:(NSNumber *)recordId updatedAt:(NSDate *)updatedAt;
+
+#pragma mark - Instance Methods
+/**
+ * Get an already loaded contact thumbnail.
+ *
+ * @param recordId      Record identifier of the contact in the address book
+ * @param updatedAt     Modification date of the contact
+ *
+ * @return decoded thumbnail or nil if it isn't in the cache.
+ */
+- (UIImage *)cachedThumbnailForRecordId:(NSNumber *)recordId updatedAt:(NSDate *)updatedAt;
+
+/**
+ * Asynchronously load a contact's thumbnail, if it isn't already loaded or
+ * being loaded, or known to not exist. A kGRVContactThumbnailLoadedNotification
+ * is posted if a thumbnail is loaded. Nothing is loaded, or remembered as
+ * missing, while address book access isn't authorized.
+ *
+ * @param recordId      Record identifier of the contact in the address book
+ * @param updatedAt     Modification date of the contact
+ */
+- (void)loadThumbnailForRecordId:(NSNumber *)recordId updatedAt:(NSDate *)updatedAt;
+
+/**
+ * Evict all loaded thumbnails.
+ */
+- (void)removeAllThumbnails;
+
+@end
@@ -0,0 +1,227 @@
+//
+//  GRVContactThumbnailLoader.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/28/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVContactThumbnailLoader.h"
+#import <AddressBook/AddressBook.h>
+#import "GRVAddressBookManager.h"
+#import "GRVConstants.h"
+#import "UIImage+GRVUtilities.h"
+
+@interface GRVContactThumbnailLoader ()
+
+#pragma mark - Properties
+/**
+ * Decoded thumbnails keyed by record ID and modification date, with a cost of
+ * bitmap bytes.
+ */
+@property (strong, nonatomic) NSCache *decodedThumbnails;
+
+/**
+ * Keys of records that have no image, and of records currently being loaded.
+ */
+@property (strong, nonatomic) NSMutableSet *missingThumbnailKeys;
+@property (strong, nonatomic) NSMutableSet *loadingThumbnailKeys;
+
+/**
+ * Queue on which the address book is read and thumbnails decoded.
+ */
+@property (strong, nonatomic) dispatch_queue_t loadQueue;
+
+/**
+ * Address book only used on the load queue, as address book objects can't be
+ * shared across threads.
+ */
+@property (nonatomic) ABAddressBookRef addressBook;
+
+/**
+ * Scale of thumbnails, which is the main screen's scale. This is read upfront
+ * as UIScreen isn't safe to use off the main thread.
+ */
+@property (nonatomic) CGFloat scale;
+
+@end
+
+@implementation GRVContactThumbnailLoader
+
+#pragma mark - Class Methods
++ (instancetype)sharedLoader
+{
+    static GRVContactThumbnailLoader *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[self alloc] initPrivate];
+    });
+    return sharedInstance;
+}
+
++ (NSString *)avatarIdentifierForRecordId:(NSNumber *)recordId updatedAt:(NSDate *)updatedAt
+{
+    return [NSString stringWithFormat:@"contact:%@:%f", recordId, [updatedAt timeIntervalSince1970]];
+}
+
+#pragma mark - Initializers
+/*
+ * ideally we would make the designated initializer of the superclass call
+ *   the new designated initializer, but that doesn't make sense in this case.
+ * if a programmer calls [GRVContactThumbnailLoader alloc] init], let him know
+ *   the error of his ways.
+ */
+- (instancetype)init
+{
+    @throw [NSException exceptionWithName:@"Singleton"
+                                   reason:@"Use +[GRVContactThumbnailLoader sharedLoader]"
+                                 userInfo:nil];
+    return nil;
+}
+
+// here is the real (secret) initializer
+// this is the official designated initializer so call the designated
+// initializer of the superclass
+- (instancetype)initPrivate
+{
+    self = [super init];
+    if (self) {
+        _decodedThumbnails = [[NSCache alloc] init];
+        _decodedThumbnails.totalCostLimit = kGRVContactThumbnailCacheMemoryCapacity;
+        _missingThumbnailKeys = [NSMutableSet set];
+        _loadingThumbnailKeys = [NSMutableSet set];
+        _loadQueue = dispatch_queue_create("com.nceruchalu.gravvy.contactthumbnailload", DISPATCH_QUEUE_SERIAL);
+        _scale = [UIScreen mainScreen].scale;
+
+        NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+        [notificationCenter addObserver:self
+                               selector:@selector(removeAllThumbnails)
+                                   name:UIApplicationDidReceiveMemoryWarningNotification
+                                 object:nil];
+        [notificationCenter addObserver:self
+                               selector:@selector(contactsRefreshed:)
+                                   name:kGRVContactsRefreshedNotification
+                                 object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    if (_addressBook) CFRelease(_addressBook), _addressBook = NULL;
+}
+
+
+#pragma mark - Instance Methods
+#pragma mark Private
+/**
+ * Key of a contact's thumbnail in the cache.
+ */
++ (NSString *)cacheKeyForRecordId:(NSNumber *)recordId updatedAt:(NSDate *)updatedAt
+{
+    return [NSString stringWithFormat:@"%@:%f", recordId, [updatedAt timeIntervalSince1970]];
+}
+
+/**
+ * Read and decode a contact's thumbnail from the address book.
+ *
+ * @warning This must only be called on the load queue.
+ *
+ * @param recordId      Record identifier of the contact in the address book
+ * @param unavailable   Set to YES if the address book couldn't be read, such as
+ *      when access isn't authorized yet, so a nil return says nothing about
+ *      the record.
+ *
+ * @return decoded thumbnail, or nil if the record doesn't exist or has no image.
+ */
+- (UIImage *)thumbnailFromAddressBookForRecordId:(NSNumber *)recordId
+                            addressBookUnavailable:(BOOL *)unavailable
+{
+    *unavailable = NO;
+    if (!self.addressBook) {
+        if ([GRVAddressBookManager authorized]) {
+            self.addressBook = ABAddressBookCreateWithOptions(NULL, NULL);
+        }
+        if (!self.addressBook) {
+            *unavailable = YES;
+            return nil;
+        }
+    }
+
+    ABRecordRef personRecord = ABAddressBookGetPersonWithRecordID(self.addressBook, (ABRecordID)[recordId intValue]);
+    if (!personRecord || !ABPersonHasImageData(personRecord)) return nil;
+
+    CFDataRef imageDataRef = ABPersonCopyImageDataWithFormat(personRecord, kABPersonImageFormatThumbnail);
+    NSData *imageData = (__bridge_transfer NSData *)imageDataRef;
+    UIImage *image = imageData ? [UIImage imageWithData:imageData scale:self.scale] : nil;
+
+    return [image decodedImage];
+}
+
+#pragma mark Public
+- (UIImage *)cachedThumbnailForRecordId:(NSNumber *)recordId updatedAt:(NSDate *)updatedAt
+{
+    if (!recordId) return nil;
+    return [self.decodedThumbnails objectForKey:[GRVContactThumbnailLoader cacheKeyForRecordId:recordId updatedAt:updatedAt]];
+}
+
+- (void)loadThumbnailForRecordId:(NSNumber *)recordId updatedAt:(NSDate *)updatedAt
+{
+    if (!recordId) return;
+
+    NSString *cacheKey = [GRVContactThumbnailLoader cacheKeyForRecordId:recordId updatedAt:updatedAt];
+    if ([self.decodedThumbnails objectForKey:cacheKey] ||
+        [self.missingThumbnailKeys containsObject:cacheKey] ||
+        [self.loadingThumbnailKeys containsObject:cacheKey]) {
+        return;
+    }
+    [self.loadingThumbnailKeys addObject:cacheKey];
+
+    dispatch_async(self.loadQueue, ^{
+        UIImage *thumbnail = nil;
+        BOOL addressBookUnavailable = NO;
+        @autoreleasepool {
+            thumbnail = [self thumbnailFromAddressBookForRecordId:recordId
+                                           addressBookUnavailable:&addressBookUnavailable];
+        }
+        if (thumbnail) {
+            CGImageRef thumbnailRef = thumbnail.CGImage;
+            NSUInteger cost = CGImageGetBytesPerRow(thumbnailRef) * CGImageGetHeight(thumbnailRef);
+            [self.decodedThumbnails setObject:thumbnail forKey:cacheKey cost:cost];
+        }
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self.loadingThumbnailKeys removeObject:cacheKey];
+            if (thumbnail) {
+                [[NSNotificationCenter defaultCenter] postNotificationName:kGRVContactThumbnailLoadedNotification
+                                                                    object:self
+                                                                  userInfo:@{kGRVContactThumbnailRecordIdKey : recordId}];
+            } else if (!addressBookUnavailable) {
+                // Only remember a record has no image if the address book was
+                // actually read, so it's tried again once access is granted.
+                [self.missingThumbnailKeys addObject:cacheKey];
+            }
+        });
+    });
+}
+
+- (void)removeAllThumbnails
+{
+    [self.decodedThumbnails removeAllObjects];
+    [self.missingThumbnailKeys removeAllObjects];
+}
+
+
+#pragma mark - Notification Observer Methods
+/**
+ * The address book changed, so discard the load queue's stale copy of it.
+ */
+- (void)contactsRefreshed:(NSNotification *)aNotification
+{
+    dispatch_async(self.loadQueue, ^{
+        if (self.addressBook) ABAddressBookRevert(self.addressBook);
+    });
+}
+
+@end
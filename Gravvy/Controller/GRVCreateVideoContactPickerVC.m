@@ -11,6 +11,7 @@
 #import "GRVHTTPManager.h"
 #import "GRVUser.h"
 #import "GRVVideo+HTTP.h"
+#import "GRVImageEncoder.h"
 
 #pragma mark - Constants
 /**
@@ -37,40 +38,41 @@ static NSString *const kUnwindSegueIdentifier = @"createdVideo";
 }
 
 
-#pragma mark - Target/Action Methods
-- (IBAction)createVideo:(UIBarButtonItem *)sender
+#pragma mark Private
+/**
+ * Let the user know the video couldn't be created so they can try again.
+ */
+- (void)videoUploadFailed
 {
-    // Create the video users JSON object
-    NSMutableArray *videoUsersJSON = [NSMutableArray array];
-    for (GRVUser *selectedUser in self.selectedContacts) {
-        NSDictionary *phoneNumberJSON = @{kGRVRESTUserPhoneNumberKey : selectedUser.phoneNumber};
-        [videoUsersJSON addObject:phoneNumberJSON];
-    }
+    [GRVHTTPManager alertWithFailedResponse:nil
+                         withAlternateTitle:@"Can't create video."
+                                 andMessage:@"Something went wrong. Please try again."];
     
-    // Key for the duration object in the lead clip
-    NSString *durationKey = [NSString stringWithFormat:@"%@.%@", kGRVRESTVideoLeadClipKey, kGRVRESTClipDurationKey];
-    // Parameters required for video upload
+    // refresh create button
+    [self selectedContactsChanged];
     
-    NSMutableDictionary *parameters = [@{durationKey: @(self.duration),
-                                         kGRVRESTVideoUsersKey: videoUsersJSON} mutableCopy];
-    if ([self.videoTitle length]) {
-        parameters[kGRVRESTVideoTitleKey] = self.videoTitle;
+    // inform user server activity is done
+    [self stopSpinner];
+}
+
+/**
+ * Upload the recorded video to the server.
+ *
+ * @param parameters    Video details parameters
+ * @param photoData     JPEG bytes of the video's preview image. The upload is
+ *      abandoned if this is nil as videos must have a photo.
+ */
+- (void)uploadVideoWithParameters:(NSDictionary *)parameters photoData:(NSData *)photoData
+{
+    if (!photoData) {
+        [self videoUploadFailed];
+        return;
     }
     
-    // temporarily disable create button
-    self.createButton.enabled = NO;
-    
-    // Hide keyboard if showing
-    [self.view endEditing:YES];
-    
-    // inform user of server activity.
-    [self startSpinner];
-    
-    // Upload video to the server
-    [[GRVHTTPManager sharedManager] operationRequest:GRVHTTPMethodPOST
-                                              forURL:kGRVRESTVideos
-                                          parameters:[parameters copy]
-                           constructingBodyWithBlock:^(id<AFMultipartFormData> formData)
+    [[GRVHTTPManager sharedManager] request:GRVHTTPMethodPOST
+                                     forURL:kGRVRESTVideos
+                                 parameters:parameters
+                  constructingBodyWithBlock:^(id<AFMultipartFormData> formData)
      {
          // Keys for mp4 and photo object in request
          NSString *mp4Key = [NSString stringWithFormat:@"%@.%@", kGRVRESTVideoLeadClipKey, kGRVRESTClipMp4Key];
@@ -86,14 +88,15 @@ static NSString *const kUnwindSegueIdentifier = @"createdVideo";
                                      name:mp4Key
                                  fileName:mp4FileName
                                  mimeType:@"video/mp4"];
-         [formData appendPartWithFileData:UIImageJPEGRepresentation(self.previewImage,
-                                                                    kGRVVideoPhotoCompressionQuality)
+         [formData appendPartWithFileData:photoData
                                      name:photoKey
                                  fileName:photoFileName
                                  mimeType:@"image/jpeg"];
      }
-                                             success:^(AFHTTPRequestOperation *operation, id responseObject)
+                                    success:^(NSURLSessionDataTask *task, id responseObject)
      {
+         [[GRVImageEncoder sharedEncoder] discardJPEGDataForImage:self.previewImage];
+         
          // Sync new video
          [GRVVideo videoWithVideoInfo:responseObject
                inManagedObjectContext:[GRVModelManager sharedManager].managedObjectContext];
@@ -102,19 +105,51 @@ static NSString *const kUnwindSegueIdentifier = @"createdVideo";
          // stop spinner as we unwind VC
          [self performSegueWithIdentifier:kUnwindSegueIdentifier sender:self];
      }
-                                             failure:^(AFHTTPRequestOperation *operation, NSError *error)
+                                    failure:^(NSURLSessionDataTask *task, NSError *error, id responseObject)
      {
-         [GRVHTTPManager alertWithFailedResponse:nil
-                              withAlternateTitle:@"Can't create video."
-                                      andMessage:@"Something went wrong. Please try again."];
-         
-         // refresh create button
-         [self selectedContactsChanged];
-         
-         // inform user server activity is done
-         [self stopSpinner];
-     }
-                                 operationDependency:nil];
+         [self videoUploadFailed];
+     }];
+}
+
+
+#pragma mark - Target/Action Methods
+- (IBAction)createVideo:(UIBarButtonItem *)sender
+{
+    // Create the video users JSON object
+    NSMutableArray *videoUsersJSON = [NSMutableArray array];
+    for (GRVUser *selectedUser in self.selectedContacts) {
+        NSDictionary *phoneNumberJSON = @{kGRVRESTUserPhoneNumberKey : selectedUser.phoneNumber};
+        [videoUsersJSON addObject:phoneNumberJSON];
+    }
+    
+    // Key for the duration object in the lead clip
+    NSString *durationKey = [NSString stringWithFormat:@"%@.%@", kGRVRESTVideoLeadClipKey, kGRVRESTClipDurationKey];
+    // Parameters required for video upload
+    
+    NSMutableDictionary *parameters = [@{durationKey: @(self.duration),
+                                         kGRVRESTVideoUsersKey: videoUsersJSON} mutableCopy];
+    if ([self.videoTitle length]) {
+        parameters[kGRVRESTVideoTitleKey] = self.videoTitle;
+    }
+    
+    // temporarily disable create button
+    self.createButton.enabled = NO;
+    
+    // Hide keyboard if showing
+    [self.view endEditing:YES];
+    
+    // inform user of server activity.
+    [self startSpinner];
+    
+    // Upload video to the server once the preview image's JPEG bytes are
+    // ready. These are encoded in the background so are typically already
+    // done by now.
+    [[GRVImageEncoder sharedEncoder] JPEGDataForImage:self.previewImage
+                                          maximumSize:CGSizeMake(kGRVVideoSizeWidth, kGRVVideoSizeHeight)
+                                   compressionQuality:kGRVVideoPhotoCompressionQuality
+                                           completion:^(NSData *jpegData) {
+                                               [self uploadVideoWithParameters:[parameters copy] photoData:jpegData];
+                                           }];
 }
 
 @end
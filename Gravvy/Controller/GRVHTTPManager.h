@@ -7,16 +7,23 @@
 //
 
 #import <Foundation/Foundation.h>
+#import <CoreData/CoreData.h>
 #import "AFURLRequestSerialization.h"
 #import "GRVConstants.h"
 
 @class AFHTTPSessionManager;
-@class AFHTTPRequestOperation;
+@class GRVJSONListReader;
+@class GRVHTTPRequestClassStatistics;
 
 /**
  * A singleton class that manages all HTTP interactions (including user authentication)
  * Having just one instance of this class throughout the application ensures all
  *   data stays synced.
+ *
+ * All requests, including image and video downloads, go through one
+ * NSURLSession so they share its connections. Each request has a
+ * GRVHTTPRequestClass which sets its priority and how many requests of its
+ * kind can run at once.
  */
 @interface GRVHTTPManager : NSObject
 
@@ -91,6 +98,9 @@
  data task, the error describing the network or parsing error that occurred, and
  the response object created by the client response serializer.
  
+ The request is a GRVHTTPRequestClassMetadata request, and the success and
+ failure blocks are executed on the main queue.
+ 
  @see -dataTaskWithRequest:completionHandler:
  */
 - (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
@@ -99,6 +109,74 @@
                           success:(void (^)(NSURLSessionDataTask *task, id responseObject))success
                           failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure;
 
+/**
+ * Same as request:forURL:parameters:success:failure: but for a given request
+ * class, such as GRVHTTPRequestClassAnalytics for requests that can wait.
+ */
+- (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
+                           forURL:(NSString *)URLString
+                       parameters:(id)parameters
+                     requestClass:(GRVHTTPRequestClass)requestClass
+                          success:(void (^)(NSURLSessionDataTask *task, id responseObject))success
+                          failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure;
+
+/**
+ * Creates and runs an `NSURLSessionDataTask` with a <HTTP Method> request
+ * whose response is to be imported into Core Data.
+ *
+ * Unlike request:forURL:parameters:success:failure: nothing happens on the
+ * main thread: the response data is handed straight to the context's queue,
+ * where it's parsed and the success or failure block is executed.
+ *
+ * @param httpMethod, URLString, parameters
+ *      Same as in request:forURL:parameters:success:failure:
+ * @param context
+ *      Private queue context (typically a GRVModelManager worker context) on
+ *      whose queue the response is parsed and the callbacks are executed.
+ * @param success
+ *      A block object to be executed on the context's queue when the task
+ *      finishes successfully. This block has no return value and takes two
+ *      arguments: the data task, and the parsed JSON response object.
+ * @param failure
+ *      A block object to be executed on the context's queue when the task
+ *      finishes unsuccessfully, or its response isn't valid JSON. This block
+ *      has no return value and takes three arguments: the data task, the error
+ *      describing the network or parsing error that occurred, and the parsed
+ *      JSON response object, if any.
+ */
+- (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
+                           forURL:(NSString *)URLString
+                       parameters:(id)parameters
+           inManagedObjectContext:(NSManagedObjectContext *)context
+                          success:(void (^)(NSURLSessionDataTask *task, id responseObject))success
+                          failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure;
+
+/**
+ * Creates and runs an `NSURLSessionDataTask` with a <HTTP Method> request for
+ * a JSON list whose records are to be imported into Core Data.
+ *
+ * The response is read on the context's queue with a GRVJSONListReader, which
+ * parses records one at a time as they're enumerated, so the whole list is
+ * never built. Pass the reader to
+ * +[GRVCoreDataImport importObjectsFromEnumerator:inBatchesOfSize:inManagedObjectContext:usingImportBatch:]
+ *
+ * @param httpMethod, URLString, parameters, context, failure
+ *      Same as in request:forURL:parameters:inManagedObjectContext:success:failure:
+ * @param listKey
+ *      Key of the list in the JSON response object, such as
+ *      kGRVRESTListResultsKey, or nil if the response is the list.
+ * @param success
+ *      A block object to be executed on the context's queue when the task
+ *      finishes successfully. This block has no return value and takes two
+ *      arguments: the data task, and a reader of the list's records.
+ */
+- (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
+                           forURL:(NSString *)URLString
+                       parameters:(id)parameters
+           inManagedObjectContext:(NSManagedObjectContext *)context
+                          listKey:(NSString *)listKey
+                          success:(void (^)(NSURLSessionDataTask *task, GRVJSONListReader *reader))success
+                          failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure;
 
 
 /**
@@ -129,11 +207,10 @@
  *
  * @see -dataTaskWithRequest:completionHandler:
  *
- * @warning you probably want to use the `AFHTTPRequestOperation` counterpart.
- *      This has been modified to work around the issues as documented here:
- *      https://github.com/AFNetworking/AFNetworking/issues/1398
- *      I'm not a fan of having to create a temporary file as is done in this
- *      implementation...
+ * @note This is a GRVHTTPRequestClassUpload request, so uploads run one at a
+ *      time in the order they're made. Running them concurrently causes errors.
+ *      The body is written to a temporary file before it's uploaded, as
+ *      documented here: https://github.com/AFNetworking/AFNetworking/issues/1398
  */
 - (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
                            forURL:(NSString *)URLString
@@ -143,53 +220,14 @@
                           failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure;
 
 
-/**
- * Creates and runs an `AFHTTPRequestOperation` with a multipart `POST`/`PUT`/`PATCH`
- * request.
- *
- * This is just a wrapper to AFHTTPRequestOperationManager's HTTP Method requests.
- * The value-add here is setting the request headers appropriately on each call
- *   and this is more efficient than the HTTPSessionManager equivalent in that
- *   it doesn't create a temporary file.
- *
- * @param httpMethod
- *      HTTP request method (POST, PUT, PATCH)
- * @param URLString
- *      The URL string used to create the request URL.
- * @param parameters
- *      The parameters to be encoded according to the client request serializer.
- * @param block
- *      A block that takes a single argument and appends data to the HTTP body.
- *      The block argument is an object adopting the `AFMultipartFormData` protocol.
- * @param success
- *      A block object to be executed when the request operation finishes successfully.
- *      This block has no return value and takes two arguments: the request
- *      operation, and the response object created by the client response serializer.
- * @param failure
- *      A block object to be executed when the request operation finishes
- *      unsuccessfully, or that finishes successfully, but encountered an error
- *      while parsing the response data. This block has no return value and takes
- *      two arguments: the request operation and the error describing the network
- *      or parsing error that occurred.
- * @param dependency
- *      Another Request operation that must complete before this request can
- *      start This is tremendously useful when uploding multiple images.
- *      Uploading them all concurrently will cause errors and crash the app.
- *
- * @see -HTTPRequestOperationWithRequest:success:failure:
- */
-- (AFHTTPRequestOperation *)operationRequest:(GRVHTTPMethod)httpMethod
-                                      forURL:(NSString *)URLString
-                                  parameters:(id)parameters
-                   constructingBodyWithBlock:(void (^)(id <AFMultipartFormData> formData))block
-                                     success:(void (^)(AFHTTPRequestOperation *operation, id responseObject))success
-                                     failure:(void (^)(AFHTTPRequestOperation *operation, NSError *error))failure
-                         operationDependency:(AFHTTPRequestOperation *)dependency;
-
-
 /**
  * Asynchronously downloads an image from the specified URL request.
- * This does have caching.
+ * This does have caching: images are kept in an SDWebImage image cache on
+ * disk only, so callers are expected to hold on to the images they display.
+ * This is a GRVHTTPRequestClassThumbnail request. Downloaded images are
+ * decoded in the background, and requests for an image that is already being
+ * downloaded wait for that download instead of starting another one.
+ * The callbacks are executed on the main thread.
  *
  * @param URLString
  *      The absolute URL location of the image.
@@ -208,7 +246,8 @@
 
 /**
  * Asynchronously downloads a video from the specified URL.
- * This does have caching.
+ * This does have caching, via the shared NSURLCache.
+ * This is a GRVHTTPRequestClassVideoBytes request.
  *
  * @param URLString
  *      The absolute URL location of the video.
@@ -218,21 +257,55 @@
  *      takes five arguments: the number of bytes read since the last time the
  *      download progress block was called, the total bytes read, the total 
  *      bytes expected to be read during the request, as initially determined by
- *      the expected content size of the `NSHTTPURLResponse` object, the request
- *      operation and the video data downloaded thus far. This block may be 
- *      called multiple times, and will execute on the main thread.
+ *      the expected content size of the `NSHTTPURLResponse` object, the data
+ *      task and the video data downloaded thus far. This block may be
+ *      called multiple times, and will execute on the main thread. The video
+ *      data is appended to after the block returns so copy it to keep it.
  * @param success
- *      A block object to be executed when the task finishes successfully. This
- *      block has no return value and takes one argument: the request
- *      operation and the downloaded mp4
+ *      A block object to be executed on the main thread when the task finishes
+ *      successfully. This block has no return value and takes two arguments:
+ *      the data task and the downloaded mp4
  * @param failure
  *      A block object to be executed when the task finishes unsuccessfull.
  *      This block has no return value and takes one argument: the error
  *      describing the network or parsing error that occured.
+ *
+ * @return the download task. Cancel it when the video is no longer needed so
+ *      it gives up its GRVHTTPRequestClassVideoBytes slot.
  */
-- (void)videoFromURL:(NSString *)URLString
-            progress:(void (^)(NSUInteger bytesRead, long long totalBytesRead, long long totalBytesExpectedToRead, AFHTTPRequestOperation *operation, NSData* video))progress
-             success:(void (^)(AFHTTPRequestOperation *operation, id video))success
-             failure:(void (^)(NSError *error))failure;
+- (NSURLSessionDataTask *)videoFromURL:(NSString *)URLString
+                              progress:(void (^)(NSUInteger bytesRead, long long totalBytesRead, long long totalBytesExpectedToRead, NSURLSessionDataTask *task, NSData* video))progress
+                               success:(void (^)(NSURLSessionDataTask *task, NSData *video))success
+                               failure:(void (^)(NSError *error))failure;
+
+
+#pragma mark Measurements
+/**
+ * Snapshot of the queue measurements of a request class.
+ */
+- (GRVHTTPRequestClassStatistics *)statisticsForRequestClass:(GRVHTTPRequestClass)requestClass;
+
+/**
+ * Reset the request class measurements and request metrics.
+ */
+- (void)resetMeasurements;
+
+/**
+ * Summary of the request class measurements, for logging.
+ */
+- (NSString *)measurementsDescription;
+
+/**
+ * Export the timing metrics of the most recent requests, and their p50/p95
+ * latency per endpoint, as JSON.
+ *
+ * @param error     If an error occurs, upon return contains an NSError object
+ *      that describes the problem.
+ *
+ * @return UTF-8 encoded JSON data, or nil on error.
+ *
+ * @see GRVHTTPMetricsBuffer
+ */
+- (NSData *)requestMetricsJSONDataWithError:(NSError **)error;
 
 @end
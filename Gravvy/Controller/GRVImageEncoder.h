@@ -0,0 +1,71 @@
+//
+//  GRVImageEncoder.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/14/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+
+/**
+ * GRVImageEncoder is a shared service for turning images into the JPEG bytes
+ * uploaded to the server.
+ *
+ * @discussion Images are downsampled to the server's thumbnail dimensions and
+ *      JPEG-encoded on a serial background queue. The encoded bytes are cached
+ *      against the source image so encoding can be kicked off as soon as an
+ *      image is captured and the upload request later built with no CPU work
+ *      on the main thread.
+ */
+@interface GRVImageEncoder : NSObject
+
+#pragma mark - Class Methods
+/**
+ * Single instance.
+ * It creates the instance if this hasn't been done or simply returns it.
+ *
+ * @return An initialized GRVImageEncoder object.
+ */
++ (instancetype)sharedEncoder;
+
+#pragma mark - Instance Methods
+/**
+ * Start downsampling and encoding an image in the background so its JPEG
+ * bytes are ready by the time they're needed. Calling this more than once for
+ * the same image and encoding parameters does no extra work.
+ *
+ * @param image                 Image to encode
+ * @param maximumSize           Maximum pixel dimensions of the encoded image.
+ *      Images smaller than this are not upscaled.
+ * @param compressionQuality    JPEG compression quality in the range [0.0, 1.0]
+ */
+- (void)prepareJPEGDataForImage:(UIImage *)image
+                    maximumSize:(CGSize)maximumSize
+             compressionQuality:(CGFloat)compressionQuality;
+
+/**
+ * Get the JPEG bytes of an image. If encoding was started with
+ * prepareJPEGDataForImage:maximumSize:compressionQuality: then this waits on
+ * that, otherwise the image is encoded in the background now.
+ *
+ * @param image                 Image to encode
+ * @param maximumSize           Maximum pixel dimensions of the encoded image.
+ * @param compressionQuality    JPEG compression quality in the range [0.0, 1.0]
+ * @param completion            block to be called on the main queue with the
+ *      encoded bytes, which will be nil if the image could not be encoded.
+ */
+- (void)JPEGDataForImage:(UIImage *)image
+             maximumSize:(CGSize)maximumSize
+      compressionQuality:(CGFloat)compressionQuality
+              completion:(void (^)(NSData *jpegData))completion;
+
+/**
+ * Drop all cached JPEG bytes of an image. Call this once the bytes have been
+ * uploaded.
+ *
+ * @param image     Image whose encoded bytes are no longer needed
+ */
+- (void)discardJPEGDataForImage:(UIImage *)image;
+
+@end
@@ -0,0 +1,210 @@
+//
+//  GRVImageEncoder.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/14/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVImageEncoder.h"
+
+@interface GRVImageEncoder ()
+
+#pragma mark - Properties
+/**
+ * Serial queue on which all encoding is done and the cache is accessed.
+ * Because it is serial a request for bytes queued behind a pending encode
+ * simply waits on it.
+ */
+@property (strong, nonatomic) dispatch_queue_t encodingQueue;
+
+/**
+ * Encoded JPEG bytes keyed by source image. Each value is a dictionary of
+ * NSData keyed by encoding parameters. The source images are weakly held so
+ * an entry does not outlive the image it came from.
+ */
+@property (strong, nonatomic) NSMapTable *encodedImages;
+
+@end
+
+@implementation GRVImageEncoder
+
+#pragma mark - Class Methods
++ (instancetype)sharedEncoder
+{
+    static GRVImageEncoder *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[self alloc] initPrivate];
+    });
+    return sharedInstance;
+}
+
+#pragma mark - Initializers
+/*
+ * ideally we would make the designated initializer of the superclass call
+ *   the new designated initializer, but that doesn't make sense in this case.
+ * if a programmer calls [GRVImageEncoder alloc] init], let him know the error
+ *   of his ways.
+ */
+- (instancetype)init
+{
+    @throw [NSException exceptionWithName:@"Singleton"
+                                   reason:@"Use +[GRVImageEncoder sharedEncoder]"
+                                 userInfo:nil];
+    return nil;
+}
+
+// here is the real (secret) initializer
+// this is the official designated initializer so call the designated
+// initializer of the superclass
+- (instancetype)initPrivate
+{
+    self = [super init];
+    if (self) {
+        _encodingQueue = dispatch_queue_create("com.nceruchalu.gravvy.imageencoder", DISPATCH_QUEUE_SERIAL);
+        dispatch_set_target_queue(_encodingQueue, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0));
+        _encodedImages = [NSMapTable weakToStrongObjectsMapTable];
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(didReceiveMemoryWarning)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+
+#pragma mark - Instance Methods
+#pragma mark Private
+/**
+ * Key identifying a set of encoding parameters in the cache.
+ */
++ (NSString *)keyForMaximumSize:(CGSize)maximumSize compressionQuality:(CGFloat)compressionQuality
+{
+    return [NSString stringWithFormat:@"%.0fx%.0f@%.2f", maximumSize.width, maximumSize.height, compressionQuality];
+}
+
+/**
+ * Scale an image down to fit within given pixel dimensions, preserving its
+ * aspect ratio. Images that already fit are returned as is.
+ *
+ * @warning This does the actual drawing so should not be called on the main
+ *      thread.
+ *
+ * @param image         Image to downsample
+ * @param maximumSize   Maximum pixel dimensions of the returned image
+ *
+ * @return Downsampled image with a scale of 1.0
+ */
++ (UIImage *)downsampleImage:(UIImage *)image toMaximumSize:(CGSize)maximumSize
+{
+    CGSize pixelSize = CGSizeMake(image.size.width * image.scale,
+                                  image.size.height * image.scale);
+    if ((pixelSize.width <= 0.0) || (pixelSize.height <= 0.0) ||
+        ((pixelSize.width <= maximumSize.width) && (pixelSize.height <= maximumSize.height))) {
+        return image;
+    }
+
+    CGFloat ratio = MIN(maximumSize.width/pixelSize.width, maximumSize.height/pixelSize.height);
+    CGSize targetSize = CGSizeMake(floor(pixelSize.width * ratio), floor(pixelSize.height * ratio));
+
+    // JPEGs have no alpha channel so draw into an opaque context.
+    UIGraphicsBeginImageContextWithOptions(targetSize, YES, 1.0);
+    [image drawInRect:CGRectMake(0.0, 0.0, targetSize.width, targetSize.height)];
+    UIImage *downsampledImage = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+
+    return downsampledImage;
+}
+
+/**
+ * Get the cached JPEG bytes of an image, encoding them first if necessary.
+ *
+ * @warning This must be called on the encodingQueue.
+ */
+- (NSData *)encodedDataForImage:(UIImage *)image
+                    maximumSize:(CGSize)maximumSize
+             compressionQuality:(CGFloat)compressionQuality
+{
+    NSString *key = [GRVImageEncoder keyForMaximumSize:maximumSize compressionQuality:compressionQuality];
+    NSMutableDictionary *encodings = [self.encodedImages objectForKey:image];
+    NSData *jpegData = encodings[key];
+
+    if (!jpegData) {
+        @autoreleasepool {
+            UIImage *downsampledImage = [GRVImageEncoder downsampleImage:image toMaximumSize:maximumSize];
+            jpegData = UIImageJPEGRepresentation(downsampledImage, compressionQuality);
+        }
+
+        if (jpegData) {
+            if (!encodings) {
+                encodings = [NSMutableDictionary dictionary];
+                [self.encodedImages setObject:encodings forKey:image];
+            }
+            encodings[key] = jpegData;
+        }
+    }
+
+    return jpegData;
+}
+
+#pragma mark Public
+- (void)prepareJPEGDataForImage:(UIImage *)image
+                    maximumSize:(CGSize)maximumSize
+             compressionQuality:(CGFloat)compressionQuality
+{
+    if (!image) return;
+
+    dispatch_async(self.encodingQueue, ^{
+        [self encodedDataForImage:image maximumSize:maximumSize compressionQuality:compressionQuality];
+    });
+}
+
+- (void)JPEGDataForImage:(UIImage *)image
+             maximumSize:(CGSize)maximumSize
+      compressionQuality:(CGFloat)compressionQuality
+              completion:(void (^)(NSData *jpegData))completion
+{
+    if (!image) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (completion) completion(nil);
+        });
+        return;
+    }
+
+    dispatch_async(self.encodingQueue, ^{
+        NSData *jpegData = [self encodedDataForImage:image
+                                         maximumSize:maximumSize
+                                  compressionQuality:compressionQuality];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (completion) completion(jpegData);
+        });
+    });
+}
+
+- (void)discardJPEGDataForImage:(UIImage *)image
+{
+    if (!image) return;
+
+    dispatch_async(self.encodingQueue, ^{
+        [self.encodedImages removeObjectForKey:image];
+    });
+}
+
+
+#pragma mark - Notification Observer Methods
+- (void)didReceiveMemoryWarning
+{
+    // Encoded bytes can always be regenerated so let them go.
+    dispatch_async(self.encodingQueue, ^{
+        [self.encodedImages removeAllObjects];
+    });
+}
+
+@end
@@ -496,7 +496,7 @@ static CGFloat const scrollingNavBarDelay = 480.0f;
         
         // fetch all new videos or videos with unseen notifications that actually
         // have clips
-        request.predicate = [NSPredicate predicateWithFormat:@"((unseenClipsCount > 0) OR (unseenLikesCount > 0) OR (membership <= %d) OR (order <= %d)) AND (clips.@count > 0)", GRVVideoMembershipInvited, kGRVVideoOrderNew];
+        request.predicate = [NSPredicate predicateWithFormat:@"((unseenClipsCount > 0) OR (unseenLikesCount > 0) OR (membership <= %d) OR (order <= %d)) AND (clipsCount > 0)", GRVVideoMembershipInvited, kGRVVideoOrderNew];
         
         // Sort videos because an instance of NSFetchedResultsController requires
         // a fetch request with sort descriptors
@@ -102,8 +102,7 @@ static NSString *const kMemberDisplayNameMe = @"You";
 {
     // Avatar first
     GRVUserAvatarView *avatarView = [GRVUserViewHelper userAvatarView:user];
-    cell.avatarView.thumbnail = avatarView.thumbnail;
-    cell.avatarView.userInitials = avatarView.userInitials;
+    [cell.avatarView setAvatarFromAvatarView:avatarView];
     
     // Display name
     BOOL memberIsMe = [user.phoneNumber isEqualToString:[GRVAccountManager sharedManager].phoneNumber];
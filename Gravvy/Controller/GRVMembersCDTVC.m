@@ -203,8 +203,7 @@ static const NSInteger kMemberButtonIndexMessage = 0; // SMS user
 {
     // Avatar first
     GRVUserAvatarView *avatarView = [GRVUserViewHelper userAvatarView:member.user];
-    cell.avatarView.thumbnail = avatarView.thumbnail;
-    cell.avatarView.userInitials = avatarView.userInitials;
+    [cell.avatarView setAvatarFromAvatarView:avatarView];
     
     // Display name
     BOOL memberIsMe = [member.user.phoneNumber isEqualToString:[GRVAccountManager sharedManager].phoneNumber];
@@ -0,0 +1,97 @@
+//
+//  GRVPreviewImageLoader.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/15/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+
+/**
+ * GRVPreviewImageLoader loads video preview images for display in the feed.
+ *
+ * @discussion Downloaded images are decoded and downsampled to the pixel size
+ *      they'll be displayed at on a background queue, so the main thread only
+ *      ever hands a ready bitmap to an image view. Decoded bitmaps are kept in
+ *      a cache whose limit is in bytes (kGRVPreviewImageCacheMemoryCapacity)
+ *      rather than entries, as preview images vary a lot in size.
+ *
+ *      The loader also keeps measurements of its work: main thread time spent
+ *      getting images on screen and peak resident memory seen while loading.
+ */
+@interface GRVPreviewImageLoader : NSObject
+
+#pragma mark - Properties
+#pragma mark Measurements
+/**
+ * Total time, in seconds, the main thread spent in this loader: cache lookups
+ * and handing decoded images back to the caller.
+ */
+@property (nonatomic, readonly) NSTimeInterval mainThreadTime;
+
+/**
+ * Total time, in seconds, spent decoding and downsampling in the background.
+ */
+@property (nonatomic, readonly) NSTimeInterval decodeTime;
+
+/**
+ * Number of images decoded and number of requests served from the cache.
+ */
+@property (nonatomic, readonly) NSUInteger decodedImagesCount;
+@property (nonatomic, readonly) NSUInteger cacheHitsCount;
+
+/**
+ * Highest resident memory size, in bytes, of the app observed after a decode.
+ */
+@property (nonatomic, readonly) NSUInteger peakResidentMemory;
+
+#pragma mark - Class Methods
+/**
+ * Single instance.
+ * It creates the instance if this hasn't been done or simply returns it.
+ *
+ * @return An initialized GRVPreviewImageLoader object.
+ */
++ (instancetype)sharedLoader;
+
+#pragma mark - Instance Methods
+/**
+ * Get an already decoded preview image.
+ *
+ * @param URLString     The absolute URL location of the image.
+ * @param pixelSize     Pixel size the image will be displayed at.
+ *
+ * @return decoded image or nil if it isn't in the cache.
+ */
+- (UIImage *)cachedImageFromURL:(NSString *)URLString pixelSize:(CGSize)pixelSize;
+
+/**
+ * Asynchronously download, decode and downsample a preview image.
+ *
+ * @param URLString     The absolute URL location of the image.
+ * @param pixelSize     Pixel size the image will be displayed at. Images are
+ *      scaled to fill this size but never upscaled.
+ * @param completion    block to be called on the main queue with the decoded
+ *      image, or nil on failure, and the URL it was requested with.
+ */
+- (void)imageFromURL:(NSString *)URLString
+           pixelSize:(CGSize)pixelSize
+          completion:(void (^)(UIImage *image, NSString *URLString))completion;
+
+/**
+ * Evict all decoded images.
+ */
+- (void)removeAllImages;
+
+/**
+ * Reset all measurements to zero.
+ */
+- (void)resetMeasurements;
+
+/**
+ * Summary of measurements suitable for logging.
+ */
+- (NSString *)measurementsDescription;
+
+@end
@@ -0,0 +1,223 @@
+//
+//  GRVPreviewImageLoader.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/15/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVPreviewImageLoader.h"
+#import "GRVHTTPManager.h"
+#import "GRVConstants.h"
+#import "GRVMemoryUtils.h"
+
+@interface GRVPreviewImageLoader ()
+
+#pragma mark - Properties
+/**
+ * Decoded bitmaps keyed by URL and pixel size, with a cost of bitmap bytes.
+ */
+@property (strong, nonatomic) NSCache *decodedImages;
+
+/**
+ * Queue on which downloaded images are decoded and downsampled.
+ */
+@property (strong, nonatomic) dispatch_queue_t decodeQueue;
+
+// redefine measurements as readwrite
+@property (nonatomic, readwrite) NSTimeInterval mainThreadTime;
+@property (nonatomic, readwrite) NSTimeInterval decodeTime;
+@property (nonatomic, readwrite) NSUInteger decodedImagesCount;
+@property (nonatomic, readwrite) NSUInteger cacheHitsCount;
+@property (nonatomic, readwrite) NSUInteger peakResidentMemory;
+
+@end
+
+@implementation GRVPreviewImageLoader
+
+#pragma mark - Class Methods
++ (instancetype)sharedLoader
+{
+    static GRVPreviewImageLoader *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[self alloc] initPrivate];
+    });
+    return sharedInstance;
+}
+
+#pragma mark - Initializers
+/*
+ * ideally we would make the designated initializer of the superclass call
+ *   the new designated initializer, but that doesn't make sense in this case.
+ * if a programmer calls [GRVPreviewImageLoader alloc] init], let him know the
+ *   error of his ways.
+ */
+- (instancetype)init
+{
+    @throw [NSException exceptionWithName:@"Singleton"
+                                   reason:@"Use +[GRVPreviewImageLoader sharedLoader]"
+                                 userInfo:nil];
+    return nil;
+}
+
+// here is the real (secret) initializer
+// this is the official designated initializer so call the designated
+// initializer of the superclass
+- (instancetype)initPrivate
+{
+    self = [super init];
+    if (self) {
+        _decodedImages = [[NSCache alloc] init];
+        _decodedImages.totalCostLimit = kGRVPreviewImageCacheMemoryCapacity;
+        _decodeQueue = dispatch_queue_create("com.nceruchalu.gravvy.previewimagedecode", DISPATCH_QUEUE_SERIAL);
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(removeAllImages)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+
+#pragma mark - Instance Methods
+#pragma mark Private
+/**
+ * Key of a decoded image in the cache.
+ */
++ (NSString *)cacheKeyForURL:(NSString *)URLString pixelSize:(CGSize)pixelSize
+{
+    return [NSString stringWithFormat:@"%@|%.0fx%.0f", URLString, pixelSize.width, pixelSize.height];
+}
+
+/**
+ * Decode an image into a bitmap scaled to fill the given pixel size. Images
+ * smaller than the pixel size are decoded at their own size.
+ *
+ * @warning This does the actual decoding so should not be called on the main
+ *      thread.
+ *
+ * @param image         Downloaded image
+ * @param pixelSize     Pixel size the image will be displayed at
+ *
+ * @return decoded image with a scale of 1.0
+ */
++ (UIImage *)decodedImage:(UIImage *)image fillingPixelSize:(CGSize)pixelSize
+{
+    CGImageRef imageRef = image.CGImage;
+    if (!imageRef) return image;
+
+    CGSize sourceSize = CGSizeMake(CGImageGetWidth(imageRef), CGImageGetHeight(imageRef));
+    CGFloat ratio = 1.0;
+    if ((pixelSize.width > 0) && (pixelSize.height > 0)) {
+        ratio = MIN(1.0, MAX(pixelSize.width/sourceSize.width, pixelSize.height/sourceSize.height));
+    }
+    size_t width = (size_t)ceil(sourceSize.width * ratio);
+    size_t height = (size_t)ceil(sourceSize.height * ratio);
+
+    // Preview images are JPEGs so draw into an opaque context
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef context = CGBitmapContextCreate(NULL, width, height, 8, 0, colorSpace,
+                                                 kCGBitmapByteOrder32Host | kCGImageAlphaNoneSkipFirst);
+    CGColorSpaceRelease(colorSpace);
+    if (!context) return image;
+
+    CGContextSetInterpolationQuality(context, kCGInterpolationHigh);
+    CGContextDrawImage(context, CGRectMake(0, 0, width, height), imageRef);
+    CGImageRef decodedImageRef = CGBitmapContextCreateImage(context);
+    CGContextRelease(context);
+
+    UIImage *decodedImage = [UIImage imageWithCGImage:decodedImageRef
+                                                scale:1.0
+                                          orientation:image.imageOrientation];
+    CGImageRelease(decodedImageRef);
+    return decodedImage;
+}
+
+#pragma mark Public
+- (UIImage *)cachedImageFromURL:(NSString *)URLString pixelSize:(CGSize)pixelSize
+{
+    if (![URLString length]) return nil;
+
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    UIImage *image = [self.decodedImages objectForKey:[GRVPreviewImageLoader cacheKeyForURL:URLString pixelSize:pixelSize]];
+    if (image) self.cacheHitsCount++;
+    self.mainThreadTime += CFAbsoluteTimeGetCurrent() - startTime;
+
+    return image;
+}
+
+- (void)imageFromURL:(NSString *)URLString
+           pixelSize:(CGSize)pixelSize
+          completion:(void (^)(UIImage *image, NSString *URLString))completion
+{
+    UIImage *cachedImage = [self cachedImageFromURL:URLString pixelSize:pixelSize];
+    if (cachedImage || ![URLString length]) {
+        if (completion) completion(cachedImage, URLString);
+        return;
+    }
+
+    NSString *cacheKey = [GRVPreviewImageLoader cacheKeyForURL:URLString pixelSize:pixelSize];
+
+    [[GRVHTTPManager sharedManager] imageFromURL:URLString success:^(UIImage *image) {
+        dispatch_async(self.decodeQueue, ^{
+            CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+
+            UIImage *decodedImage = nil;
+            @autoreleasepool {
+                decodedImage = [GRVPreviewImageLoader decodedImage:image fillingPixelSize:pixelSize];
+            }
+            if (decodedImage) {
+                CGImageRef decodedImageRef = decodedImage.CGImage;
+                NSUInteger cost = CGImageGetBytesPerRow(decodedImageRef) * CGImageGetHeight(decodedImageRef);
+                [self.decodedImages setObject:decodedImage forKey:cacheKey cost:cost];
+            }
+
+            NSTimeInterval elapsedTime = CFAbsoluteTimeGetCurrent() - startTime;
+            NSUInteger residentMemory = [GRVMemoryUtils residentMemory];
+
+            dispatch_async(dispatch_get_main_queue(), ^{
+                self.decodeTime += elapsedTime;
+                self.decodedImagesCount++;
+                self.peakResidentMemory = MAX(self.peakResidentMemory, residentMemory);
+
+                CFAbsoluteTime displayStartTime = CFAbsoluteTimeGetCurrent();
+                if (completion) completion(decodedImage, URLString);
+                self.mainThreadTime += CFAbsoluteTimeGetCurrent() - displayStartTime;
+            });
+        });
+
+    } failure:^(NSError *error) {
+        if (completion) completion(nil, URLString);
+    }];
+}
+
+- (void)removeAllImages
+{
+    [self.decodedImages removeAllObjects];
+}
+
+- (void)resetMeasurements
+{
+    self.mainThreadTime = 0.0;
+    self.decodeTime = 0.0;
+    self.decodedImagesCount = 0;
+    self.cacheHitsCount = 0;
+    self.peakResidentMemory = 0;
+}
+
+- (NSString *)measurementsDescription
+{
+    return [NSString stringWithFormat:@"preview images: %lu decoded (%.1fms), %lu cache hits, main thread %.1fms, peak memory %.1fmb",
+            (unsigned long)self.decodedImagesCount, self.decodeTime * 1000.0,
+            (unsigned long)self.cacheHitsCount, self.mainThreadTime * 1000.0,
+            self.peakResidentMemory / (1024.0 * 1024.0)];
+}
+
+@end
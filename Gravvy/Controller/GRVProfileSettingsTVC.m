@@ -13,6 +13,7 @@
 #import "GRVConstants.h"
 #import "GRVUser+HTTP.h"
 #import "GRVModelManager.h"
+#import "GRVImageEncoder.h"
 
 #pragma mark - Constants
 /**
@@ -239,29 +240,42 @@ static const NSInteger kAddPhotoChooseButtonIndex   = 1; // Choose Existing
 - (void)uploadUserAvatar:(UIImage *)image
 {
     if (image) {
-        // there's an image to upload
+        // there's an image to upload but first get it downsampled and encoded
+        // off the main thread.
         [self.spinner startAnimating];
-        [[GRVHTTPManager sharedManager] operationRequest:GRVHTTPMethodPATCH
-                                                  forURL:kGRVRESTUser
-                                              parameters:nil
-                               constructingBodyWithBlock:^(id<AFMultipartFormData> formData) {
-                                   
-                                   // Come up with a random file name. Doesn't have to be
-                                   // unique as the server will handle that
-                                   NSString *fileName = @"avatar.jpg";
-                                   [formData appendPartWithFileData:UIImageJPEGRepresentation(image, 0.4f)
-                                                               name:kGRVRESTUserAvatarKey
-                                                           fileName:fileName
-                                                           mimeType:@"image/jpeg"];
-                               }
-                                                 success:^(AFHTTPRequestOperation *operation, id responseObject) {
-                                                     [self.spinner stopAnimating];
-                                                     [self refreshWithUserDictionary:responseObject];
-                                                 }
-                                                 failure:^(AFHTTPRequestOperation *operation, NSError *error) {
-                                                     [self.spinner stopAnimating];
-                                                 }
-                                     operationDependency:nil];
+        GRVImageEncoder *imageEncoder = [GRVImageEncoder sharedEncoder];
+        [imageEncoder JPEGDataForImage:image
+                           maximumSize:CGSizeMake(kGRVUserAvatarSizeWidth, kGRVUserAvatarSizeHeight)
+                    compressionQuality:kGRVUserAvatarCompressionQuality
+                            completion:^(NSData *jpegData) {
+            // Avatar is uploaded right away so its bytes won't be needed again
+            [imageEncoder discardJPEGDataForImage:image];
+            if (!jpegData) {
+                [self.spinner stopAnimating];
+                return;
+            }
+            
+            [[GRVHTTPManager sharedManager] request:GRVHTTPMethodPATCH
+                                             forURL:kGRVRESTUser
+                                         parameters:nil
+                          constructingBodyWithBlock:^(id<AFMultipartFormData> formData) {
+                              
+                              // Come up with a random file name. Doesn't have to be
+                              // unique as the server will handle that
+                              NSString *fileName = @"avatar.jpg";
+                              [formData appendPartWithFileData:jpegData
+                                                          name:kGRVRESTUserAvatarKey
+                                                      fileName:fileName
+                                                      mimeType:@"image/jpeg"];
+                          }
+                                            success:^(NSURLSessionDataTask *task, id responseObject) {
+                                                [self.spinner stopAnimating];
+                                                [self refreshWithUserDictionary:responseObject];
+                                            }
+                                            failure:^(NSURLSessionDataTask *task, NSError *error, id responseObject) {
+                                                [self.spinner stopAnimating];
+                                            }];
+        }];
         
     } else {
         // delete image on server
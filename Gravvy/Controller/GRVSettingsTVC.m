@@ -9,6 +9,8 @@
 #import "GRVSettingsTVC.h"
 #import <MessageUI/MessageUI.h>
 #import "GRVModelManager.h"
+#import "GRVHTTPManager.h"
+#import "GRVRefreshTrace.h"
 
 #pragma mark - Constants
 
@@ -100,6 +102,28 @@ static NSString *const kTellAFriendActionSheetTitle = @"Tell a friend about Grav
     
     // Save a reference to the cancel button
     self.cancelButton = self.navigationItem.leftBarButtonItem;
+    
+#if DEBUG
+    // Debug builds can export network metrics and show refresh traces
+    CGFloat footerWidth = self.tableView.bounds.size.width;
+    UIView *debugFooterView = [[UIView alloc] initWithFrame:CGRectMake(0.0, 0.0, footerWidth, 88.0)];
+    
+    UIButton *exportMetricsButton = [UIButton buttonWithType:UIButtonTypeSystem];
+    [exportMetricsButton setTitle:@"Export Network Metrics" forState:UIControlStateNormal];
+    [exportMetricsButton addTarget:self action:@selector(exportNetworkMetrics) forControlEvents:UIControlEventTouchUpInside];
+    exportMetricsButton.frame = CGRectMake(0.0, 0.0, footerWidth, 44.0);
+    exportMetricsButton.autoresizingMask = UIViewAutoresizingFlexibleWidth;
+    [debugFooterView addSubview:exportMetricsButton];
+    
+    UIButton *refreshTracesButton = [UIButton buttonWithType:UIButtonTypeSystem];
+    [refreshTracesButton setTitle:@"Show Refresh Traces" forState:UIControlStateNormal];
+    [refreshTracesButton addTarget:self action:@selector(showRefreshTraces) forControlEvents:UIControlEventTouchUpInside];
+    refreshTracesButton.frame = CGRectMake(0.0, 44.0, footerWidth, 44.0);
+    refreshTracesButton.autoresizingMask = UIViewAutoresizingFlexibleWidth;
+    [debugFooterView addSubview:refreshTracesButton];
+    
+    self.tableView.tableFooterView = debugFooterView;
+#endif
 }
 
 - (void)viewWillAppear:(BOOL)animated
@@ -148,6 +172,38 @@ static NSString *const kTellAFriendActionSheetTitle = @"Tell a friend about Grav
     [GRVModelManager sharedManager].userSoundsSetting = sender.isOn;
 }
 
+#if DEBUG
+/**
+ * Share the HTTP request metrics as a JSON file.
+ */
+- (void)exportNetworkMetrics
+{
+    NSError *error = nil;
+    NSData *metricsData = [[GRVHTTPManager sharedManager] requestMetricsJSONDataWithError:&error];
+    NSURL *metricsURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"gravvy-network-metrics.json"]];
+    if (!metricsData || ![metricsData writeToURL:metricsURL options:NSDataWritingAtomic error:&error]) {
+        NSLog(@"[%@ %@] %@", NSStringFromClass([self class]), NSStringFromSelector(_cmd), error);
+        return;
+    }
+    
+    UIActivityViewController *activityVC = [[UIActivityViewController alloc] initWithActivityItems:@[metricsURL]
+                                                                             applicationActivities:nil];
+    [self presentViewController:activityVC animated:YES completion:nil];
+}
+
+/**
+ * Show the stage durations of the most recent videos refreshes.
+ */
+- (void)showRefreshTraces
+{
+    [[[UIAlertView alloc] initWithTitle:@"Refresh Traces"
+                                message:[GRVRefreshTrace recentTracesSummary]
+                               delegate:nil
+                      cancelButtonTitle:@"OK"
+                      otherButtonTitles:nil] show];
+}
+#endif
+
 /**
  * Cancel the editing of user's profile
  */
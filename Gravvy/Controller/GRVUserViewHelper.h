@@ -23,16 +23,22 @@
  *
  * This attempts the following approaches for determining an avatar image in order:
  * - If the user has a thumbnail then use that for the avatar
- * - If user has an address book contact with a thumbnail, use that for the avatar
+ * - If user has an address book contact with a loaded thumbnail, use that for
+ *   the avatar
  * - If user doesn't have a thumbnail but has a fullName, create an avatar
  *   using initials of first two words. If there's just one word then take first
  *   initial only.
  *   The fullName here is that of the address book contact (if one exists).
  * - If user has neither a thumbnail nor a fullName, use a default avatar image
  *
+ * The returned view also carries an avatarIdentifier so its rendered bitmap
+ * can be shared through GRVAvatarImageCache.
+ *
  * If the user has a thumbnail URL but the avatar hasnt been downloaded yet,
  * this method starts the asynchronous download for this to be used when that
  * data is available.
+ * Similarly if the address book contact's thumbnail hasn't been loaded, this
+ * starts loading it with GRVContactThumbnailLoader.
  *
  * @param user  GRVUser to generate an avatar view for
  *
@@ -11,6 +11,7 @@
 #import "GRVUserThumbnail.h"
 #import "GRVUserAvatarView.h"
 #import "GRVContact+AddressBook.h"
+#import "GRVContactThumbnailLoader.h"
 #import "GRVFormatterUtils.h"
 
 @implementation GRVUserViewHelper
@@ -20,14 +21,20 @@
 + (GRVUserAvatarView *)userAvatarView:(GRVUser *)user
 {
     GRVUserAvatarView *userView = [[GRVUserAvatarView alloc] init];
+    UIImage *contactThumbnail = nil;
     
     if (user.avatarThumbnail.image) {
         // User has a thumbnail so that's what avatar will be based on.
         userView.thumbnail = user.avatarThumbnail.image;
+        // The thumbnail URL changes whenever the user changes their avatar
+        userView.avatarIdentifier = [NSString stringWithFormat:@"user:%@:%@", user.phoneNumber, user.avatarThumbnailURL];
         
-    } else if (user.contact.avatarThumbnail) {
+    } else if ((contactThumbnail = [[GRVContactThumbnailLoader sharedLoader] cachedThumbnailForRecordId:user.contact.recordId updatedAt:user.contact.updatedAt])) {
         // If user has an associated contact object, check for an avatar there
-        userView.thumbnail = user.contact.avatarThumbnail;
+        userView.thumbnail = contactThumbnail;
+        // Address book records are touched whenever their image changes
+        userView.avatarIdentifier = [GRVContactThumbnailLoader avatarIdentifierForRecordId:user.contact.recordId
+                                                                                 updatedAt:user.contact.updatedAt];
         
     } else {
         // We still need to generate an avatar so let's check for a  full name,
@@ -53,10 +60,13 @@
             
             // User view will be using intials
             userView.userInitials = [userInitials copy];
+            // Initials avatars look the same for everyone with those initials
+            userView.avatarIdentifier = [NSString stringWithFormat:@"initials:%@", userInitials];
             
         } else {
             // User doesnt have a full name so we will just use a default avatar
             userView.thumbnail = [UIImage imageNamed:@"defaultAvatar"];
+            userView.avatarIdentifier = @"default";
         }
     }
     
@@ -64,6 +74,15 @@
     // that URL
     if (!user.avatarThumbnail.image && user.avatarThumbnailURL) [user updateThumbnailImage];
     
+    // if there isnt a thumbnail, the address book contact might have one that
+    // just hasn't been loaded yet. The avatar view switches to it once loaded.
+    if (!user.avatarThumbnail.image && !contactThumbnail && user.contact.recordId) {
+        [userView showContactThumbnailWhenLoadedForRecordId:user.contact.recordId
+                                                  updatedAt:user.contact.updatedAt];
+        [[GRVContactThumbnailLoader sharedLoader] loadThumbnailForRecordId:user.contact.recordId
+                                                                 updatedAt:user.contact.updatedAt];
+    }
+    
     return userView;
 }
 
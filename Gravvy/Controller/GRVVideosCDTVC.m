@@ -22,12 +22,15 @@
 #import "GRVAddClipCameraVC.h"
 #import "GRVAccountManager.h"
 #import "GRVModelManager.h"
+#import "GRVCoreDataImport.h"
 #import "MBProgressHUD.h"
 #import "AMPopTip.h"
 #import "GRVMuteSwitchDetector.h"
 #import "GRVClipBrowser.h"
 #import "GRVHTTPManager.h"
-#import "AFHTTPRequestOperation.h"
+#import "GRVPreviewImageLoader.h"
+#import "GRVVideoMutationQueue.h"
+#import "GRVRefreshTrace.h"
 #import <MobileCoreServices/MobileCoreServices.h>
 
 #import <FBSDKShareKit/FBSDKShareKit.h>
@@ -47,6 +50,11 @@ static CGFloat const kTableViewCellHeightNoPlayer = 112.0f;
  */
 static CGFloat const kTableViewSectionHeaderViewHeight = 54.0f;
 
+/**
+ * Maximum number of offscreen section header views kept around for reuse
+ */
+static NSUInteger const kMaxReusableSectionHeaderViews = 4;
+
 /**
  * Table section footer view's height
  */
@@ -128,13 +136,19 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
 
 #pragma mark - Properties
 /**
- * All section header views stored in memory, with dictionary
+ * Section header views currently on screen, with dictionary
  * keys being video hash keys and values being the views
  * This makes it easy to retrieve and update section headers without reloading
  * sections or the entire tableview
  */
 @property (strong, nonatomic) NSMutableDictionary *sectionHeaderViews;
 
+/**
+ * Section header views that have gone offscreen and are ready for reuse. This
+ * never holds more than kMaxReusableSectionHeaderViews views.
+ */
+@property (strong, nonatomic) NSMutableArray *reusableSectionHeaderViews;
+
 /**
  * Have you performed the initial refresh (with reorder of videos) on view load?
  *
@@ -240,6 +254,12 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
  */
 @property (strong, nonatomic) NSMutableArray *pendingLoadingRequests;
 
+/**
+ * Video download task of each pending AVAssetResourceLoadingRequest, so the
+ * download can be cancelled when its loading request is.
+ */
+@property (strong, nonatomic) NSMapTable *videoDownloadTasks;
+
 @end
 
 @implementation GRVVideosCDTVC
@@ -277,6 +297,15 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     }
     return _sectionHeaderViews;
 }
+
+- (NSMutableArray *)reusableSectionHeaderViews
+{
+    // lazy instantiation
+    if (!_reusableSectionHeaderViews) {
+        _reusableSectionHeaderViews = [NSMutableArray array];
+    }
+    return _reusableSectionHeaderViews;
+}
 - (void)setActiveVideoCell:(GRVVideoTableViewCell *)activeVideoCell
 {
     // Show preview image of old video cell
@@ -394,6 +423,15 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     return _pendingLoadingRequests;
 }
 
+- (NSMapTable *)videoDownloadTasks
+{
+    if (!_videoDownloadTasks) {
+        // lazy instantiation
+        _videoDownloadTasks = [NSMapTable strongToStrongObjectsMapTable];
+    }
+    return _videoDownloadTasks;
+}
+
 
 #pragma mark - View Lifecycle
 - (void)viewDidLoad
@@ -463,6 +501,9 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     [super viewWillDisappear:animated];
     // Pause VC as we switch screen
     [self pause];
+    
+    // Send this screen's plays, likes and notification clears
+    [[GRVVideoMutationQueue sharedQueue] flush];
 }
 
 - (void)viewDidDisappear:(BOOL)animated
@@ -507,12 +548,12 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
 #pragma mark - Instance Methods
 #pragma mark Private
 /**
- * Reload contents of tableview, but first cancel all downloads before doing so
- * to prevent hanging
+ * Reload contents of tableview. Preview image loads of cells that are no longer
+ * shown are left to finish, as they are cached for when the cells are shown
+ * again.
  */
 - (void)refreshTableView
 {
-    [[SDWebImageManager sharedManager] cancelAll];
     [self.tableView reloadData];
 }
 
@@ -522,11 +563,14 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
  */
 - (void)clearPendingNotificationsInActiveCell
 {
-    if ([self.activeVideo hasPendingNotifications]) {
-        GRVVideoSectionHeaderView *headerView = [self.sectionHeaderViews objectForKey:self.activeVideo.hashKey];
-        
-        [self.activeVideo clearNotifications:^{
-            [self.activeVideo refreshVideo:nil];
+    GRVVideo *video = self.activeVideo;
+    if ([video hasPendingNotifications]) {
+        // The clear's response updates the video's counts so there's no need
+        // to refetch it.
+        [video clearNotifications:^{
+            // Header views are reused by other videos while the clear waits to
+            // be sent, so look up the one showing this video now.
+            GRVVideoSectionHeaderView *headerView = [self.sectionHeaderViews objectForKey:video.hashKey];
             
             // delay the hiding of the notification indicator
             [headerView.notificationIndicatorView stopPulsingAnimation];
@@ -619,8 +663,7 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     [self.activeVideoCell.spinner startAnimating];
     
     // Get ordered clips of video for creating an animated display
-    NSSortDescriptor *orderSd = [NSSortDescriptor sortDescriptorWithKey:@"order" ascending:YES];
-    NSArray *clips = [self.activeVideo.clips sortedArrayUsingDescriptors:@[orderSd]];
+    NSArray *clips = [self.activeVideo.clips array];
     NSUInteger clipsCount = [clips count];
     // Setup the anchor index, and make sure it doesn't overrun. If too large,
     // set it to the last index, and of course make sure it isn't below zero
@@ -642,6 +685,11 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     clips = [clipsStartingAtAnchorIndex copy];
     
     // Reset the collection of unfulfilled AVAssetResourceLoadingRequest objects
+    // and stop downloading videos for them
+    for (NSURLSessionDataTask *downloadTask in [self.videoDownloadTasks objectEnumerator]) {
+        [downloadTask cancel];
+    }
+    self.videoDownloadTasks = nil;
     self.pendingLoadingRequests = nil;
     
     // Setup player items
@@ -851,7 +899,7 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     
     GRVVideoTableViewCell *currentActiveVideoCell = [self determineActiveVideoCell];
     NSIndexPath *currentActiveIndexPath = [self.tableView indexPathForCell:currentActiveVideoCell];
-    GRVVideo *currentActiveVideo = [self.fetchedResultsController objectAtIndexPath:currentActiveIndexPath];
+    GRVVideo *currentActiveVideo = [self videoAtIndexPath:currentActiveIndexPath];
     
     if (!self.activeVideo ||
         ![currentActiveVideo.hashKey isEqualToString:self.activeVideo.hashKey]) {
@@ -955,7 +1003,7 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
             request.predicate = [NSPredicate predicateWithFormat:@"hashKey == %@", self.detailsVideo.hashKey];
         } else {
             // fetch all ordered videos with clips
-            request.predicate = [NSPredicate predicateWithFormat:@"(order > %d) AND (clips.@count > 0)", kGRVVideoOrderNew];
+            request.predicate = [NSPredicate predicateWithFormat:@"(order > %d) AND (clipsCount > 0)", kGRVVideoOrderNew];
         }
         
         // Show latest videos first (updatedAt storted descending)
@@ -963,7 +1011,10 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
         request.sortDescriptors = @[orderSort];
         request.fetchBatchSize = 20;
         
-        self.fetchedResultsController = [[NSFetchedResultsController alloc] initWithFetchRequest:request managedObjectContext:self.managedObjectContext sectionNameKeyPath:@"order" cacheName:nil];
+        // Videos are fetched as a flat list. Each one is still shown in its
+        // own table section (for its sticky header) via the index path mapping
+        // utilities, so a reorder is just row moves in the fetched results.
+        self.fetchedResultsController = [[NSFetchedResultsController alloc] initWithFetchRequest:request managedObjectContext:self.managedObjectContext sectionNameKeyPath:nil cacheName:nil];
         
     } else {
         self.fetchedResultsController = nil;
@@ -989,6 +1040,39 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     }];
 }
 
+/**
+ * Get the video shown at a given table view index path.
+ */
+- (GRVVideo *)videoAtIndexPath:(NSIndexPath *)indexPath
+{
+    if (!indexPath) return nil;
+    indexPath = [self mapIndexPathToFetchedResultsController:indexPath];
+    return [self.fetchedResultsController objectAtIndexPath:indexPath];
+}
+
+/**
+ * Get the table view section of the video whose header contains a given view.
+ *
+ * @return section index or NSNotFound if the view isn't in a visible header.
+ */
+- (NSInteger)sectionForViewInSectionHeader:(UIView *)view
+{
+    while (view && ![view isKindOfClass:[GRVVideoSectionHeaderView class]]) {
+        view = view.superview;
+    }
+
+    NSString *hashKey = [[self.sectionHeaderViews allKeysForObject:view] firstObject];
+    if (!hashKey) return NSNotFound;
+
+    // Header is on screen so its video's row is too
+    for (NSIndexPath *indexPath in [self.tableView indexPathsForVisibleRows]) {
+        if ([[self videoAtIndexPath:indexPath].hashKey isEqualToString:hashKey]) {
+            return indexPath.section;
+        }
+    }
+    return NSNotFound;
+}
+
 #pragma mark Public: Overrides
 - (CGFloat)tableViewFooterHeight
 {
@@ -1002,6 +1086,25 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     
 }
 
+// The fetched results controller has a single section with a row per video,
+// while the table view has a section per video each with a single row.
+- (NSIndexPath *)mapIndexPathFromFetchedResultsController:(NSIndexPath *)indexPath
+{
+    if (!indexPath) return nil;
+    return [NSIndexPath indexPathForRow:0 inSection:indexPath.row];
+}
+
+- (NSIndexPath *)mapIndexPathToFetchedResultsController:(NSIndexPath *)indexPath
+{
+    if (!indexPath) return nil;
+    return [NSIndexPath indexPathForRow:indexPath.section inSection:0];
+}
+
+- (NSInteger)mapSectionToFetchedResultsController:(NSInteger)section
+{
+    return 0;
+}
+
 #pragma mark Public: AudioVisual Player
 - (void)stop
 {
@@ -1044,9 +1147,16 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
 {
     // During refresh don't modify table for changes in managed object contexxt
     self.suspendAutomaticTrackingOfChangesInManagedObjectContext = YES;
+    // Measure main thread time spent merging the refreshed videos
+    NSTimeInterval startMergeTime = [GRVModelManager sharedManager].mainThreadMergeTime;
+    GRVRefreshTrace *trace = [GRVRefreshTrace traceIfEnabledWithReorder:YES];
     // Refresh videos from server
-    [GRVVideo refreshVideos:YES withCompletion:^{
+    [GRVVideo refreshVideos:YES trace:trace withCompletion:^{
         dispatch_async(dispatch_get_main_queue(), ^{
+            CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+            [trace endStage:GRVRefreshTraceStageMerge];
+            [trace beginStage:GRVRefreshTraceStageUIUpdate];
+            
             // run in main queue UIKit only runs there
             [self.refreshControl endRefreshing];
             self.suspendAutomaticTrackingOfChangesInManagedObjectContext = NO;
@@ -1061,6 +1171,16 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
             } else {
                 [self autoPlayVideo];
             }
+            
+            [trace endStage:GRVRefreshTraceStageUIUpdate];
+            [trace finish];
+            
+            if (self.debug) {
+                NSTimeInterval mergeTime = [GRVModelManager sharedManager].mainThreadMergeTime - startMergeTime;
+                NSTimeInterval reloadTime = CFAbsoluteTimeGetCurrent() - startTime;
+                NSLog(@"[%@ %@] main thread: merge %.1fms, reload %.1fms", NSStringFromClass([self class]), NSStringFromSelector(_cmd), mergeTime * 1000.0, reloadTime * 1000.0);
+                NSLog(@"[%@ %@] %@", NSStringFromClass([self class]), NSStringFromSelector(_cmd), [GRVCoreDataImport lastImportStatisticsForClass:[GRVVideo class]]);
+            }
         });
     }];
 }
@@ -1096,13 +1216,20 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
 {
     // During refresh don't modify table for changes in managed object contexxt
     self.suspendAutomaticTrackingOfChangesInManagedObjectContext = YES;
+    GRVRefreshTrace *trace = [GRVRefreshTrace traceIfEnabledWithReorder:NO];
     // Refresh videos from server
-    [GRVVideo refreshVideos:NO withCompletion:^{
+    [GRVVideo refreshVideos:NO trace:trace withCompletion:^{
         dispatch_async(dispatch_get_main_queue(), ^{
+            [trace endStage:GRVRefreshTraceStageMerge];
+            [trace beginStage:GRVRefreshTraceStageUIUpdate];
+            
             // run in main queue UIKit only runs there
             self.suspendAutomaticTrackingOfChangesInManagedObjectContext = NO;
             [self.tableView reloadData];
             
+            [trace endStage:GRVRefreshTraceStageUIUpdate];
+            [trace finish];
+            
             // We dont reset the active video and force an autoplay here so
             // that users can continue playing from where they left off.
         });
@@ -1155,11 +1282,10 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     
     // to ensure the button indeed is in a cell: I know this is overkill...
     if (indexPath) {
-        GRVVideo *video = [self.fetchedResultsController objectAtIndexPath:indexPath];
-        sender.enabled = NO;
-        [video toggleLike:^{
-            sender.enabled = YES;
-        }];
+        GRVVideo *video = [self videoAtIndexPath:indexPath];
+        // Likes are updated locally right away, and repeated toggles are
+        // collapsed before they're sent, so keep the button enabled.
+        [video toggleLike:nil];
     }
 }
 
@@ -1221,7 +1347,7 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
         self.actionSheetIndexPath = [self.tableView indexPathForRowAtPoint:buttonPosition];
     }
     
-    GRVVideo *video = [self.fetchedResultsController objectAtIndexPath:self.actionSheetIndexPath];
+    GRVVideo *video = [self videoAtIndexPath:self.actionSheetIndexPath];
     NSString *destructiveButtonTitle;
     if ([video isVideoOwner]) {
         destructiveButtonTitle = @"Delete Video";
@@ -1250,7 +1376,7 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     GRVVideoTableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:cellIdentifier forIndexPath:indexPath];
     
     // Configure the cell with data from the managed object
-    GRVVideo *video = [self.fetchedResultsController objectAtIndexPath:indexPath];
+    GRVVideo *video = [self videoAtIndexPath:indexPath];
     
     [self configureCell:cell withVideo:video];
     return cell;
@@ -1260,18 +1386,9 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
 - (void)configureCell:(GRVVideoTableViewCell *)cell withVideo:(GRVVideo *)video
 {
     // Video preview image is set to that of the current clip
-    NSSortDescriptor *orderSd = [NSSortDescriptor sortDescriptorWithKey:@"order" ascending:YES];
-    NSArray *clips = [video.clips sortedArrayUsingDescriptors:@[orderSd]];
-    NSUInteger clipsCount = [clips count];
-    NSUInteger clipIndex = [video.currentClipIndex integerValue];
-    if (clipIndex >= clipsCount) {
-        clipIndex = MAX(0, (clipsCount-1));
-    }
-    GRVClip *currentClip = [clips objectAtIndex:clipIndex];
+    GRVClip *currentClip = [video currentClip];
     NSString *photoThumbnailURL = currentClip.photoThumbnailURL ? currentClip.photoThumbnailURL : video.photoThumbnailURL;
-    [cell.previewImageView setShowActivityIndicatorView:YES];
-    [cell.previewImageView setIndicatorStyle:UIActivityIndicatorViewStyleWhiteLarge];
-    [cell.previewImageView sd_setImageWithURL:[NSURL URLWithString:photoThumbnailURL]];
+    [self configureCell:cell withPreviewImageURL:photoThumbnailURL];
     
     // video title
     cell.titleLabel.text = video.title;
@@ -1326,6 +1443,41 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     
 }
 
+/**
+ * Set a cell's preview image. Images are decoded and downsampled to the preview
+ * image view's pixel size in the background so only a cached bitmap is ever
+ * handed to the image view on the main thread.
+ *
+ * @param cell          GRVVideoTableViewCell to be configured
+ * @param URLString     URL of the preview image
+ */
+- (void)configureCell:(GRVVideoTableViewCell *)cell withPreviewImageURL:(NSString *)URLString
+{
+    CGSize pointSize = cell.previewImageView.bounds.size;
+    if (CGSizeEqualToSize(pointSize, CGSizeZero)) {
+        pointSize = CGSizeMake(self.tableView.bounds.size.width, self.tableView.bounds.size.width);
+    }
+    CGFloat scale = [UIScreen mainScreen].scale;
+    CGSize pixelSize = CGSizeMake(pointSize.width * scale, pointSize.height * scale);
+    
+    GRVPreviewImageLoader *imageLoader = [GRVPreviewImageLoader sharedLoader];
+    cell.previewImageURL = URLString;
+    cell.previewImageView.image = [imageLoader cachedImageFromURL:URLString pixelSize:pixelSize];
+    if (cell.previewImageView.image || ![URLString length]) {
+        [cell.previewImageSpinner stopAnimating];
+        return;
+    }
+    
+    [cell.previewImageSpinner startAnimating];
+    [imageLoader imageFromURL:URLString pixelSize:pixelSize completion:^(UIImage *image, NSString *imageURLString) {
+        // Cell might have been reused for another video by now
+        if (![cell.previewImageURL isEqualToString:imageURLString]) return;
+        
+        cell.previewImageView.image = image;
+        [cell.previewImageSpinner stopAnimating];
+    }];
+}
+
 /**
  * Configure a cell which is playing a clip at the given 0-based index of clips
  */
@@ -1346,8 +1498,7 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
         actualClipIndex = (self.activeVideoAnchorIndex + currentClipIndex) % clipsCount;
     
     } else {
-        NSSortDescriptor *orderSd = [NSSortDescriptor sortDescriptorWithKey:@"order" ascending:YES];
-        clips = [video.clips sortedArrayUsingDescriptors:@[orderSd]];
+        clips = [video.clips array];
         actualClipIndex = currentClipIndex;
     }
     
@@ -1369,14 +1520,23 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
 
 
 #pragma mark Sections
+- (NSInteger)numberOfSectionsInTableView:(UITableView *)tableView
+{
+    // A section per video
+    return [self.fetchedResultsController.fetchedObjects count];
+}
+
+- (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section
+{
+    return 1;
+}
+
 - (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section
 {
-    NSString *sectionIdentifier = [[[self.fetchedResultsController sections] objectAtIndex:section] name];
-    
     NSIndexPath *indexPath = [NSIndexPath indexPathForItem:0 inSection:section];
-    GRVVideo *video = [self.fetchedResultsController objectAtIndexPath:indexPath];
-    
-    return [NSString stringWithFormat:@"%@: %@", video.hashKey, sectionIdentifier];
+    GRVVideo *video = [self videoAtIndexPath:indexPath];
+
+    return [NSString stringWithFormat:@"%@: %@", video.hashKey, video.order];
 }
 
 - (NSArray *)sectionIndexTitlesForTableView:(UITableView *)tableView
@@ -1409,24 +1569,39 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
  */
 - (UIView *)tableView:(UITableView *)tableView viewForHeaderInSection:(NSInteger)section
 {
-    GRVVideoSectionHeaderView *headerView = [[GRVVideoSectionHeaderView alloc] initWithFrame:CGRectZero];
+    // Reuse an offscreen header view if there's one
+    GRVVideoSectionHeaderView *headerView = [self.reusableSectionHeaderViews lastObject];
+    if (headerView) {
+        [self.reusableSectionHeaderViews removeLastObject];
+    } else {
+        headerView = [[GRVVideoSectionHeaderView alloc] initWithFrame:CGRectZero];
+        [headerView.addClipButton addTarget:self action:@selector(addClip:) forControlEvents:UIControlEventTouchUpInside];
+    }
+
     // Get the video
     NSIndexPath *indexPath = [NSIndexPath indexPathForItem:0 inSection:section];
-    GRVVideo *video = [self.fetchedResultsController objectAtIndexPath:indexPath];
+    GRVVideo *video = [self videoAtIndexPath:indexPath];
 
     [self configureSectionHeaderView:headerView withVideo:video];
-    
-    // Cache section
-    headerView.addClipButton.tag = section;
-    
-    // Add target-action method but first remove previously added ones
-    [headerView.addClipButton removeTarget:nil action:NULL forControlEvents:UIControlEventTouchUpInside];
-    [headerView.addClipButton addTarget:self action:@selector(addClip:) forControlEvents:UIControlEventTouchUpInside];
-    
+
     self.sectionHeaderViews[video.hashKey] = headerView;
     return headerView;
 }
 
+- (void)tableView:(UITableView *)tableView didEndDisplayingHeaderView:(UIView *)view forSection:(NSInteger)section
+{
+    if (![view isKindOfClass:[GRVVideoSectionHeaderView class]]) return;
+
+    // The section index may already be stale, so find the header by view. Also
+    // the video might have since been given a new header view, so leave that.
+    [self.sectionHeaderViews removeObjectsForKeys:[self.sectionHeaderViews allKeysForObject:view]];
+
+    if ([self.reusableSectionHeaderViews count] < kMaxReusableSectionHeaderViews &&
+        ![self.reusableSectionHeaderViews containsObject:view]) {
+        [self.reusableSectionHeaderViews addObject:view];
+    }
+}
+
 - (CGFloat)tableView:(UITableView *)tableView heightForHeaderInSection:(NSInteger)section
 {
     return kTableViewSectionHeaderViewHeight;
@@ -1437,16 +1612,19 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
 {
     // Configure view with summary details: Owner, Creation date and Play count
     GRVUserAvatarView *avatarView = [GRVUserViewHelper userAvatarView:video.owner];
-    headerView.ownerAvatarView.thumbnail = avatarView.thumbnail;
-    headerView.ownerAvatarView.userInitials = avatarView.userInitials;
+    [headerView.ownerAvatarView setAvatarFromAvatarView:avatarView];
     
     headerView.ownerNameLabel.text = [GRVUserViewHelper userFullNameOrPhoneNumber:video.owner];
     headerView.createdAtLabel.text = [GRVFormatterUtils dayAndYearStringForDate:video.createdAt];
     
-    // Indicate if video has a notification
+    // Indicate if video has a notification. Reset the indicator's alpha as a
+    // reused header view could have been faded out on clearing notifications.
     headerView.notificationIndicatorView.hidden = ![video hasPendingNotifications];
+    headerView.notificationIndicatorView.alpha = 1.0f;
     if ([video hasPendingNotifications]) {
         [headerView.notificationIndicatorView startPulsingAnimation];
+    } else {
+        [headerView.notificationIndicatorView stopPulsingAnimation];
     }
 }
 
@@ -1466,6 +1644,14 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
 
 
 #pragma mark - UIScrollViewDelegate
+- (void)scrollViewWillBeginDragging:(UIScrollView *)scrollView
+{
+    // Measure preview image loading one fling at a time
+    if (self.debug) {
+        [[GRVPreviewImageLoader sharedLoader] resetMeasurements];
+    }
+}
+
 - (void)scrollViewDidEndDragging:(UIScrollView *)scrollView willDecelerate:(BOOL)decelerate
 {
     if (!decelerate) {
@@ -1493,6 +1679,12 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     [self autoPlayVideo];
     [self showAddClipPopTip];
     [self showFastForwardPopTip];
+    
+    if (self.debug) {
+        NSLog(@"[%@ %@] %@", NSStringFromClass([self class]), NSStringFromSelector(_cmd), [[GRVPreviewImageLoader sharedLoader] measurementsDescription]);
+        NSLog(@"[%@ %@] %@", NSStringFromClass([self class]), NSStringFromSelector(_cmd), [[GRVVideoMutationQueue sharedQueue] measurementsDescription]);
+        NSLog(@"[%@ %@] %@", NSStringFromClass([self class]), NSStringFromSelector(_cmd), [[GRVHTTPManager sharedManager] measurementsDescription]);
+    }
 }
 
 
@@ -1500,7 +1692,7 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
 - (void)actionSheet:(UIActionSheet *)actionSheet clickedButtonAtIndex:(NSInteger)buttonIndex
 {
     // Get video
-    GRVVideo *video = [self.fetchedResultsController objectAtIndexPath:self.actionSheetIndexPath];
+    GRVVideo *video = [self videoAtIndexPath:self.actionSheetIndexPath];
 
     if (actionSheet == self.shareActionSheet) {
         // Is this a request to share content
@@ -1763,13 +1955,52 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
 
 
 #pragma mark - NSFetchedResultsControllerDelegate
+- (void)controller:(NSFetchedResultsController *)controller didChangeSection:(id<NSFetchedResultsSectionInfo>)sectionInfo atIndex:(NSUInteger)sectionIndex forChangeType:(NSFetchedResultsChangeType)type
+{
+    // The fetched results controller's only section doesn't map to a table
+    // view section. Table sections come and go with video objects.
+}
+
 - (void)controller:(NSFetchedResultsController *)controller didChangeObject:(id)anObject atIndexPath:(NSIndexPath *)indexPath forChangeType:(NSFetchedResultsChangeType)type newIndexPath:(NSIndexPath *)newIndexPath
 {
-    // Override the logic on fetched video object's update to ensure section
-    // header view is refreshed, and active video cell isn't reloaded
-    if (!self.suspendAutomaticTrackingOfChangesInManagedObjectContext &&
-        type == NSFetchedResultsChangeUpdate) {
-        
+    if (self.suspendAutomaticTrackingOfChangesInManagedObjectContext) return;
+
+    // Each video is a table section so its insertions, deletions and moves are
+    // applied to sections. These all happen within the one batch of updates
+    // started in controllerWillChangeContent: so a reorder of the feed is
+    // animated as a set of section moves rather than a reload.
+    NSInteger section = [self mapIndexPathFromFetchedResultsController:indexPath].section;
+    NSInteger newSection = [self mapIndexPathFromFetchedResultsController:newIndexPath].section;
+
+    if (type == NSFetchedResultsChangeInsert) {
+        [self.tableView insertSections:[NSIndexSet indexSetWithIndex:newSection]
+                      withRowAnimation:UITableViewRowAnimationFade];
+
+    } else if (type == NSFetchedResultsChangeDelete) {
+        [self.tableView deleteSections:[NSIndexSet indexSetWithIndex:section]
+                      withRowAnimation:UITableViewRowAnimationFade];
+
+    } else if (type == NSFetchedResultsChangeMove) {
+        // A moved section keeps its header view and cell, so refresh these in
+        // place as the video could have changed too.
+        GRVVideo *video = (GRVVideo *)anObject;
+        GRVVideoSectionHeaderView *headerView = [self.sectionHeaderViews objectForKey:video.hashKey];
+        [self configureSectionHeaderView:headerView withVideo:video];
+
+        if (section != newSection) {
+            [self.tableView moveSection:section toSection:newSection];
+        }
+
+        if ([video.hashKey isEqualToString:self.activeVideo.hashKey]) {
+            [self configureCell:self.activeVideoCell withVideo:video];
+        } else {
+            GRVVideoTableViewCell *cell = (GRVVideoTableViewCell *)[self.tableView cellForRowAtIndexPath:[NSIndexPath indexPathForRow:0 inSection:section]];
+            if (cell) [self configureCell:cell withVideo:video];
+        }
+
+    } else if (type == NSFetchedResultsChangeUpdate) {
+        // Override the logic on fetched video object's update to ensure section
+        // header view is refreshed, and active video cell isn't reloaded
         // Get the video and  refresh its corresponding section header view
         GRVVideo *video = (GRVVideo *)anObject;
         GRVVideoSectionHeaderView *headerView = [self.sectionHeaderViews objectForKey:video.hashKey];
@@ -1803,26 +2034,43 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     // we don't try writing to it
     AVAssetResourceLoadingRequest* __weak weakLoadingRequest = loadingRequest;
     GRVHTTPManager *manager = [GRVHTTPManager sharedManager];
-    [manager videoFromURL:actualURL
-                 progress:^(NSUInteger bytesRead, long long totalBytesRead, long long totalBytesExpectedToRead, AFHTTPRequestOperation *operation, NSData *video) {
-                     [self processVideoDownload:video withResponse:operation.response forLoadingRequest:weakLoadingRequest];
-                 }
-                  success:^(AFHTTPRequestOperation *operation, id video) {
-                      [self processVideoDownload:video withResponse:operation.response forLoadingRequest:weakLoadingRequest];
-                  }
-                  failure:^(NSError *error) {
-                      [self failedVideoDownload:error forLoadingRequest:weakLoadingRequest];
-                  }];
+    NSURLSessionDataTask *downloadTask = [manager videoFromURL:actualURL
+                                                      progress:^(NSUInteger bytesRead, long long totalBytesRead, long long totalBytesExpectedToRead, NSURLSessionDataTask *task, NSData *video) {
+                                                          [self processVideoDownload:video withResponse:(NSHTTPURLResponse *)task.response forLoadingRequest:weakLoadingRequest];
+                                                      }
+                                                       success:^(NSURLSessionDataTask *task, NSData *video) {
+                                                           [self processVideoDownload:video withResponse:(NSHTTPURLResponse *)task.response forLoadingRequest:weakLoadingRequest];
+                                                       }
+                                                       failure:^(NSError *error) {
+                                                           [self failedVideoDownload:error forLoadingRequest:weakLoadingRequest];
+                                                       }];
+    if (downloadTask) [self.videoDownloadTasks setObject:downloadTask forKey:loadingRequest];
     
     return YES;
 }
 
 - (void)resourceLoader:(AVAssetResourceLoader *)resourceLoader didCancelLoadingRequest:(AVAssetResourceLoadingRequest *)loadingRequest
 {
-    [self.pendingLoadingRequests removeObject:loadingRequest];
+    [self removePendingLoadingRequest:loadingRequest];
 }
 
 #pragma mark Helpers
+/**
+ * Stop tracking a loading request that is done with, and cancel its video
+ * download. Only this loading request uses the download, so cancelling it
+ * frees a video download slot for the videos still being watched.
+ *
+ * @param loadingRequest    Loading Request that triggered the video download
+ */
+- (void)removePendingLoadingRequest:(AVAssetResourceLoadingRequest *)loadingRequest
+{
+    if (!loadingRequest) return;
+    
+    [[self.videoDownloadTasks objectForKey:loadingRequest] cancel];
+    [self.videoDownloadTasks removeObjectForKey:loadingRequest];
+    [self.pendingLoadingRequests removeObject:loadingRequest];
+}
+
 /**
  * Handle progress in the the request to download an MP4 video.
  *
@@ -1852,7 +2100,7 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
         if (didRespondCompletely) {
             // treat the processing of the request as complete
             [loadingRequest finishLoading];
-            [self.pendingLoadingRequests removeObject:loadingRequest];
+            [self removePendingLoadingRequest:loadingRequest];
         }
     }
 }
@@ -1870,7 +2118,7 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     // If loading request has been canceled or finished then do nothing
     if (!loadingRequest.cancelled && !loadingRequest.finished) {
         [loadingRequest finishLoadingWithError:error];
-        [self.pendingLoadingRequests removeObject:loadingRequest];
+        [self removePendingLoadingRequest:loadingRequest];
     }
 }
 
@@ -2055,7 +2303,7 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
                      forSegue:(NSString *)segueIdentifier
                 fromIndexPath:(NSIndexPath *)indexPath
 {
-    GRVVideo *video = [self.fetchedResultsController objectAtIndexPath:indexPath];
+    GRVVideo *video = [self videoAtIndexPath:indexPath];
     if ([vc isKindOfClass:[GRVMembersCDTVC class]]) {
         if (![segueIdentifier length] || [segueIdentifier isEqualToString:kSegueIdentifierShowMembers]) {
             // prepare vc
@@ -2093,8 +2341,12 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
     
     } else if ([sender isKindOfClass:[UIButton class]]) {
         if ([segue.identifier isEqualToString:kSegueIdentifierAddClip]) {
-            UIButton *addClipButton = (UIButton *)sender;
-            indexPath = [NSIndexPath indexPathForItem:0 inSection:addClipButton.tag];
+            // Section header views are reused and sections move on reorders,
+            // so find the section from the video the header currently shows
+            NSInteger section = [self sectionForViewInSectionHeader:sender];
+            if (section != NSNotFound) {
+                indexPath = [NSIndexPath indexPathForItem:0 inSection:section];
+            }
 
         } else {
             CGPoint buttonPosition = [sender convertPoint:CGPointZero toView:self.tableView];
@@ -2139,10 +2391,8 @@ static NSString *const kVideoShareURLFormatString = @"http://gravvy.nnoduka.com/
         // Set video's current index to start at the newly added clip
         GRVVideo *video = cameraReviewVC.video;
         GRVClip *addedClip = cameraReviewVC.addedClip;
-        NSSortDescriptor *orderSd = [NSSortDescriptor sortDescriptorWithKey:@"order" ascending:YES];
-        NSArray *clips = [video.clips sortedArrayUsingDescriptors:@[orderSd]];
         NSUInteger newClipIndex = 0;
-        for (GRVClip *clip in clips) {
+        for (GRVClip *clip in video.clips) {
             if ([clip.identifier integerValue] == [addedClip.identifier integerValue]) {
                 // Have found current clip
                 break;
@@ -12,16 +12,32 @@
 #import "GRVClip+HTTP.h"
 #import "GRVMember.h"
 #import "GRVCoreDataImport.h"
-#import "GRVFormatterUtils.h"
+#import "GRVAttributeMapping.h"
 #import "GRVConstants.h"
 #import "GRVAccountManager.h"
 #import "GRVHTTPManager.h"
+#import "GRVJSONListReader.h"
 #import "GRVModelManager.h"
 
 @implementation GRVActivity (HTTP)
 
 #pragma mark - Class Methods
 #pragma mark Private
+/**
+ * Mapping of an activity's JSON attributes
+ */
++ (GRVAttributeMapping *)attributeMapping
+{
+    static GRVAttributeMapping *mapping = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mapping = [GRVAttributeMapping mappingWithAttributes:@[
+            @[kGRVRESTActivityCreatedAtKey, @"createdAt",   @(GRVAttributeTypeDate)],
+            @[kGRVRESTActivityVerbKey,      @"verb",        @(GRVAttributeTypeString)]]];
+    });
+    return mapping;
+}
+
 /**
  * Create a new activity
  *
@@ -33,17 +49,8 @@
 {
     GRVActivity *newActivity = [NSEntityDescription insertNewObjectForEntityForName:@"GRVActivity" inManagedObjectContext:context];
     
-    NSDateFormatter *rfc3339DateFormatter = [GRVFormatterUtils generateRFC3339DateFormatter];
-    
-    // Setup all the dates
-    NSString *rfc3339CreatedAt = [[activityDictionary objectForKey:kGRVRESTActivityCreatedAtKey] description];
-    NSDate *createdAt = [rfc3339DateFormatter dateFromString:rfc3339CreatedAt];
-    
-    // Get and save dictionary attributes being sure call the description method
-    // incase dictionary values are NULL
-    newActivity.createdAt = createdAt;
     newActivity.identifier = [activityDictionary objectForKey:kGRVRESTActivityIdentifierKey];
-    newActivity.verb = [[activityDictionary objectForKey:kGRVRESTActivityVerbKey] description];
+    [[GRVActivity attributeMapping] applyToObject:newActivity fromDictionary:activityDictionary];
     
     // Setup the relationships
     // Set the actor
@@ -82,6 +89,8 @@
         newActivity.objectUser = [GRVUser userWithUserInfo:object inManagedObjectContext:context];
     }
     
+    newActivity.fingerprint = [GRVCoreDataImport fingerprintForObjectInfo:activityDictionary];
+    
     return newActivity;
 }
 
@@ -97,7 +106,10 @@
 {
     NSManagedObjectContext *context = existingActivity.managedObjectContext;
     
-    // Activities don't change, but related objects might have changed
+    // Activities don't change, but related objects might have changed. They
+    // haven't if the activity's representation is unchanged.
+    NSString *fingerprint = [GRVCoreDataImport fingerprintForObjectInfo:activityDictionary];
+    if ([GRVCoreDataImport isUnchangedObject:existingActivity withFingerprint:fingerprint]) return;
     
     // Update the actor
     NSDictionary *actorDictionary = [activityDictionary objectForKey:kGRVRESTActivityActorKey];
@@ -128,10 +140,14 @@
         // object is a user
         [GRVUser userWithUserInfo:object inManagedObjectContext:context];
     }
+    
+    if (![existingActivity.fingerprint isEqualToString:fingerprint]) existingActivity.fingerprint = fingerprint;
 }
 
 /**
  * Delete GRVActivity objects not in a provided array of activity JSON objects.
+ * Activities only have to-one relationships, which don't leave references
+ * behind in related objects, so they can be batch deleted in the store.
  *
  * @param activityDicts     Array of activityDictionary objects, where each
  *                          contains JSON data as expected from server.
@@ -140,12 +156,13 @@
 + (void)deleteActivitiesNotInActivityInfoArray:(NSArray *)activityDicts
                         inManagedObjectContext:(NSManagedObjectContext *)context
 {
-    [GRVCoreDataImport deleteObjectsNotInObjectInfoArray:activityDicts
-                                  inManagedObjectContext:context
-                                                forClass:[GRVActivity class]
-                                usingAdditionalPredicate:nil
-                                 withObjectIdentifierKey:@"identifier"
-                                    andDictIdentifierKey:kGRVRESTActivityIdentifierKey];
+    [GRVCoreDataImport batchDeleteObjectsNotInObjectInfoArray:activityDicts
+                                       inManagedObjectContext:context
+                                                     forClass:[GRVActivity class]
+                                     usingAdditionalPredicate:nil
+                                      withObjectIdentifierKey:@"identifier"
+                                         andDictIdentifierKey:kGRVRESTActivityIdentifierKey
+                                           fixupRelationships:nil];
 }
 
 
@@ -195,46 +212,55 @@
         return;
     }
     
+    // Use worker context for background execution
+    NSManagedObjectContext *workerContext = [GRVModelManager sharedManager].workerContext;
+    if (!workerContext) {
+        // No worker context available so execute callback block
+        if (activitiesAreRefreshed) activitiesAreRefreshed();
+        return;
+    }
+    
+    // The response is read, and the callbacks executed, on the worker
+    // context's queue.
     GRVHTTPManager *httpManager = [GRVHTTPManager sharedManager];
     [httpManager request:GRVHTTPMethodGET
                   forURL:kGRVRESTUserActivities
               parameters:nil
-                 success:^(NSURLSessionDataTask *task, id responseObject) {
+  inManagedObjectContext:workerContext
+                 listKey:kGRVRESTListResultsKey
+                 success:^(NSURLSessionDataTask *task, GRVJSONListReader *activitiesJSON) {
                      
-                     // get array of activity dictionaries in response
-                     NSArray *activitiesJSON = [responseObject objectForKey:kGRVRESTListResultsKey];
+                     // Refresh the activities in batches, each of which is
+                     // parsed from the response, saved and faulted out before
+                     // the next. Hold on to just their identifiers.
+                     NSMutableArray *activityIdentifiers = [NSMutableArray array];
+                     GRVCoreDataImportStatistics *statistics = [GRVCoreDataImport importObjectsFromEnumerator:activitiesJSON inBatchesOfSize:kGRVCoreDataImportBatchSize inManagedObjectContext:workerContext usingImportBatch:^NSArray *(NSArray *batch, NSManagedObjectContext *context) {
+                         for (NSDictionary *activityDictionary in batch) {
+                             id identifier = [activityDictionary objectForKey:kGRVRESTActivityIdentifierKey];
+                             if (identifier) [activityIdentifiers addObject:@{kGRVRESTActivityIdentifierKey : identifier}];
+                         }
+                         return [GRVActivity activitiesWithActivityInfoArray:batch inManagedObjectContext:context];
+                     }];
+                     [GRVCoreDataImport setLastImportStatistics:statistics forClass:[GRVActivity class]];
                      
-                     // Use worker context for background execution
-                     NSManagedObjectContext *workerContext = [GRVModelManager sharedManager].workerContext;
-                     if (workerContext) {
-                         [workerContext performBlock:^{
-                             // Delete activities that aren't still relevant
-                             [GRVActivity deleteActivitiesNotInActivityInfoArray:activitiesJSON inManagedObjectContext:workerContext];
-                             
-                             // Now refresh the activities
-                             [GRVActivity activitiesWithActivityInfoArray:activitiesJSON inManagedObjectContext:workerContext];
-                             
-                             // Push changes up to main thread context. Alternatively,
-                             // could turn all objects into faults but this is easier.
-                             [workerContext save:NULL];
-                             
-                             // ensure context is cleaned up for next use.
-                             [workerContext reset];
-                             
-                             // finally execute the callback block on main queue
-                             dispatch_async(dispatch_get_main_queue(), ^{
-                                 if (activitiesAreRefreshed) activitiesAreRefreshed();
-                             });
-                         }];
-                         
-                     } else {
-                         // No worker context available so execute callback block
-                         if (activitiesAreRefreshed) activitiesAreRefreshed();
+                     // Delete activities that aren't still relevant, but only
+                     // if the entire list could be read.
+                     if (!activitiesJSON.error) {
+                         [GRVActivity deleteActivitiesNotInActivityInfoArray:activityIdentifiers inManagedObjectContext:workerContext];
+                         if ([workerContext hasChanges]) [workerContext save:NULL];
+                         [workerContext reset];
                      }
+                     
+                     // finally execute the callback block on main queue
+                     dispatch_async(dispatch_get_main_queue(), ^{
+                         if (activitiesAreRefreshed) activitiesAreRefreshed();
+                     });
                  }
                  failure:^(NSURLSessionDataTask *task, NSError *error, id responseObject) {
-                     // do nothing but execute the callback block
-                     if (activitiesAreRefreshed) activitiesAreRefreshed();
+                     // do nothing but execute the callback block on main queue
+                     dispatch_async(dispatch_get_main_queue(), ^{
+                         if (activitiesAreRefreshed) activitiesAreRefreshed();
+                     });
                  }];
 }
 
@@ -16,6 +16,7 @@
 @property (nonatomic, retain) NSNumber * identifier;
 @property (nonatomic, retain) NSString * verb;
 @property (nonatomic, retain) NSDate * createdAt;
+@property (nonatomic, retain) NSString * fingerprint;
 @property (nonatomic, retain) GRVUser *actor;
 @property (nonatomic, retain) GRVVideo *targetVideo;
 @property (nonatomic, retain) GRVVideo *objectVideo;
@@ -17,6 +17,7 @@
 @dynamic identifier;
 @dynamic verb;
 @dynamic createdAt;
+@dynamic fingerprint;
 @dynamic actor;
 @dynamic targetVideo;
 @dynamic objectVideo;
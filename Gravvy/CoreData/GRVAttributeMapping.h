@@ -0,0 +1,66 @@
+//
+//  GRVAttributeMapping.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/24/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <CoreData/CoreData.h>
+
+/**
+ * How a JSON value is transformed before being set on an attribute.
+ */
+typedef NS_ENUM(NSInteger, GRVAttributeType) {
+    GRVAttributeTypeString = 0, // non-strings are converted using their description
+    GRVAttributeTypeNumber,     // NSNumber values as is
+    GRVAttributeTypeBoolean,    // @(boolValue) of the JSON value
+    GRVAttributeTypeDate        // RFC 3339 formatted date string
+};
+
+/**
+ * GRVAttributeMapping sets the attributes of a managed object from a JSON
+ * object dictionary, as described by a mapping table.
+ *
+ * @discussion The table is compiled once, when the mapping is created, into a
+ *      plan of getter/setter selectors and value transforms, so applying a
+ *      mapping doesn't parse keys or look anything up by name.
+ *
+ *      Each attribute is compared with its new value before being set, and only
+ *      changed values are written. Unchanged objects therefore don't show up as
+ *      updated in NSFetchedResultsControllers when their context is saved or
+ *      merged.
+ *
+ *      JSON keys missing from a dictionary are skipped, so a mapping can be
+ *      applied to partial JSON representations. NSNull values are set as nil.
+ */
+@interface GRVAttributeMapping : NSObject
+
+#pragma mark - Class Methods
+/**
+ * Create a mapping from a mapping table.
+ *
+ * @param attributes
+ *      Array of mapping table rows where each row is an array of:
+ *          - JSON dictionary key (kGRVREST... constant)
+ *          - managed object attribute name
+ *          - GRVAttributeType, as an NSNumber
+ *
+ * @return An initialized GRVAttributeMapping object.
+ */
++ (instancetype)mappingWithAttributes:(NSArray *)attributes;
+
+#pragma mark - Instance Methods
+/**
+ * Set a managed object's attributes from a JSON object dictionary. Attributes
+ * whose values haven't changed aren't written.
+ *
+ * @param managedObject     Managed object to be updated
+ * @param dictionary        JSON object dictionary from the server
+ *
+ * @return YES if any attribute was written, NO if all were unchanged.
+ */
+- (BOOL)applyToObject:(NSManagedObject *)managedObject fromDictionary:(NSDictionary *)dictionary;
+
+@end
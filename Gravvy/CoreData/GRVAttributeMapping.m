@@ -0,0 +1,149 @@
+//
+//  GRVAttributeMapping.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/24/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVAttributeMapping.h"
+#import "GRVFormatterUtils.h"
+#import <objc/message.h>
+
+/**
+ * A compiled mapping table row.
+ * Object pointers are unretained as they are retained by the mapping's
+ * keys array.
+ */
+typedef struct {
+    __unsafe_unretained NSString *key;
+    SEL getter;
+    SEL setter;
+    GRVAttributeType type;
+} GRVAttributeMappingStep;
+
+@interface GRVAttributeMapping ()
+
+/**
+ * JSON dictionary keys of the plan, which keep the steps' keys alive.
+ */
+@property (strong, nonatomic) NSArray *keys;
+
+/**
+ * The compiled plan, with planCount steps.
+ */
+@property (nonatomic) GRVAttributeMappingStep *plan;
+@property (nonatomic) NSUInteger planCount;
+
+/**
+ * Date formatter for GRVAttributeTypeDate values. NSDateFormatter is thread
+ * safe on iOS 7 and later so this is shared by all contexts.
+ */
+@property (strong, nonatomic) NSDateFormatter *rfc3339DateFormatter;
+
+@end
+
+@implementation GRVAttributeMapping
+
+#pragma mark - Class Methods
++ (instancetype)mappingWithAttributes:(NSArray *)attributes
+{
+    return [[self alloc] initWithAttributes:attributes];
+}
+
+#pragma mark - Initialization
+- (instancetype)initWithAttributes:(NSArray *)attributes
+{
+    self = [super init];
+    if (self) {
+        _rfc3339DateFormatter = [GRVFormatterUtils generateRFC3339DateFormatter];
+
+        // Compile the table into a plan
+        NSMutableArray *keys = [NSMutableArray arrayWithCapacity:[attributes count]];
+        _plan = calloc(MAX([attributes count], 1), sizeof(GRVAttributeMappingStep));
+        _planCount = [attributes count];
+
+        NSUInteger idx = 0;
+        for (NSArray *attribute in attributes) {
+            NSAssert([attribute count] == 3, @"mapping table rows are [key, attribute name, type]");
+            NSString *key = [attribute[0] copy];
+            NSString *attributeName = attribute[1];
+            [keys addObject:key];
+
+            NSString *setterName = [NSString stringWithFormat:@"set%@%@:",
+                                    [[attributeName substringToIndex:1] uppercaseString],
+                                    [attributeName substringFromIndex:1]];
+
+            _plan[idx].key = key;
+            _plan[idx].getter = NSSelectorFromString(attributeName);
+            _plan[idx].setter = NSSelectorFromString(setterName);
+            _plan[idx].type = [attribute[2] integerValue];
+            idx++;
+        }
+        _keys = keys;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_plan);
+}
+
+
+#pragma mark - Instance Methods
+#pragma mark Private
+/**
+ * Transform a JSON value for an attribute of a given type.
+ *
+ * @param value     JSON value, which isn't nil.
+ * @param type      Attribute type
+ *
+ * @return transformed value, nil for NSNull.
+ */
+- (id)transformedValue:(id)value forType:(GRVAttributeType)type
+{
+    if (value == [NSNull null]) {
+        return (type == GRVAttributeTypeBoolean) ? @(NO) : nil;
+    }
+
+    switch (type) {
+        case GRVAttributeTypeString:
+            return [value isKindOfClass:[NSString class]] ? value : [value description];
+
+        case GRVAttributeTypeNumber:
+            return value;
+
+        case GRVAttributeTypeBoolean:
+            return @([value boolValue]);
+
+        case GRVAttributeTypeDate:
+            return [self.rfc3339DateFormatter dateFromString:[value description]];
+    }
+    return value;
+}
+
+#pragma mark Public
+- (BOOL)applyToObject:(NSManagedObject *)managedObject fromDictionary:(NSDictionary *)dictionary
+{
+    if (![dictionary isKindOfClass:[NSDictionary class]]) return NO;
+
+    BOOL changed = NO;
+    for (NSUInteger i = 0; i < self.planCount; i++) {
+        GRVAttributeMappingStep step = self.plan[i];
+
+        id value = [dictionary objectForKey:step.key];
+        if (!value) continue; // not in this JSON representation
+        value = [self transformedValue:value forType:step.type];
+
+        // Only write dirty values
+        id currentValue = ((id (*)(id, SEL))objc_msgSend)(managedObject, step.getter);
+        if ((value == currentValue) || [value isEqual:currentValue]) continue;
+
+        ((void (*)(id, SEL, id))objc_msgSend)(managedObject, step.setter, value);
+        changed = YES;
+    }
+    return changed;
+}
+
+@end
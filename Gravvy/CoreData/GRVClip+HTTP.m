@@ -8,14 +8,33 @@
 
 #import "GRVClip+HTTP.h"
 #import "GRVUser+HTTP.h"
+#import "GRVVideo+HTTP.h"
 #import "GRVCoreDataImport.h"
-#import "GRVFormatterUtils.h"
+#import "GRVAttributeMapping.h"
 #import "GRVConstants.h"
 
 @implementation GRVClip (HTTP)
 
 #pragma mark - Class Methods
 #pragma mark Private
+/**
+ * Mapping of a clip's JSON attributes
+ */
++ (GRVAttributeMapping *)attributeMapping
+{
+    static GRVAttributeMapping *mapping = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mapping = [GRVAttributeMapping mappingWithAttributes:@[
+            @[kGRVRESTClipDurationKey,          @"duration",            @(GRVAttributeTypeNumber)],
+            @[kGRVRESTClipMp4Key,               @"mp4URL",              @(GRVAttributeTypeString)],
+            @[kGRVRESTClipOrderKey,             @"order",               @(GRVAttributeTypeNumber)],
+            @[kGRVRESTClipPhotoThumbnailKey,    @"photoThumbnailURL",   @(GRVAttributeTypeString)],
+            @[kGRVRESTClipUpdatedAtKey,         @"updatedAt",           @(GRVAttributeTypeDate)]]];
+    });
+    return mapping;
+}
+
 /**
  * Create a new clip
  *
@@ -29,20 +48,8 @@
 {
     GRVClip *newClip = [NSEntityDescription insertNewObjectForEntityForName:@"GRVClip" inManagedObjectContext:context];
     
-    NSDateFormatter *rfc3339DateFormatter = [GRVFormatterUtils generateRFC3339DateFormatter];
-    
-    // Setup all the dates
-    NSString *rfc3339UpdatedAt = [[clipDictionary objectForKey:kGRVRESTClipUpdatedAtKey] description];
-    NSDate *updatedAt = [rfc3339DateFormatter dateFromString:rfc3339UpdatedAt];
-    
-    // Get and save dictionary attributes being sure to call the description method
-    // incase dictionary values are NULL
-    newClip.duration = [clipDictionary objectForKey:kGRVRESTClipDurationKey];
     newClip.identifier = [clipDictionary objectForKey:kGRVRESTClipIdentifierKey];
-    newClip.mp4URL = [[clipDictionary objectForKey:kGRVRESTClipMp4Key] description];
-    newClip.order = [clipDictionary objectForKey:kGRVRESTClipOrderKey];
-    newClip.photoThumbnailURL = [[clipDictionary objectForKey:kGRVRESTClipPhotoThumbnailKey] description];
-    newClip.updatedAt = updatedAt;
+    [[GRVClip attributeMapping] applyToObject:newClip fromDictionary:clipDictionary];
     
     // Setup required relationships
     newClip.owner = [GRVUser userWithUserInfo:[clipDictionary objectForKey:kGRVRESTClipOwnerKey] inManagedObjectContext:context];
@@ -52,7 +59,9 @@
 }
 
 /**
- * Update an existing clip with a given clip object from server
+ * Update an existing clip with a given clip object from server.
+ * Only attributes that have changed get written, which covers changes in
+ * updatedAt, and changes in URLs (possibly from CDN changes).
  *
  * @param existingClip      Existing GRVClip object to be updated
  * @param clipDictionary    Clip object with all attributes from server
@@ -60,33 +69,12 @@
 + (void)syncClip:(GRVClip *)existingClip
     withClipInfo:(NSDictionary *)clipDictionary
 {
-    NSDateFormatter *rfc3339DateFormatter = [GRVFormatterUtils generateRFC3339DateFormatter];
-    
-    // get updatedAt date which is used for sync
-    NSString *rfc3339UpdatedAt = [[clipDictionary objectForKey:kGRVRESTClipUpdatedAtKey] description];
-    NSDate *updatedAt = [rfc3339DateFormatter dateFromString:rfc3339UpdatedAt];
-    
     // Even though clip might might not have changed but video owner might have been updated
     GRVUser *owner = [GRVUser userWithUserInfo:[clipDictionary objectForKey:kGRVRESTClipOwnerKey]
        inManagedObjectContext:existingClip.managedObjectContext];
     
-    // Get URL strings
-    NSString *photoThumbnailURL = [[clipDictionary objectForKey:kGRVRESTClipPhotoThumbnailKey] description];
-    NSString *mp4URL = [[clipDictionary objectForKey:kGRVRESTClipMp4Key] description];
-    
-    // only perform a sync if there are any changes which is indicated by a change
-    // in updatedAt, or changes in URLs (possibly from CDN changes)
-    // This also coverts the case that photo thumbnail wasn't always present in
-    // in the model, so if it's missing it gets added in now.
-    if (![updatedAt isEqualToDate:existingClip.updatedAt] ||
-        ![photoThumbnailURL isEqualToString:existingClip.photoThumbnailURL] ||
-        ![mp4URL isEqualToString:existingClip.mp4URL]) {
-        existingClip.mp4URL = mp4URL;
-        existingClip.order = [clipDictionary objectForKey:kGRVRESTClipOrderKey];
-        existingClip.photoThumbnailURL = photoThumbnailURL;
-        existingClip.updatedAt = updatedAt;
-        existingClip.owner = owner;
-    }
+    [[GRVClip attributeMapping] applyToObject:existingClip fromDictionary:clipDictionary];
+    if (existingClip.owner != owner) existingClip.owner = owner;
 }
 
 /**
@@ -118,7 +106,7 @@
                  associatedVideo:(GRVVideo *)video
           inManagedObjectContext:(NSManagedObjectContext *)context
 {
-    return [GRVCoreDataImport objectWithObjectInfo:clipDictionary
+    GRVClip *clip = [GRVCoreDataImport objectWithObjectInfo:clipDictionary
                             inManagedObjectContext:context
                                           forClass:[GRVClip class]
                                      withPredicate:^NSPredicate *{
@@ -133,6 +121,12 @@
                                      } syncObject:^(NSManagedObject *existingObject, NSDictionary *objectDictionary) {
                                          [GRVClip syncClip:(GRVClip *)existingObject withClipInfo:objectDictionary];
                                      }];
+    
+    // A new clip is appended to the video's clips so put it in its place
+    [video sortClips];
+    [video updateClipsCount];
+    
+    return clip;
 }
 
 + (NSArray *)clipsWithClipInfoArray:(NSArray *)clipDicts
@@ -8,13 +8,13 @@
 
 #import "GRVContact.h"
 #import <AddressBook/AddressBook.h>
+#import "GRVCoreDataImport.h"
 
 /**
  * Using this file as a location to document the GRVContact model which is what
  * represents an Address Book Contact, ABPerson.
  *
  * Property             Purpose
- * avatarThumbnail      Thumbnail image
  * firstName            First Name
  * lastName             Last name
  * recordId             Record identifier in address book.
@@ -24,6 +24,9 @@
  * phoneNumbers         All GRVUser objects this contact is linked to by having
  *                      matching saved phone numbers.
  *
+ * The contact's thumbnail image isn't stored. It is read from the address book
+ * by recordId when displayed, using GRVContactThumbnailLoader.
+ *
  */
 @interface GRVContact (AddressBook)
 
@@ -53,6 +56,44 @@
 + (NSArray *)contactsWithPersonRecordArray:(CFArrayRef)peopleRecords
                     inManagedObjectContext:(NSManagedObjectContext *)context;
 
+/**
+ * Find-or-Create a batch of contact objects from contact info dictionaries,
+ * which are address book person records read into kGRVContact...Key keys.
+ *
+ * @param contactDicts      Array of contact info dictionaries
+ * @param context           handle to database
+ *
+ * @return Initialized GRVContact instances (based on passed in dictionaries)
+ */
++ (NSArray *)contactsWithContactInfoArray:(NSArray *)contactDicts
+                   inManagedObjectContext:(NSManagedObjectContext *)context;
+
+/**
+ * Delete GRVContact objects not in a provided array of contact info
+ * dictionaries. The contacts are batch deleted in the store so they are never
+ * fetched, and their users are marked as unknown.
+ *
+ * @param contactDicts      Array of contact info dictionaries
+ * @param context           handle to database
+ */
++ (void)deleteContactsNotInContactInfoArray:(NSArray *)contactDicts
+                     inManagedObjectContext:(NSManagedObjectContext *)context;
+
+/**
+ * Sync the GRVContact objects with the full set of address book contacts:
+ * delete contacts that are gone, then find-or-create the rest in batches.
+ * This is the body of the contacts sync, without the address book, so it can
+ * be run against synthetic contacts.
+ *
+ * @param contactDicts      Contact info dictionaries of every address book
+ *      contact
+ * @param context           handle to database
+ *
+ * @return statistics of the batched import.
+ */
++ (GRVCoreDataImportStatistics *)syncContactsWithContactInfoArray:(NSArray *)contactDicts
+                                           inManagedObjectContext:(NSManagedObjectContext *)context;
+
 
 /**
  * Update the Core Data GRVContact objects to be sync'd with the information in the
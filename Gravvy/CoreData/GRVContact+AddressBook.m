@@ -13,43 +13,79 @@
 #import "GRVCoreDataImport.h"
 #import "GRVConstants.h"
 
-#pragma mark - Constants
-/**
- * To use the GRVCoreDataImport methods we need to create dictionary objects
- * that contain just a recordId. This will be the key of the record Ids.
- */
-static NSString *const kGRVAddressBookPersonRecordIdKey = @"recordId";
-
 @implementation GRVContact (AddressBook)
 
 #pragma mark - Class Methods
 #pragma mark Private
+/**
+ * Read the properties of an Address Book Person record that are sync'd into a
+ * contact info dictionary, so the sync doesn't depend on ABPerson records.
+ *
+ * @param personRecord      ABPerson record
+ *
+ * @return contact info dictionary with kGRVContact...Key keys. Missing names
+ *      and modification date are left out.
+ */
++ (NSDictionary *)contactInfoWithPersonRecord:(ABRecordRef)personRecord
+{
+    NSMutableDictionary *contactInfo = [NSMutableDictionary dictionary];
+    contactInfo[kGRVContactRecordIdKey] = @((NSInteger)ABRecordGetRecordID(personRecord));
+    contactInfo[kGRVContactPhoneNumbersKey] = [GRVAddressBookManager arrayProperty:kABPersonPhoneProperty
+                                                                        fromRecord:personRecord] ?: @[];
+    
+    NSString *firstName = [GRVAddressBookManager stringProperty:kABPersonFirstNameProperty
+                                                     fromRecord:personRecord];
+    NSString *lastName = [GRVAddressBookManager stringProperty:kABPersonLastNameProperty
+                                                    fromRecord:personRecord];
+    NSDate *updatedAt = [GRVAddressBookManager dateProperty:kABPersonModificationDateProperty
+                                                 fromRecord:personRecord];
+    if (firstName) contactInfo[kGRVContactFirstNameKey] = firstName;
+    if (lastName) contactInfo[kGRVContactLastNameKey] = lastName;
+    if (updatedAt) contactInfo[kGRVContactUpdatedAtKey] = updatedAt;
+    
+    return contactInfo;
+}
+
+/**
+ * Read an array of Address Book Person records into contact info dictionaries.
+ *
+ * @param peopleRecords     Array of ABPerson records
+ *
+ * @return array of contact info dictionaries, in the order of the records.
+ */
++ (NSArray *)contactInfoArrayWithPersonRecordArray:(CFArrayRef)peopleRecords
+{
+    CFIndex peopleRecordsCount = peopleRecords ? CFArrayGetCount(peopleRecords) : 0;
+    NSMutableArray *contactDicts = [NSMutableArray arrayWithCapacity:peopleRecordsCount];
+    
+    for (CFIndex i=0; i<peopleRecordsCount; i++) {
+        ABRecordRef personRecord = CFArrayGetValueAtIndex(peopleRecords, i);
+        @autoreleasepool {
+            [contactDicts addObject:[GRVContact contactInfoWithPersonRecord:personRecord]];
+        }
+    }
+    
+    return contactDicts;
+}
 
 /**
  * Create a new contact
  *
- * @param personRecord      ABPerson record
+ * @param contactDictionary Contact info dictionary
  * @param context           handle to database
  */
-+ (instancetype)newContactWithPersonRecord:(ABRecordRef)personRecord
-                    inManagedObjectContext:(NSManagedObjectContext *)context
++ (instancetype)newContactWithContactInfo:(NSDictionary *)contactDictionary
+                   inManagedObjectContext:(NSManagedObjectContext *)context
 {
     GRVContact *newContact = [NSEntityDescription insertNewObjectForEntityForName:@"GRVContact" inManagedObjectContext:context];
     
-    newContact.avatarThumbnail = [GRVAddressBookManager imagePropertyFromRecord:personRecord
-                                                                    asThumbnail:YES];
-    newContact.firstName = [GRVAddressBookManager stringProperty:kABPersonFirstNameProperty
-                                                      fromRecord:personRecord];
-    newContact.lastName = [GRVAddressBookManager stringProperty:kABPersonLastNameProperty
-                                                     fromRecord:personRecord];
-    newContact.recordId = @((NSInteger)ABRecordGetRecordID(personRecord));
-    newContact.updatedAt = [GRVAddressBookManager dateProperty:kABPersonModificationDateProperty
-                                                       fromRecord:personRecord];
+    newContact.firstName = contactDictionary[kGRVContactFirstNameKey];
+    newContact.lastName = contactDictionary[kGRVContactLastNameKey];
+    newContact.recordId = contactDictionary[kGRVContactRecordIdKey];
+    newContact.updatedAt = contactDictionary[kGRVContactUpdatedAtKey];
     
     // Setup the associated phoneNumbers as GRVUsers
-    NSArray *personRecordPhoneNumbers = [GRVAddressBookManager arrayProperty:kABPersonPhoneProperty
-                                                                  fromRecord:personRecord];
-    NSArray *phoneNumbers = [GRVUser usersWithPhoneNumberArray:personRecordPhoneNumbers
+    NSArray *phoneNumbers = [GRVUser usersWithPhoneNumberArray:contactDictionary[kGRVContactPhoneNumbersKey]
                                         inManagedObjectContext:context];
     for (GRVUser *user in phoneNumbers) {
         if ([user.relationshipType integerValue] != GRVUserRelationshipTypeMe) {
@@ -62,20 +98,18 @@ static NSString *const kGRVAddressBookPersonRecordIdKey = @"recordId";
 }
 
 /**
- * Update an existing contact with a given Address Book Person record
+ * Update an existing contact with a given contact info dictionary
  * Note that all properties but recordId are syncd
  *
  * @param existingContact   Existing GRVContact object to be updated
- * @param personRecord      ABPerson record
+ * @param contactDictionary Contact info dictionary
  */
-+ (void)syncContact:(GRVContact *)existingContact withPersonRecord:(ABRecordRef)personRecord
++ (void)syncContact:(GRVContact *)existingContact withContactInfo:(NSDictionary *)contactDictionary
 {
     // get updatedAt, firstName, and lastName which are used for sync
-    NSDate *updatedAt = [GRVAddressBookManager dateProperty:kABPersonModificationDateProperty fromRecord:personRecord];
-    NSString *firstName = [GRVAddressBookManager stringProperty:kABPersonFirstNameProperty
-                                                     fromRecord:personRecord];
-    NSString *lastName = [GRVAddressBookManager stringProperty:kABPersonLastNameProperty
-                                                    fromRecord:personRecord];
+    NSDate *updatedAt = contactDictionary[kGRVContactUpdatedAtKey];
+    NSString *firstName = contactDictionary[kGRVContactFirstNameKey];
+    NSString *lastName = contactDictionary[kGRVContactLastNameKey];
     
     // only perform a sync if there are any changes
     //
@@ -91,17 +125,11 @@ static NSString *const kGRVAddressBookPersonRecordIdKey = @"recordId";
           ((!firstName && !existingContact.firstName) || [firstName isEqualToString:existingContact.firstName]) &&
           ((!lastName && !existingContact.lastName) || [lastName isEqualToString:existingContact.lastName]))) {
         // set properties that will be sync'd
-        existingContact.avatarThumbnail = [GRVAddressBookManager imagePropertyFromRecord:personRecord
-                                                                             asThumbnail:YES];
         existingContact.firstName = firstName;
         existingContact.lastName = lastName;
-        existingContact.updatedAt = [GRVAddressBookManager dateProperty:kABPersonModificationDateProperty
-                                                                fromRecord:personRecord];
         
         // Update the associated phone numbers
-        NSArray *personRecordPhoneNumbers = [GRVAddressBookManager arrayProperty:kABPersonPhoneProperty
-                                                                      fromRecord:personRecord];
-        NSArray *phoneNumbers = [GRVUser usersWithPhoneNumberArray:personRecordPhoneNumbers
+        NSArray *phoneNumbers = [GRVUser usersWithPhoneNumberArray:contactDictionary[kGRVContactPhoneNumbersKey]
                                             inManagedObjectContext:existingContact.managedObjectContext];
         
         // first mark old users as unknown
@@ -124,72 +152,34 @@ static NSString *const kGRVAddressBookPersonRecordIdKey = @"recordId";
     }
 }
 
-
 /**
- * Delete GRVContact objects not in a provided array of person records.
+ * Detach users from contacts that are about to be deleted. Their phone numbers
+ * are no longer known contacts, so mark them as unknown users.
  *
- * @param peopleRecords     Array of ABPerson records
- * @param context           handle to database
+ * @param predicate     Predicate matching the GRVContacts to be deleted
+ * @param context       handle to database
  */
-+ (void)deleteContactsNotInPersonRecordArray:(CFArrayRef)peopleRecords
-                      inManagedObjectContext:(NSManagedObjectContext *)context
++ (void)fixupUsersOfContactsMatchingPredicate:(NSPredicate *)predicate
+                       inManagedObjectContext:(NSManagedObjectContext *)context
 {
-    // Get all unique identifier values from the the people records.
-    NSMutableArray *recordIds = [[NSMutableArray alloc] init];
-    CFIndex peopleRecordsCount =  CFArrayGetCount(peopleRecords);
-    
-    for (CFIndex i=0; i<peopleRecordsCount; i++) {
-        ABRecordRef personRecord = CFArrayGetValueAtIndex(peopleRecords, i);
-        NSUInteger recordId = (NSInteger)ABRecordGetRecordID(personRecord);
-        [recordIds addObject:@(recordId)];
-    }
+    // Only the contacts' object IDs are fetched, not the contacts themselves
+    NSFetchRequest *contactsRequest = [NSFetchRequest fetchRequestWithEntityName:@"GRVContact"];
+    contactsRequest.predicate = predicate;
+    contactsRequest.resultType = NSManagedObjectIDResultType;
     
-    // Create the fetch request to get all GRVContacts not matching the recordIds
-    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
-    [fetchRequest setEntity:[NSEntityDescription entityForName:@"GRVContact" inManagedObjectContext:context]];
-    [fetchRequest setPredicate:[NSPredicate predicateWithFormat:@"NOT (recordId IN %@)", recordIds]];
-    
-    // finally, execute the fetch
     NSError *error;
-    NSArray *contactsNotMatchingRecordIds = [context executeFetchRequest:fetchRequest error:&error];
+    NSArray *contactIDs = [context executeFetchRequest:contactsRequest error:&error];
+    if (![contactIDs count]) return;
     
-    // now remove all contacts that should no longer exist
-    for (GRVContact *contact in contactsNotMatchingRecordIds) {
-        // first mark associated users as unknown
-        for (GRVUser *user in contact.phoneNumbers) {
-            if ([user.relationshipType integerValue] != GRVUserRelationshipTypeMe) {
-                user.relationshipType = @(GRVUserRelationshipTypeUnknown);
-            }
-        }
-        [context deleteObject:contact];
-    }
-}
-
-
-/**
- * Given an array of ABPerson records find the one with a given recordId
- *
- * @param recordId          ABRecordID of ABPerson of intersst.
- * @param peopleRecords     ABPerson records to search through
- *
- * @return  the found ABPerson record or NULL if doesnt exit in the array of records.
- */
-+ (ABRecordRef)findPersonWithRecordId:(ABRecordID)recordId inPersonRecordArray:(CFArrayRef)peopleRecords
-{
-    ABRecordRef foundPersonRecord = NULL;
-    
-    CFIndex peopleRecordsCount =  CFArrayGetCount(peopleRecords);
-    
-    for (CFIndex i=0; i<peopleRecordsCount; i++) {
-        ABRecordRef personRecord = CFArrayGetValueAtIndex(peopleRecords, i);
-        ABRecordID personRecordId = ABRecordGetRecordID(personRecord);
-        if (personRecordId == recordId) {
-            foundPersonRecord = personRecord;
-            break;
+    NSFetchRequest *usersRequest = [NSFetchRequest fetchRequestWithEntityName:@"GRVUser"];
+    usersRequest.predicate = [NSPredicate predicateWithFormat:@"contact IN %@", contactIDs];
+    NSArray *users = [context executeFetchRequest:usersRequest error:&error];
+    for (GRVUser *user in users) {
+        if ([user.relationshipType integerValue] != GRVUserRelationshipTypeMe) {
+            user.relationshipType = @(GRVUserRelationshipTypeUnknown);
         }
+        user.contact = nil;
     }
-    
-    return foundPersonRecord;
 }
 
 
@@ -197,24 +187,21 @@ static NSString *const kGRVAddressBookPersonRecordIdKey = @"recordId";
 + (instancetype)contactWithPersonRecord:(ABRecordRef)personRecord
                  inManagedObjectContext:(NSManagedObjectContext *)context
 {
-    NSNumber *recordId = @((NSInteger)ABRecordGetRecordID(personRecord));
-    
-    // To aid with code re-use this will be packaged as a userDictionary object
-    NSDictionary *contactDictionary = @{kGRVAddressBookPersonRecordIdKey: recordId};
+    NSDictionary *contactDictionary = [GRVContact contactInfoWithPersonRecord:personRecord];
     return [GRVCoreDataImport objectWithObjectInfo:contactDictionary
                             inManagedObjectContext:context
                                           forClass:[GRVContact class]
                                      withPredicate:^NSPredicate *{
-                                         // get the user object's unique identifier
-                                         NSNumber *recordId = [contactDictionary objectForKey:kGRVAddressBookPersonRecordIdKey];
+                                         // get the contact object's unique identifier
+                                         NSNumber *recordId = [contactDictionary objectForKey:kGRVContactRecordIdKey];
                                          return [NSPredicate predicateWithFormat:@"recordId == %@", recordId];
                                          
                                      }
                                  usingCreateObject:^NSManagedObject *(NSDictionary *objectDictionary, NSManagedObjectContext *context) {
-                                     return [GRVContact newContactWithPersonRecord:personRecord inManagedObjectContext:context];
+                                     return [GRVContact newContactWithContactInfo:objectDictionary inManagedObjectContext:context];
                                      
                                  } syncObject:^(NSManagedObject *existingObject, NSDictionary *objectDictionary) {
-                                     [GRVContact syncContact:(GRVContact *)existingObject withPersonRecord:personRecord];
+                                     [GRVContact syncContact:(GRVContact *)existingObject withContactInfo:objectDictionary];
                                  }];
     
 }
@@ -222,37 +209,54 @@ static NSString *const kGRVAddressBookPersonRecordIdKey = @"recordId";
 + (NSArray *)contactsWithPersonRecordArray:(CFArrayRef)peopleRecords
                     inManagedObjectContext:(NSManagedObjectContext *)context
 {
-    // To aid with code re-use the ABPerson record Ids will be packaged as
-    // contactDictionary objects
-    NSMutableArray *contactDicts = [NSMutableArray array];
-    CFIndex peopleRecordsCount =  CFArrayGetCount(peopleRecords);
-    
-    for (CFIndex i=0; i<peopleRecordsCount; i++) {
-        ABRecordRef personRecord = CFArrayGetValueAtIndex(peopleRecords, i);
-        NSNumber *recordId = @((NSInteger)ABRecordGetRecordID(personRecord));
-        [contactDicts addObject:@{kGRVAddressBookPersonRecordIdKey : recordId}];
-    }
-    
+    return [GRVContact contactsWithContactInfoArray:[GRVContact contactInfoArrayWithPersonRecordArray:peopleRecords]
+                             inManagedObjectContext:context];
+}
+
++ (NSArray *)contactsWithContactInfoArray:(NSArray *)contactDicts
+                   inManagedObjectContext:(NSManagedObjectContext *)context
+{
     return [GRVCoreDataImport objectsWithObjectInfoArray:contactDicts
                                   inManagedObjectContext:context
                                                 forClass:[GRVContact class]
                                 usingAdditionalPredicate:nil
                                  withObjectIdentifierKey:@"recordId"
-                                    andDictIdentifierKey:kGRVAddressBookPersonRecordIdKey
+                                    andDictIdentifierKey:kGRVContactRecordIdKey
                                        usingCreateObject:^NSManagedObject *(NSDictionary *objectDictionary, NSManagedObjectContext *context) {
-                                           NSString *recordIdString = [objectDictionary objectForKey:kGRVAddressBookPersonRecordIdKey];
-                                           ABRecordID recordId = (ABRecordID)[recordIdString integerValue];
-                                           ABRecordRef personRecord = [GRVContact findPersonWithRecordId:recordId inPersonRecordArray:peopleRecords];
-                                           return [GRVContact newContactWithPersonRecord:personRecord inManagedObjectContext:context];
+                                           return [GRVContact newContactWithContactInfo:objectDictionary inManagedObjectContext:context];
                                            
                                        } syncObject:^(NSManagedObject *existingObject, NSDictionary *objectDictionary) {
-                                           NSString *recordIdString = [objectDictionary objectForKey:kGRVAddressBookPersonRecordIdKey];
-                                           ABRecordID recordId = (ABRecordID)[recordIdString integerValue];
-                                           ABRecordRef personRecord = [GRVContact findPersonWithRecordId:recordId inPersonRecordArray:peopleRecords];
-                                           [GRVContact syncContact:(GRVContact *)existingObject withPersonRecord:personRecord];
+                                           [GRVContact syncContact:(GRVContact *)existingObject withContactInfo:objectDictionary];
                                        }];
 }
 
++ (void)deleteContactsNotInContactInfoArray:(NSArray *)contactDicts
+                     inManagedObjectContext:(NSManagedObjectContext *)context
+{
+    [GRVCoreDataImport batchDeleteObjectsNotInObjectInfoArray:contactDicts
+                                       inManagedObjectContext:context
+                                                     forClass:[GRVContact class]
+                                     usingAdditionalPredicate:nil
+                                      withObjectIdentifierKey:@"recordId"
+                                         andDictIdentifierKey:kGRVContactRecordIdKey
+                                           fixupRelationships:^(NSPredicate *deletedObjectsPredicate, NSManagedObjectContext *context) {
+                                               [GRVContact fixupUsersOfContactsMatchingPredicate:deletedObjectsPredicate
+                                                                          inManagedObjectContext:context];
+                                           }];
+}
+
++ (GRVCoreDataImportStatistics *)syncContactsWithContactInfoArray:(NSArray *)contactDicts
+                                           inManagedObjectContext:(NSManagedObjectContext *)context
+{
+    // Delete contacts that no longer exist in Address Book database
+    [GRVContact deleteContactsNotInContactInfoArray:contactDicts inManagedObjectContext:context];
+    
+    // Now refresh your contacts in batches, each of which is saved and
+    // faulted out before the next.
+    return [GRVCoreDataImport importObjects:contactDicts inBatchesOfSize:kGRVCoreDataImportBatchSize inManagedObjectContext:context usingImportBatch:^NSArray *(NSArray *batch, NSManagedObjectContext *context) {
+        return [GRVContact contactsWithContactInfoArray:batch inManagedObjectContext:context];
+    }];
+}
 
 + (void)refreshContacts:(void (^)())contactsAreRefreshed
 {
@@ -294,29 +298,20 @@ static NSString *const kGRVAddressBookPersonRecordIdKey = @"recordId";
     if (workerContext) {
         [workerContext performBlock:^{
             
-            // Create an address book specific to this thread.
+            // Create an address book specific to this thread, and read its
+            // records into contact info so it can be released before syncing.
             CFErrorRef error = NULL;
             ABAddressBookRef addressBook = ABAddressBookCreateWithOptions(NULL, &error);
             CFArrayRef contactsFromAddressBook = ABAddressBookCopyArrayOfAllPeople(addressBook);
-            
-            // Delete contacts that no longer exist in Address Book database
-            [GRVContact deleteContactsNotInPersonRecordArray:contactsFromAddressBook inManagedObjectContext:workerContext];
-            
-            // Now refresh your contacts
-            [GRVContact contactsWithPersonRecordArray:contactsFromAddressBook
-                               inManagedObjectContext:workerContext];
+            NSArray *contactDicts = [GRVContact contactInfoArrayWithPersonRecordArray:contactsFromAddressBook];
             
             // Release memory
             if (contactsFromAddressBook) CFRelease(contactsFromAddressBook);
             if (addressBook) CFRelease(addressBook);
             
-            
-            // Push changes up to main thread context. Alternatively,
-            // could turn all objects into faults but this is easier.
-            [workerContext save:NULL];
-            
-            // ensure context is cleaned up for next use.
-            [workerContext reset];
+            GRVCoreDataImportStatistics *statistics = [GRVContact syncContactsWithContactInfoArray:contactDicts
+                                                                             inManagedObjectContext:workerContext];
+            [GRVCoreDataImport setLastImportStatistics:statistics forClass:[GRVContact class]];
             
             // finally execute the callback block on main queue
             dispatch_async(dispatch_get_main_queue(), ^{
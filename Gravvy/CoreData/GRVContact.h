@@ -8,13 +8,11 @@
 
 #import <Foundation/Foundation.h>
 #import <CoreData/CoreData.h>
-#import <UIKit/UIKit.h>
 
 @class GRVUser;
 
 @interface GRVContact : NSManagedObject
 
-@property (nonatomic, retain) UIImage * avatarThumbnail;
 @property (nonatomic, retain) NSString * firstName;
 @property (nonatomic, retain) NSString * lastName;
 @property (nonatomic, retain) NSNumber * recordId;
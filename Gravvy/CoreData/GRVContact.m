@@ -12,7 +12,6 @@
 
 @implementation GRVContact
 
-@dynamic avatarThumbnail;
 @dynamic firstName;
 @dynamic lastName;
 @dynamic recordId;
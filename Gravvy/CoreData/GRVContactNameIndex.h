@@ -0,0 +1,58 @@
+//
+//  GRVContactNameIndex.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/28/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * `GRVContactNameIndex` is an in-memory index of the names of users with an
+ * address book contact, for searching contacts as the user types without a
+ * Core Data fetch per keystroke.
+ *
+ * @discussion A user matches if its contact's firstName or lastName starts
+ *      with the query, or its firstName starts with the first word of the
+ *      query and its lastName starts with the last word. Matching is case and
+ *      diacritic insensitive, so "jose" finds "José".
+ *
+ *      Names are kept in two lists sorted by folded first and last name, so a
+ *      prefix is found with a binary search. A query that extends the previous
+ *      one only filters the previous results.
+ *
+ *      The index is built on first use and rebuilt after each contacts sync.
+ *      Between syncs it is updated one user at a time as users and contacts
+ *      change in the main thread context.
+ *
+ * @warning Only use this on the main thread.
+ */
+@interface GRVContactNameIndex : NSObject
+
+#pragma mark - Class Methods
+/**
+ * Single instance.
+ * It creates the instance if this hasn't been done or simply returns it.
+ *
+ * @return An initialized GRVContactNameIndex object.
+ */
++ (instancetype)sharedIndex;
+
+#pragma mark - Instance Methods
+/**
+ * Users, in the main thread context, whose contact's name matches a search
+ * query. They are sorted by +[GRVUserViewHelper userNameSortDescriptors].
+ *
+ * @param searchString  search query with leading and trailing spaces stripped.
+ *
+ * @return matching GRVUser objects, or an empty array if the query is empty.
+ */
+- (NSArray *)usersMatchingSearchString:(NSString *)searchString;
+
+/**
+ * Discard the index so it's rebuilt on next use.
+ */
+- (void)invalidate;
+
+@end
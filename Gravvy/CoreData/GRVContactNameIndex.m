@@ -0,0 +1,441 @@
+//
+//  GRVContactNameIndex.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/28/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVContactNameIndex.h"
+#import <CoreData/CoreData.h>
+#import "GRVModelManager.h"
+#import "GRVUser.h"
+#import "GRVContact.h"
+#import "GRVUserViewHelper.h"
+#import "GRVConstants.h"
+
+#pragma mark - Constants
+/**
+ * Most number of changed users updated one at a time. Beyond this, as when
+ * a sync is merged, it's cheaper to rebuild the index.
+ */
+static const NSUInteger kGRVContactNameIndexMaxIncrementalUpdates = 100;
+
+/**
+ * Fold a name or query for matching: lowercased and without diacritics.
+ */
+static NSString *GRVFoldedName(NSString *name)
+{
+    if (![name length]) return @"";
+    return [name stringByFoldingWithOptions:(NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch)
+                                     locale:nil];
+}
+
+/**
+ * Compare strings the way a fetch request's sort descriptor does, with nil
+ * first.
+ */
+static NSComparisonResult GRVCompareNames(NSString *name1, NSString *name2)
+{
+    if (name1 == name2) return NSOrderedSame;
+    if (!name1) return NSOrderedAscending;
+    if (!name2) return NSOrderedDescending;
+    return [name1 compare:name2];
+}
+
+
+/**
+ * An indexed user with its folded contact names, and the attributes it's
+ * sorted by in search results.
+ */
+@interface GRVContactNameIndexEntry : NSObject
+
+@property (strong, nonatomic) GRVUser *user;
+@property (copy, nonatomic) NSString *firstNameKey;
+@property (copy, nonatomic) NSString *lastNameKey;
+
+@property (nonatomic) NSInteger relationshipType;
+@property (copy, nonatomic) NSString *firstName;
+@property (copy, nonatomic) NSString *lastName;
+@property (copy, nonatomic) NSString *fullName;
+
+@end
+
+@implementation GRVContactNameIndexEntry
+
++ (instancetype)entryWithUser:(GRVUser *)user
+{
+    GRVContactNameIndexEntry *entry = [[GRVContactNameIndexEntry alloc] init];
+    entry.user = user;
+    entry.firstName = user.contact.firstName;
+    entry.lastName = user.contact.lastName;
+    entry.fullName = user.fullName;
+    entry.relationshipType = [user.relationshipType integerValue];
+    entry.firstNameKey = GRVFoldedName(entry.firstName);
+    entry.lastNameKey = GRVFoldedName(entry.lastName);
+    return entry;
+}
+
+/**
+ * Does the entry match a folded query and its words? This is the name search
+ * predicate.
+ */
+- (BOOL)matchesQuery:(NSString *)query firstWord:(NSString *)firstWord lastWord:(NSString *)lastWord
+{
+    return ([self.firstNameKey hasPrefix:query] ||
+            [self.lastNameKey hasPrefix:query] ||
+            ([self.firstNameKey hasPrefix:firstWord] && [self.lastNameKey hasPrefix:lastWord]));
+}
+
+/**
+ * Order of entries in search results, as in +[GRVUserViewHelper userNameSortDescriptors]
+ */
+- (NSComparisonResult)compareForResults:(GRVContactNameIndexEntry *)otherEntry
+{
+    if (self.relationshipType != otherEntry.relationshipType) {
+        return (self.relationshipType > otherEntry.relationshipType) ? NSOrderedAscending : NSOrderedDescending;
+    }
+    NSComparisonResult result = GRVCompareNames(self.firstName, otherEntry.firstName);
+    if (result == NSOrderedSame) result = GRVCompareNames(self.lastName, otherEntry.lastName);
+    if (result == NSOrderedSame) result = GRVCompareNames(self.fullName, otherEntry.fullName);
+    return result;
+}
+
+@end
+
+
+@interface GRVContactNameIndex ()
+
+/**
+ * Entries keyed by user object ID, and the same entries sorted by folded first
+ * name and by folded last name.
+ */
+@property (strong, nonatomic) NSMutableDictionary *entries;
+@property (strong, nonatomic) NSMutableArray *entriesByFirstName;
+@property (strong, nonatomic) NSMutableArray *entriesByLastName;
+
+/**
+ * Context the index was built from. Changes to objects in this context, and no
+ * other, are observed.
+ */
+@property (strong, nonatomic) NSManagedObjectContext *managedObjectContext;
+
+/**
+ * Context the index is always built from, or nil to build it from the model
+ * manager's main thread context.
+ */
+@property (strong, nonatomic) NSManagedObjectContext *sourceManagedObjectContext;
+
+/**
+ * Previous folded query and its matching entries, in results order, which a
+ * longer query can refine.
+ */
+@property (copy, nonatomic) NSString *previousQuery;
+@property (strong, nonatomic) NSArray *previousResults;
+
+@end
+
+@implementation GRVContactNameIndex
+
+#pragma mark - Properties
+- (void)setManagedObjectContext:(NSManagedObjectContext *)managedObjectContext
+{
+    if (managedObjectContext == _managedObjectContext) return;
+    
+    // Only observe the main thread context, so changes made in background
+    // contexts are never posted to this index on their threads.
+    NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+    if (_managedObjectContext) {
+        [notificationCenter removeObserver:self
+                                      name:NSManagedObjectContextObjectsDidChangeNotification
+                                    object:_managedObjectContext];
+    }
+    
+    _managedObjectContext = managedObjectContext;
+    
+    if (managedObjectContext) {
+        [notificationCenter addObserver:self
+                               selector:@selector(managedObjectContextObjectsDidChange:)
+                                   name:NSManagedObjectContextObjectsDidChangeNotification
+                                 object:managedObjectContext];
+    }
+}
+
+
+#pragma mark - Class Methods
++ (instancetype)sharedIndex
+{
+    static GRVContactNameIndex *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[self alloc] initPrivate];
+    });
+    return sharedInstance;
+}
+
+/**
+ * Entries sorted by a folded name key: `firstNameKey` or `lastNameKey`.
+ */
++ (NSComparator)comparatorForKey:(NSString *)key
+{
+    return ^NSComparisonResult(GRVContactNameIndexEntry *entry1, GRVContactNameIndexEntry *entry2) {
+        return [[entry1 valueForKey:key] compare:[entry2 valueForKey:key] options:NSLiteralSearch];
+    };
+}
+
+
+#pragma mark - Initializers
+/*
+ * ideally we would make the designated initializer of the superclass call
+ *   the new designated initializer, but that doesn't make sense in this case.
+ * if a programmer calls [GRVContactNameIndex alloc] init], let him know the
+ *   error of his ways.
+ */
+- (instancetype)init
+{
+    @throw [NSException exceptionWithName:@"Singleton"
+                                   reason:@"Use +[GRVContactNameIndex sharedIndex]"
+                                 userInfo:nil];
+    return nil;
+}
+
+// here is the real (secret) initializer
+// this is the official designated initializer so call the designated
+// initializer of the superclass
+- (instancetype)initPrivate
+{
+    self = [super init];
+    if (self) {
+        NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+        [notificationCenter addObserver:self
+                               selector:@selector(contactsRefreshed:)
+                                   name:kGRVContactsRefreshedNotification
+                                 object:nil];
+        [notificationCenter addObserver:self
+                               selector:@selector(invalidate)
+                                   name:kGRVMOCAvailableNotification
+                                 object:nil];
+        [notificationCenter addObserver:self
+                               selector:@selector(invalidate)
+                                   name:kGRVMOCDeletedNotification
+                                 object:nil];
+    }
+    return self;
+}
+
+/**
+ * Create an index of the users in a given context rather than the model
+ * manager's, such as a scratch store in tests.
+ *
+ * @param managedObjectContext  context to build the index from. It must only
+ *      be used on the same thread as the index.
+ */
+- (instancetype)initWithManagedObjectContext:(NSManagedObjectContext *)managedObjectContext
+{
+    self = [self initPrivate];
+    if (self) {
+        _sourceManagedObjectContext = managedObjectContext;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+
+#pragma mark - Instance Methods
+#pragma mark Private
+/**
+ * Build the index from all users with a contact, if it isn't built.
+ */
+- (void)buildIfNeeded
+{
+    NSManagedObjectContext *managedObjectContext = self.sourceManagedObjectContext ?: [GRVModelManager sharedManager].managedObjectContext;
+    if (self.entries && (self.managedObjectContext == managedObjectContext)) return;
+
+    [self invalidate];
+    if (!managedObjectContext) return;
+
+    NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:@"GRVUser"];
+    request.predicate = [NSPredicate predicateWithFormat:@"contact != nil"];
+    request.relationshipKeyPathsForPrefetching = @[@"contact"];
+    NSArray *users = [managedObjectContext executeFetchRequest:request error:NULL];
+
+    NSMutableDictionary *entries = [NSMutableDictionary dictionaryWithCapacity:[users count]];
+    for (GRVUser *user in users) {
+        entries[user.objectID] = [GRVContactNameIndexEntry entryWithUser:user];
+    }
+
+    NSArray *allEntries = [entries allValues];
+    self.entriesByFirstName = [[allEntries sortedArrayUsingComparator:[GRVContactNameIndex comparatorForKey:@"firstNameKey"]] mutableCopy];
+    self.entriesByLastName = [[allEntries sortedArrayUsingComparator:[GRVContactNameIndex comparatorForKey:@"lastNameKey"]] mutableCopy];
+    self.entries = entries;
+    self.managedObjectContext = managedObjectContext;
+}
+
+/**
+ * Insert an entry into a list sorted by a name key.
+ */
+- (void)insertEntry:(GRVContactNameIndexEntry *)entry intoEntries:(NSMutableArray *)sortedEntries sortedByKey:(NSString *)key
+{
+    NSUInteger index = [sortedEntries indexOfObject:entry
+                                      inSortedRange:NSMakeRange(0, [sortedEntries count])
+                                            options:NSBinarySearchingInsertionIndex
+                                    usingComparator:[GRVContactNameIndex comparatorForKey:key]];
+    [sortedEntries insertObject:entry atIndex:index];
+}
+
+/**
+ * Update the entry of a user that was inserted, changed or deleted.
+ */
+- (void)updateUser:(GRVUser *)user
+{
+    GRVContactNameIndexEntry *oldEntry = self.entries[user.objectID];
+    if (oldEntry) {
+        [self.entries removeObjectForKey:user.objectID];
+        [self.entriesByFirstName removeObjectIdenticalTo:oldEntry];
+        [self.entriesByLastName removeObjectIdenticalTo:oldEntry];
+    }
+
+    if (!user.isDeleted && user.managedObjectContext && user.contact && !user.contact.isDeleted) {
+        GRVContactNameIndexEntry *entry = [GRVContactNameIndexEntry entryWithUser:user];
+        self.entries[user.objectID] = entry;
+        [self insertEntry:entry intoEntries:self.entriesByFirstName sortedByKey:@"firstNameKey"];
+        [self insertEntry:entry intoEntries:self.entriesByLastName sortedByKey:@"lastNameKey"];
+    }
+}
+
+/**
+ * Entries whose name key starts with a prefix.
+ *
+ * @param prefix            folded prefix
+ * @param sortedEntries     entries sorted by the name key
+ * @param key               `firstNameKey` or `lastNameKey`
+ */
+- (NSArray *)entriesWithPrefix:(NSString *)prefix inEntries:(NSArray *)sortedEntries sortedByKey:(NSString *)key
+{
+    // Strings with a common prefix are contiguous in literal order, starting
+    // where the prefix itself would be inserted.
+    NSUInteger start = [sortedEntries indexOfObject:prefix
+                                      inSortedRange:NSMakeRange(0, [sortedEntries count])
+                                            options:NSBinarySearchingInsertionIndex | NSBinarySearchingFirstEqual
+                                    usingComparator:^NSComparisonResult(id obj1, id obj2) {
+                                        NSString *name1 = [obj1 isKindOfClass:[NSString class]] ? obj1 : [obj1 valueForKey:key];
+                                        NSString *name2 = [obj2 isKindOfClass:[NSString class]] ? obj2 : [obj2 valueForKey:key];
+                                        return [name1 compare:name2 options:NSLiteralSearch];
+                                    }];
+
+    NSUInteger end = start;
+    while ((end < [sortedEntries count]) && [[sortedEntries[end] valueForKey:key] hasPrefix:prefix]) {
+        end++;
+    }
+    return [sortedEntries subarrayWithRange:NSMakeRange(start, end - start)];
+}
+
+/**
+ * Search the whole index for a folded query.
+ */
+- (NSArray *)entriesMatchingQuery:(NSString *)query firstWord:(NSString *)firstWord lastWord:(NSString *)lastWord
+{
+    NSMutableSet *matches = [NSMutableSet set];
+    [matches addObjectsFromArray:[self entriesWithPrefix:query inEntries:self.entriesByFirstName sortedByKey:@"firstNameKey"]];
+    [matches addObjectsFromArray:[self entriesWithPrefix:query inEntries:self.entriesByLastName sortedByKey:@"lastNameKey"]];
+    if (![firstWord isEqualToString:query]) {
+        for (GRVContactNameIndexEntry *entry in [self entriesWithPrefix:firstWord inEntries:self.entriesByFirstName sortedByKey:@"firstNameKey"]) {
+            if ([entry.lastNameKey hasPrefix:lastWord]) [matches addObject:entry];
+        }
+    }
+    return [[matches allObjects] sortedArrayUsingSelector:@selector(compareForResults:)];
+}
+
+#pragma mark Public
+- (NSArray *)usersMatchingSearchString:(NSString *)searchString
+{
+    NSString *query = GRVFoldedName(searchString);
+    if (![query length]) return @[];
+
+    [self buildIfNeeded];
+    if (!self.entries) return @[];
+
+    NSArray *words = [query componentsSeparatedByString:@" "];
+    NSString *firstWord = [words firstObject];
+    NSString *lastWord = [words lastObject];
+
+    // A query that extends the previous one matches a subset of its results,
+    // unless it adds a word to a multi-word query: the last word then changes
+    // instead of growing.
+    NSArray *matchingEntries = nil;
+    NSUInteger previousWordsCount = [[self.previousQuery componentsSeparatedByString:@" "] count];
+    if (self.previousQuery && [query hasPrefix:self.previousQuery] &&
+        ((previousWordsCount == 1) || (previousWordsCount == [words count]))) {
+        NSMutableArray *refinedEntries = [NSMutableArray arrayWithCapacity:[self.previousResults count]];
+        for (GRVContactNameIndexEntry *entry in self.previousResults) {
+            if ([entry matchesQuery:query firstWord:firstWord lastWord:lastWord]) [refinedEntries addObject:entry];
+        }
+        matchingEntries = refinedEntries;
+    } else {
+        matchingEntries = [self entriesMatchingQuery:query firstWord:firstWord lastWord:lastWord];
+    }
+
+    self.previousQuery = query;
+    self.previousResults = matchingEntries;
+    return [matchingEntries valueForKey:@"user"];
+}
+
+- (void)invalidate
+{
+    self.entries = nil;
+    self.entriesByFirstName = nil;
+    self.entriesByLastName = nil;
+    self.managedObjectContext = nil;
+    self.previousQuery = nil;
+    self.previousResults = nil;
+}
+
+
+#pragma mark - Notification Observer Methods
+/**
+ * A contacts sync changes many contacts, so rebuild the index now rather than
+ * on the next keystroke.
+ */
+- (void)contactsRefreshed:(NSNotification *)aNotification
+{
+    [self invalidate];
+    [self buildIfNeeded];
+}
+
+/**
+ * Keep the index in sync with changes to users and contacts in the main
+ * thread context.
+ */
+- (void)managedObjectContextObjectsDidChange:(NSNotification *)aNotification
+{
+    if (!self.entries) return;
+
+    NSMutableSet *changedUsers = [NSMutableSet set];
+    for (NSString *key in @[NSInsertedObjectsKey, NSUpdatedObjectsKey, NSDeletedObjectsKey, NSRefreshedObjectsKey]) {
+        for (NSManagedObject *object in aNotification.userInfo[key]) {
+            if ([object isKindOfClass:[GRVUser class]]) {
+                [changedUsers addObject:object];
+            } else if ([object isKindOfClass:[GRVContact class]]) {
+                [changedUsers unionSet:((GRVContact *)object).phoneNumbers];
+            }
+        }
+    }
+    if (![changedUsers count]) return;
+
+    if ([changedUsers count] > kGRVContactNameIndexMaxIncrementalUpdates) {
+        [self invalidate];
+        return;
+    }
+
+    for (GRVUser *user in changedUsers) {
+        [self updateUser:user];
+    }
+    self.previousQuery = nil;
+    self.previousResults = nil;
+}
+
+@end
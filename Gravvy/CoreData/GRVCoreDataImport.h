@@ -9,6 +9,53 @@
 #import <Foundation/Foundation.h>
 #import <CoreData/CoreData.h>
 
+/**
+ * GRVCoreDataImportStatistics holds measurements of a batched import.
+ */
+@interface GRVCoreDataImportStatistics : NSObject
+
+/**
+ * Number of objects handed to the import and number of batches they were
+ * imported in.
+ */
+@property (nonatomic, readonly) NSUInteger objectsCount;
+@property (nonatomic, readonly) NSUInteger batchesCount;
+
+/**
+ * Time, in seconds, taken by each batch (as NSNumbers, in batch order) and by
+ * the entire import. Batch times include the save.
+ */
+@property (strong, nonatomic, readonly) NSArray *batchTimes;
+@property (nonatomic, readonly) NSTimeInterval totalTime;
+
+/**
+ * Highest resident memory size, in bytes, of the app observed after a batch.
+ */
+@property (nonatomic, readonly) NSUInteger peakResidentMemory;
+
+/**
+ * Permanent object IDs of the managed objects returned by each batch, in
+ * batch order. Use these to get at imported objects after the context's reset.
+ */
+@property (strong, nonatomic, readonly) NSArray *importedObjectIDs;
+
+/**
+ * Number of existing objects whose JSON fingerprint was checked during the
+ * import, and how many of those were skipped because their fingerprint was
+ * unchanged. These include related objects synced by the import.
+ */
+@property (nonatomic, readonly) NSUInteger fingerprintedObjectsCount;
+@property (nonatomic, readonly) NSUInteger skippedObjectsCount;
+
+/**
+ * Fraction of fingerprinted objects that were skipped, 0.0 if none were
+ * fingerprinted.
+ */
+@property (nonatomic, readonly) double skipRatio;
+
+@end
+
+
 /**
  * This class provides shared methods used when importing JSON data from
  * the HTTP web server into Core Data.
@@ -18,9 +65,55 @@
  * This follows apple's guidelines found here:
  * https://developer.apple.com/library/ios/documentation/Cocoa/Conceptual/CoreData/Articles/cdImporting.html
  *
+ * String identifiers are matched case-insensitively. Rather than using
+ * case-insensitive predicates, which can't use an attribute's index, managed
+ * objects keep their string identifiers in canonical form (see
+ * canonicalIdentifier:) in an indexed attribute, and it's that attribute's key
+ * that should be passed in as the object identifier key.
+ *
+ * Entities with a `fingerprint` string attribute can skip syncing records the
+ * server hasn't changed: store fingerprintForObjectInfo: of the JSON an object
+ * was last synced with, and check it with isUnchangedObject:withFingerprint:
+ * before syncing again.
  */
 @interface GRVCoreDataImport : NSObject
 
+#pragma mark - Identifiers
+/**
+ * Canonical form of a string identifier, used for exact-match lookups.
+ *
+ * @param identifier
+ *      Identifier as received from the server or address book. Non-string
+ *      values are converted using their description.
+ *
+ * @return lower-cased identifier, or nil if identifier is nil.
+ */
++ (NSString *)canonicalIdentifier:(id)identifier;
+
+#pragma mark - Fingerprints
+/**
+ * Fingerprint of a JSON object: a hash of its canonical serialization, where
+ * dictionary keys are sorted. So equal JSON objects have equal fingerprints
+ * regardless of the key order the server used.
+ *
+ * @param objectInfo    JSON object, typically a dictionary from the server.
+ *
+ * @return hex-encoded SHA-1 of the canonical serialization.
+ */
++ (NSString *)fingerprintForObjectInfo:(id)objectInfo;
+
+/**
+ * Determine if a managed object was last synced with a JSON object of a given
+ * fingerprint, in which case there's nothing to sync. The check is counted in
+ * the statistics of the batched import in progress, if any.
+ *
+ * @param managedObject     Managed object with a `fingerprint` attribute
+ * @param fingerprint       Fingerprint of the JSON object to be synced
+ *
+ * @return YES if the managed object's fingerprint matches.
+ */
++ (BOOL)isUnchangedObject:(NSManagedObject *)managedObject withFingerprint:(NSString *)fingerprint;
+
 #pragma mark - Create
 /**
  * Find-or-Create an NSManagedObject
@@ -81,7 +174,8 @@
  *      JSON objects. This block takes no arguments.
  * @param objectIdentifierKey
  *      String representation of property of an objectClass instance that serves
- *      as its unique object identifier.
+ *      as its unique object identifier. String identifiers must be stored in
+ *      canonical form.
  *      This serves same purpose as `dictIdentiferKey` for each object dictionary.
  * @param dictIdentifierKey
  *     Key of JSON dictionary object with a corresponding value that serves as
@@ -122,6 +216,80 @@
                                                   NSDictionary *objectDictionary))syncObjectWithObjectInfo;
 
 
+#pragma mark - Batched Import
+/**
+ * Import a collection of objects in batches, to bound memory use.
+ *
+ * Each batch is imported in its own autorelease pool, then the context is
+ * saved and reset so the batch's managed objects are released before the next
+ * batch. Any changes already in the context go out with the first batch's save.
+ *
+ * @param objects
+ *      Objects to be imported, typically JSON object dictionaries.
+ * @param batchSize
+ *      Maximum number of objects per batch. 0 means a single batch.
+ * @param context
+ *      Handle to database. This is reset after each batch so shouldn't hold
+ *      managed objects the caller still needs.
+ * @param importBatch
+ *      A block object to be executed for each batch. This block returns the
+ *      managed objects it imported, or nil, and takes two arguments:
+ *          - the batch of objects to be imported
+ *          - the database handle
+ *
+ * @return Measurements of the import, which also hold the object IDs of the
+ *      imported objects.
+ *
+ * @warning Call this from the context's queue.
+ */
++ (GRVCoreDataImportStatistics *)importObjects:(NSArray *)objects
+                               inBatchesOfSize:(NSUInteger)batchSize
+                        inManagedObjectContext:(NSManagedObjectContext *)context
+                              usingImportBatch:(NSArray *(^)(NSArray *batch,
+                                                             NSManagedObjectContext *context))importBatch;
+
+/**
+ * Import objects from an enumerator in batches, to bound memory use. Only a
+ * batch of objects is pulled from the enumerator at a time, so with an
+ * enumerator that creates its objects as they're enumerated (such as a
+ * GRVJSONListReader) the full collection never exists at once.
+ *
+ * @param objects
+ *      Enumerator of objects to be imported, typically JSON object dictionaries.
+ * @param batchSize, context, importBatch
+ *      Same as in importObjects:inBatchesOfSize:inManagedObjectContext:usingImportBatch:
+ *
+ * @return Measurements of the import, which also hold the object IDs of the
+ *      imported objects.
+ *
+ * @warning Call this from the context's queue.
+ */
++ (GRVCoreDataImportStatistics *)importObjectsFromEnumerator:(NSEnumerator *)objects
+                                             inBatchesOfSize:(NSUInteger)batchSize
+                                      inManagedObjectContext:(NSManagedObjectContext *)context
+                                            usingImportBatch:(NSArray *(^)(NSArray *batch,
+                                                                           NSManagedObjectContext *context))importBatch;
+
+/**
+ * Measurements of the most recent batched import of a class of managed objects.
+ *
+ * @param objectClass
+ *      SubClass of NSManagedObject that was imported, as identified by the
+ *      caller of `importObjects:inBatchesOfSize:inManagedObjectContext:usingImportBatch:`
+ *
+ * @return statistics of the last import or nil if there hasn't been one.
+ */
++ (GRVCoreDataImportStatistics *)lastImportStatisticsForClass:(Class)objectClass;
+
+/**
+ * Record measurements of a batched import of a class of managed objects.
+ *
+ * @param statistics    Measurements of the import
+ * @param objectClass   SubClass of NSManagedObject that was imported
+ */
++ (void)setLastImportStatistics:(GRVCoreDataImportStatistics *)statistics forClass:(Class)objectClass;
+
+
 #pragma mark - Delete
 /**
  * Delete NSManagedObjects not in a provided array of JSON data objects.
@@ -139,7 +307,8 @@
  *      of provided JSON objects. This block takes no arguments.
  * @param objectIdentifierKey
  *      String representation of property of an objectClass instance that serves
- *      as its unique object identifier.
+ *      as its unique object identifier. String identifiers must be stored in
+ *      canonical form.
  *      This serves same purpose as `dictIdentiferKey` for each object dictionary.
  * @param dictIdentifierKey
  *     Key of JSON dictionary object with a corresponding value that serves as
@@ -154,4 +323,40 @@
                   withObjectIdentifierKey:(NSString *)objectIdentifierKey
                      andDictIdentifierKey:(NSString *)dictIdentifierKey;
 
+/**
+ * Delete NSManagedObjects not in a provided array of JSON data objects, in the
+ * persistent store, without fetching them into memory.
+ *
+ * The deleted object IDs are merged into the given context and the
+ * GRVModelManager contexts. Falls back to deleting objects one at a time when
+ * batch deletes aren't available (before iOS 9) or the context has a parent
+ * context.
+ *
+ * @discussion A batch delete doesn't apply the model's delete rules or maintain
+ *      inverse relationships. So don't use this on entities with cascading
+ *      relationships. Use the fixupRelationships block to clear related
+ *      objects' references to the deleted objects and any state derived from
+ *      them.
+ *
+ * @param objectDicts, context, objectClass, additionalPredicate,
+ *      objectIdentifierKey, dictIdentifierKey
+ *      Same as in deleteObjectsNotInObjectInfoArray:inManagedObjectContext:forClass:usingAdditionalPredicate:withObjectIdentifierKey:andDictIdentifierKey:
+ * @param fixupRelationships
+ *      A block object to be executed before the delete. This block has no
+ *      return value and takes two arguments:
+ *          - predicate matching the objectClass instances to be deleted
+ *          - the database handle
+ *      Changes it makes are saved before the delete runs.
+ *
+ * @warning Call this from the context's queue.
+ */
++ (void)batchDeleteObjectsNotInObjectInfoArray:(NSArray *)objectDicts
+                        inManagedObjectContext:(NSManagedObjectContext *)context
+                                      forClass:(Class)objectClass
+                      usingAdditionalPredicate:(NSPredicate *(^)())additionalPredicate
+                       withObjectIdentifierKey:(NSString *)objectIdentifierKey
+                          andDictIdentifierKey:(NSString *)dictIdentifierKey
+                            fixupRelationships:(void (^)(NSPredicate *deletedObjectsPredicate,
+                                                         NSManagedObjectContext *context))fixupRelationships;
+
 @end
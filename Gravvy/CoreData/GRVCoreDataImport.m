@@ -7,9 +7,135 @@
 //
 
 #import "GRVCoreDataImport.h"
+#import "GRVModelManager.h"
+#import "GRVMemoryUtils.h"
+#import <CommonCrypto/CommonDigest.h>
+
+/**
+ * Key of the statistics of the batched import in progress in the importing
+ * thread's dictionary.
+ */
+static NSString *const kCurrentImportStatisticsKey = @"GRVCoreDataImportCurrentStatistics";
+
+@interface GRVCoreDataImportStatistics ()
+
+// redefine measurements as readwrite
+@property (nonatomic, readwrite) NSUInteger objectsCount;
+@property (strong, nonatomic, readwrite) NSArray *batchTimes;
+@property (nonatomic, readwrite) NSTimeInterval totalTime;
+@property (nonatomic, readwrite) NSUInteger peakResidentMemory;
+@property (strong, nonatomic, readwrite) NSArray *importedObjectIDs;
+@property (nonatomic, readwrite) NSUInteger fingerprintedObjectsCount;
+@property (nonatomic, readwrite) NSUInteger skippedObjectsCount;
+
+@end
+
+@implementation GRVCoreDataImportStatistics
+
+- (NSUInteger)batchesCount
+{
+    return [self.batchTimes count];
+}
+
+- (double)skipRatio
+{
+    if (!self.fingerprintedObjectsCount) return 0.0;
+    return (double)self.skippedObjectsCount / self.fingerprintedObjectsCount;
+}
+
+- (NSString *)description
+{
+    NSMutableArray *batchTimesMs = [NSMutableArray arrayWithCapacity:[self.batchTimes count]];
+    for (NSNumber *batchTime in self.batchTimes) {
+        [batchTimesMs addObject:[NSString stringWithFormat:@"%.1f", [batchTime doubleValue] * 1000.0]];
+    }
+    return [NSString stringWithFormat:@"import: %lu objects in %lu batches (%@ms), total %.1fms, peak memory %.1fmb, skipped %lu/%lu unchanged (%.0f%%)",
+            (unsigned long)self.objectsCount, (unsigned long)self.batchesCount,
+            [batchTimesMs componentsJoinedByString:@", "], self.totalTime * 1000.0,
+            self.peakResidentMemory / (1024.0 * 1024.0),
+            (unsigned long)self.skippedObjectsCount, (unsigned long)self.fingerprintedObjectsCount,
+            self.skipRatio * 100.0];
+}
+
+@end
+
 
 @implementation GRVCoreDataImport
 
+#pragma mark - Identifiers
++ (NSString *)canonicalIdentifier:(id)identifier
+{
+    if (!identifier) return nil;
+    return [[identifier description] lowercaseString];
+}
+
+
+#pragma mark - Fingerprints
+
+/**
+ * Append the canonical serialization of a JSON value to a string. Strings are
+ * length-prefixed and every value is type-tagged so distinct JSON objects
+ * can't serialize the same.
+ */
++ (void)appendCanonicalObjectInfo:(id)objectInfo toString:(NSMutableString *)serialization
+{
+    if ([objectInfo isKindOfClass:[NSDictionary class]]) {
+        NSArray *sortedKeys = [[objectInfo allKeys] sortedArrayUsingSelector:@selector(compare:)];
+        [serialization appendString:@"{"];
+        for (id key in sortedKeys) {
+            [GRVCoreDataImport appendCanonicalObjectInfo:key toString:serialization];
+            [GRVCoreDataImport appendCanonicalObjectInfo:[objectInfo objectForKey:key] toString:serialization];
+        }
+        [serialization appendString:@"}"];
+        
+    } else if ([objectInfo isKindOfClass:[NSArray class]]) {
+        [serialization appendString:@"["];
+        for (id value in objectInfo) {
+            [GRVCoreDataImport appendCanonicalObjectInfo:value toString:serialization];
+        }
+        [serialization appendString:@"]"];
+        
+    } else if ([objectInfo isKindOfClass:[NSString class]]) {
+        [serialization appendFormat:@"s%lu:%@", (unsigned long)[objectInfo length], objectInfo];
+        
+    } else if ([objectInfo isKindOfClass:[NSNumber class]]) {
+        [serialization appendFormat:@"n%@;", [objectInfo stringValue]];
+        
+    } else {
+        // NSNull
+        [serialization appendString:@"z"];
+    }
+}
+
++ (NSString *)fingerprintForObjectInfo:(id)objectInfo
+{
+    NSMutableString *serialization = [NSMutableString string];
+    [GRVCoreDataImport appendCanonicalObjectInfo:objectInfo toString:serialization];
+    
+    NSData *data = [serialization dataUsingEncoding:NSUTF8StringEncoding];
+    unsigned char digest[CC_SHA1_DIGEST_LENGTH];
+    CC_SHA1([data bytes], (CC_LONG)[data length], digest);
+    
+    NSMutableString *fingerprint = [NSMutableString stringWithCapacity:CC_SHA1_DIGEST_LENGTH * 2];
+    for (NSUInteger i = 0; i < CC_SHA1_DIGEST_LENGTH; i++) {
+        [fingerprint appendFormat:@"%02x", digest[i]];
+    }
+    return fingerprint;
+}
+
++ (BOOL)isUnchangedObject:(NSManagedObject *)managedObject withFingerprint:(NSString *)fingerprint
+{
+    NSString *lastFingerprint = [managedObject valueForKey:@"fingerprint"];
+    BOOL unchanged = (fingerprint && [lastFingerprint isEqualToString:fingerprint]);
+    
+    GRVCoreDataImportStatistics *statistics = [[NSThread currentThread].threadDictionary objectForKey:kCurrentImportStatisticsKey];
+    statistics.fingerprintedObjectsCount++;
+    if (unchanged) statistics.skippedObjectsCount++;
+    
+    return unchanged;
+}
+
+
 #pragma mark - Create
 
 + (id)objectWithObjectInfo:(NSDictionary *)objectDictionary
@@ -82,18 +208,15 @@
     // The goal is to optimize how I find existing data by reducing, to a minimum,
     // the number of fetches I execute.
     
-    // Note the use of localizedCompare: in both sort descriptors in this
-    // method. This is important as without it we get outputs like
-    //      sort("nce", "nce2")         -> ["nce",     "nce2"]
-    //      sort("nce@lo", "nce2@lo"]   -> ["nce2@lo", "nce@lo"]
-    // AND
+    // Note that string identifiers are compared in canonical form on both
+    // sides, and sorted with a plain compare:, which is the same binary order
+    // the SQLite store sorts with. Mixing case-sensitivity or collations between
+    // the two sorts gives outputs like
     //      sort("nce.l", "nce2.l")     -> ["nce.l",    "nce2.l"]
     //      sort("ncE.l", "nCE2.l"]     -> ["nCE2.l",   "ncE.l"]
     //
-    // In this example, both sort pairs are mismatched.
-    // This of course breaks the basic rule of the algorithm below that both arrays
-    // have same sort. This is why it's important to specify localizedCompare:
-    // when sorting the passed in list of JSON dictionary objects.
+    // which breaks the basic rule of the algorithm below that both arrays
+    // have same sort.
     
     // Before starting, let's ensure all object dictionary identifier values meet
     // the two requirements:
@@ -124,7 +247,9 @@
     // First, get the object dictionaries to parse in sorted order (by unique
     // identifier, dictIdentifierKey)
     if (objectIdentifierIsString) {
-        objectDicts = [objectDicts sortedArrayUsingDescriptors:@[[[NSSortDescriptor alloc] initWithKey:dictIdentifierKey ascending:YES selector:@selector(localizedCaseInsensitiveCompare:)]]];
+        objectDicts = [objectDicts sortedArrayUsingDescriptors:@[[[NSSortDescriptor alloc] initWithKey:dictIdentifierKey ascending:YES comparator:^NSComparisonResult(id obj1, id obj2) {
+            return [[GRVCoreDataImport canonicalIdentifier:obj1] compare:[GRVCoreDataImport canonicalIdentifier:obj2]];
+        }]]];
     } else {
         objectDicts = [objectDicts sortedArrayUsingDescriptors:@[[[NSSortDescriptor alloc] initWithKey:dictIdentifierKey ascending:YES comparator:^NSComparisonResult(id obj1, id obj2) {
             if ([obj1 integerValue] > [obj2 integerValue]) {
@@ -143,6 +268,7 @@
     NSMutableArray *objectIdentifiers = [[NSMutableArray alloc] init];
     for (NSDictionary *objectDictionary in objectDictionaries) {
         id objectIdentifier = [objectDictionary objectForKey:dictIdentifierKey];
+        if (objectIdentifierIsString) objectIdentifier = [GRVCoreDataImport canonicalIdentifier:objectIdentifier];
         [objectIdentifiers addObject:objectIdentifier];
     }
     
@@ -155,13 +281,9 @@
     NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
     [fetchRequest setEntity:[NSEntityDescription entityForName:NSStringFromClass(objectClass) inManagedObjectContext:context]];
     
-    // Create the base predicate first
-    NSPredicate *basePredicate = nil;
-    if (objectIdentifierIsString) {
-        basePredicate = [NSPredicate predicateWithFormat:@"%K IN[c] %@", objectIdentifierKey, objectIdentifiers];
-    } else {
-        basePredicate = [NSPredicate predicateWithFormat:@"%K IN %@", objectIdentifierKey, objectIdentifiers];
-    }
+    // Create the base predicate first. String identifiers are already in
+    // canonical form so this is an exact match that can use the index.
+    NSPredicate *basePredicate = [NSPredicate predicateWithFormat:@"%K IN %@", objectIdentifierKey, objectIdentifiers];
     
     if (additionalPredicate) {
         NSPredicate *addedPredicate = additionalPredicate();
@@ -172,12 +294,7 @@
     
     // make sure the fetch request results are sorted as well with the same sort
     // algo as the object dictionaries
-    NSSortDescriptor *fetchSortDescriptor = nil;
-    if (objectIdentifierIsString) {
-        fetchSortDescriptor = [[NSSortDescriptor alloc] initWithKey:objectIdentifierKey ascending:YES selector:@selector(localizedCaseInsensitiveCompare:)];
-    } else {
-        fetchSortDescriptor = [[NSSortDescriptor alloc] initWithKey:objectIdentifierKey ascending:YES];
-    }
+    NSSortDescriptor *fetchSortDescriptor = [[NSSortDescriptor alloc] initWithKey:objectIdentifierKey ascending:YES];
     
     [fetchRequest setSortDescriptors:@[fetchSortDescriptor]];
     
@@ -244,7 +361,7 @@
                 updateCurrentManagedObject = [((NSNumber *)managedObjectIdentifier) integerValue] == [dictObjectIdentifier integerValue];
                 
             } else if ([managedObjectIdentifier isKindOfClass:[NSString class]]) {
-                updateCurrentManagedObject = [((NSString *)managedObjectIdentifier) caseInsensitiveCompare:dictObjectIdentifier] == NSOrderedSame;
+                updateCurrentManagedObject = [((NSString *)managedObjectIdentifier) isEqualToString:[GRVCoreDataImport canonicalIdentifier:dictObjectIdentifier]];
             }
             
             if (updateCurrentManagedObject) {
@@ -284,6 +401,102 @@
 }
 
 
+#pragma mark - Batched Import
+
++ (GRVCoreDataImportStatistics *)importObjects:(NSArray *)objects
+                               inBatchesOfSize:(NSUInteger)batchSize
+                        inManagedObjectContext:(NSManagedObjectContext *)context
+                              usingImportBatch:(NSArray *(^)(NSArray *batch,
+                                                             NSManagedObjectContext *context))importBatch
+{
+    return [GRVCoreDataImport importObjectsFromEnumerator:[objects objectEnumerator]
+                                          inBatchesOfSize:batchSize
+                                   inManagedObjectContext:context
+                                         usingImportBatch:importBatch];
+}
+
++ (GRVCoreDataImportStatistics *)importObjectsFromEnumerator:(NSEnumerator *)objects
+                                             inBatchesOfSize:(NSUInteger)batchSize
+                                      inManagedObjectContext:(NSManagedObjectContext *)context
+                                            usingImportBatch:(NSArray *(^)(NSArray *batch,
+                                                                           NSManagedObjectContext *context))importBatch
+{
+    GRVCoreDataImportStatistics *statistics = [[GRVCoreDataImportStatistics alloc] init];
+    NSMutableArray *batchTimes = [NSMutableArray array];
+    NSMutableArray *importedObjectIDs = [NSMutableArray array];
+    
+    if (batchSize == 0) batchSize = NSUIntegerMax;
+    
+    // Make the statistics available to fingerprint checks made by the batches
+    NSMutableDictionary *threadDictionary = [NSThread currentThread].threadDictionary;
+    [threadDictionary setObject:statistics forKey:kCurrentImportStatisticsKey];
+    
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    NSUInteger objectsCount = 0;
+    BOOL exhausted = NO;
+    do {
+        CFAbsoluteTime batchStartTime = CFAbsoluteTimeGetCurrent();
+        
+        @autoreleasepool {
+            // Pull the next batch from the enumerator. There's always a first
+            // batch, even if empty, so changes already in the context get saved.
+            NSMutableArray *batch = [NSMutableArray array];
+            id object = nil;
+            while (([batch count] < batchSize) && (object = [objects nextObject])) {
+                [batch addObject:object];
+            }
+            exhausted = ([batch count] < batchSize);
+            if (![batch count] && [batchTimes count]) break;
+            objectsCount += [batch count];
+            
+            NSArray *importedObjects = importBatch ? importBatch(batch, context) : nil;
+            
+            // Saving gives new objects permanent IDs, which remain valid after
+            // the reset.
+            NSError *error;
+            if ([context hasChanges] && ![context save:&error]) {
+                NSLog(@"[%@ %@] %@ (%@)", NSStringFromClass([self class]), NSStringFromSelector(_cmd), [error localizedDescription], [error localizedFailureReason]);
+            }
+            for (NSManagedObject *managedObject in importedObjects) {
+                [importedObjectIDs addObject:managedObject.objectID];
+            }
+            
+            // Fault out this batch's objects before moving on to the next.
+            [context reset];
+        }
+        
+        [batchTimes addObject:@(CFAbsoluteTimeGetCurrent() - batchStartTime)];
+        statistics.peakResidentMemory = MAX(statistics.peakResidentMemory, [GRVMemoryUtils residentMemory]);
+        
+    } while (!exhausted);
+    
+    [threadDictionary removeObjectForKey:kCurrentImportStatisticsKey];
+    
+    statistics.objectsCount = objectsCount;
+    statistics.batchTimes = batchTimes;
+    statistics.totalTime = CFAbsoluteTimeGetCurrent() - startTime;
+    statistics.importedObjectIDs = importedObjectIDs;
+    return statistics;
+}
+
++ (GRVCoreDataImportStatistics *)lastImportStatisticsForClass:(Class)objectClass
+{
+    NSMutableDictionary *lastImportStatistics = [GRVCoreDataImport lastImportStatistics];
+    @synchronized(lastImportStatistics) {
+        return [lastImportStatistics objectForKey:NSStringFromClass(objectClass)];
+    }
+}
+
++ (void)setLastImportStatistics:(GRVCoreDataImportStatistics *)statistics forClass:(Class)objectClass
+{
+    if (!statistics) return;
+    NSMutableDictionary *lastImportStatistics = [GRVCoreDataImport lastImportStatistics];
+    @synchronized(lastImportStatistics) {
+        [lastImportStatistics setObject:statistics forKey:NSStringFromClass(objectClass)];
+    }
+}
+
+
 #pragma mark - Delete
 
 + (void)deleteObjectsNotInObjectInfoArray:(NSArray *)objectDicts
@@ -292,6 +505,101 @@
                  usingAdditionalPredicate:(NSPredicate *(^)())additionalPredicate
                   withObjectIdentifierKey:(NSString *)objectIdentifierKey
                      andDictIdentifierKey:(NSString *)dictIdentifierKey
+{
+    // Create the fetch request to get all nsmanagedobjects of class objectClass not matching the objectIdentifiers
+    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
+    [fetchRequest setEntity:[NSEntityDescription entityForName:NSStringFromClass(objectClass) inManagedObjectContext:context]];
+    [fetchRequest setPredicate:[GRVCoreDataImport predicateForObjectsNotInObjectInfoArray:objectDicts
+                                                                   inManagedObjectContext:context
+                                                                                 forClass:objectClass
+                                                                 usingAdditionalPredicate:additionalPredicate
+                                                                  withObjectIdentifierKey:objectIdentifierKey
+                                                                     andDictIdentifierKey:dictIdentifierKey]];
+    
+    // finally, execute the fetch
+    NSError *error;
+    NSArray *objectsNotMatchingObjectIdentifiers = [context executeFetchRequest:fetchRequest error:&error];
+    
+    // now remove all events that should no longer exist
+    for (NSManagedObject *managedObject in objectsNotMatchingObjectIdentifiers) {
+        [context deleteObject:managedObject];
+    }
+}
+
++ (void)batchDeleteObjectsNotInObjectInfoArray:(NSArray *)objectDicts
+                        inManagedObjectContext:(NSManagedObjectContext *)context
+                                      forClass:(Class)objectClass
+                      usingAdditionalPredicate:(NSPredicate *(^)())additionalPredicate
+                       withObjectIdentifierKey:(NSString *)objectIdentifierKey
+                          andDictIdentifierKey:(NSString *)dictIdentifierKey
+                            fixupRelationships:(void (^)(NSPredicate *deletedObjectsPredicate,
+                                                         NSManagedObjectContext *context))fixupRelationships
+{
+    NSPredicate *predicate = [GRVCoreDataImport predicateForObjectsNotInObjectInfoArray:objectDicts
+                                                                 inManagedObjectContext:context
+                                                                               forClass:objectClass
+                                                               usingAdditionalPredicate:additionalPredicate
+                                                                withObjectIdentifierKey:objectIdentifierKey
+                                                                   andDictIdentifierKey:dictIdentifierKey];
+    
+    // Related objects have to be fixed up while the objects to be deleted are
+    // still around to be matched against.
+    if (fixupRelationships) fixupRelationships(predicate, context);
+    
+    // Batch deletes need iOS 9 and run against the store, so the context must
+    // save straight to it. Otherwise fall back to deleting one object at a time.
+    if (![NSBatchDeleteRequest class] || context.parentContext) {
+        NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:NSStringFromClass(objectClass)];
+        fetchRequest.predicate = predicate;
+        fetchRequest.includesPropertyValues = NO;
+        
+        NSError *error;
+        NSArray *objectsNotMatchingObjectIdentifiers = [context executeFetchRequest:fetchRequest error:&error];
+        for (NSManagedObject *managedObject in objectsNotMatchingObjectIdentifiers) {
+            [context deleteObject:managedObject];
+        }
+        return;
+    }
+    
+    // The batch delete doesn't see unsaved changes, such as relationship
+    // fixups, so save them first.
+    NSError *error;
+    if ([context hasChanges] && ![context save:&error]) {
+        NSLog(@"[%@ %@] %@ (%@)", NSStringFromClass([self class]), NSStringFromSelector(_cmd), [error localizedDescription], [error localizedFailureReason]);
+    }
+    
+    NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:NSStringFromClass(objectClass)];
+    fetchRequest.predicate = predicate;
+    NSBatchDeleteRequest *deleteRequest = [[NSBatchDeleteRequest alloc] initWithFetchRequest:fetchRequest];
+    deleteRequest.resultType = NSBatchDeleteResultTypeObjectIDs;
+    
+    NSBatchDeleteResult *deleteResult = [context executeRequest:deleteRequest error:&error];
+    if (!deleteResult) {
+        NSLog(@"[%@ %@] %@ (%@)", NSStringFromClass([self class]), NSStringFromSelector(_cmd), [error localizedDescription], [error localizedFailureReason]);
+        return;
+    }
+    
+    // The store changed underneath all contexts, so tell them what's gone.
+    NSArray *deletedObjectIDs = deleteResult.result;
+    if ([deletedObjectIDs count]) {
+        [NSManagedObjectContext mergeChangesFromRemoteContextSave:@{NSDeletedObjectsKey : deletedObjectIDs}
+                                                     intoContexts:@[context]];
+        [[GRVModelManager sharedManager] mergeDeletedObjectIDs:deletedObjectIDs];
+    }
+}
+
+#pragma mark - Private
+#pragma mark Helpers
+/**
+ * Predicate matching NSManagedObjects not in a provided array of JSON data
+ * objects. See deleteObjectsNotInObjectInfoArray:... for parameters.
+ */
++ (NSPredicate *)predicateForObjectsNotInObjectInfoArray:(NSArray *)objectDicts
+                                  inManagedObjectContext:(NSManagedObjectContext *)context
+                                                forClass:(Class)objectClass
+                                usingAdditionalPredicate:(NSPredicate *(^)())additionalPredicate
+                                 withObjectIdentifierKey:(NSString *)objectIdentifierKey
+                                    andDictIdentifierKey:(NSString *)dictIdentifierKey
 {
     // Determine if the object identifier is a string
     BOOL objectIdentifierIsString = [GRVCoreDataImport objectIdentifierIsString:objectClass withObjectIdentifierKey:objectIdentifierKey inManagedObjectContext:context];
@@ -301,41 +609,35 @@
     for (NSDictionary *objectDictionary in objectDicts) {
         
         id objectIdentifier = [objectDictionary valueForKeyPath:dictIdentifierKey];
-        if (objectIdentifierIsString) objectIdentifier = [objectIdentifier description];
+        if (objectIdentifierIsString) objectIdentifier = [GRVCoreDataImport canonicalIdentifier:objectIdentifier];
         
         [objectIdentifiers addObject:objectIdentifier];
     }
     
-    // Create the fetch request to get all nsmanagedobjects of class objectClass not matching the objectIdentifiers
-    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
-    [fetchRequest setEntity:[NSEntityDescription entityForName:NSStringFromClass(objectClass) inManagedObjectContext:context]];
-    
     // Create the base predicate first
-    NSPredicate *basePredicate = nil;
-    if (objectIdentifierIsString) {
-        basePredicate = [NSPredicate predicateWithFormat:@"NOT (%K IN[c] %@)", objectIdentifierKey, objectIdentifiers];
-    } else {
-        basePredicate = [NSPredicate predicateWithFormat:@"NOT (%K IN %@)", objectIdentifierKey, objectIdentifiers];
-    }
+    NSPredicate *basePredicate = [NSPredicate predicateWithFormat:@"NOT (%K IN %@)", objectIdentifierKey, objectIdentifiers];
     
     if (additionalPredicate) {
         NSPredicate *addedPredicate = additionalPredicate();
         basePredicate = [NSCompoundPredicate andPredicateWithSubpredicates:@[addedPredicate, basePredicate]];
     }
-    [fetchRequest setPredicate:basePredicate];
-    
-    // finally, execute the fetch
-    NSError *error;
-    NSArray *objectsNotMatchingObjectIdentifiers = [context executeFetchRequest:fetchRequest error:&error];
-    
-    // now remove all events that should no longer exist
-    for (NSManagedObject *managedObject in objectsNotMatchingObjectIdentifiers) {
-        [context deleteObject:managedObject];
-    }
+    return basePredicate;
+}
+
+/**
+ * Statistics of the most recent batched imports, keyed by class name.
+ * Access this synchronized on the dictionary as imports run on different queues.
+ */
++ (NSMutableDictionary *)lastImportStatistics
+{
+    static NSMutableDictionary *lastImportStatistics = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        lastImportStatistics = [NSMutableDictionary dictionary];
+    });
+    return lastImportStatistics;
 }
 
-#pragma mark - Private
-#pragma mark Helpers
 /**
  * Determine if the managed object's identifier is a string or number.
  *
@@ -402,7 +704,7 @@
         isEqual = [((NSNumber *)object1Identifier) integerValue] == [((NSNumber *)object2Identifier) integerValue];
         
     } else if ([object1Identifier isKindOfClass:[NSString class]]) {
-        isEqual = [((NSString *)object1Identifier) caseInsensitiveCompare:((NSString *)object2Identifier)] == NSOrderedSame;
+        isEqual = [((NSString *)object1Identifier) isEqualToString:((NSString *)object2Identifier)];
     }
     
     return isEqual;
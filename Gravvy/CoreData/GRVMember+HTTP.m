@@ -10,7 +10,7 @@
 #import "GRVUser+HTTP.h"
 #import "GRVVideo+HTTP.h"
 #import "GRVCoreDataImport.h"
-#import "GRVFormatterUtils.h"
+#import "GRVAttributeMapping.h"
 #import "GRVConstants.h"
 #import "GRVModelManager.h"
 #import "GRVAccountManager.h"
@@ -21,6 +21,22 @@
 
 #pragma mark - Class Methods
 #pragma mark Private
+/**
+ * Mapping of a member's JSON attributes
+ */
++ (GRVAttributeMapping *)attributeMapping
+{
+    static GRVAttributeMapping *mapping = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mapping = [GRVAttributeMapping mappingWithAttributes:@[
+            @[kGRVRESTMemberCreatedAtKey,   @"createdAt",   @(GRVAttributeTypeDate)],
+            @[kGRVRESTMemberStatusKey,      @"status",      @(GRVAttributeTypeNumber)],
+            @[kGRVRESTMemberUpdatedAtKey,   @"updatedAt",   @(GRVAttributeTypeDate)]]];
+    });
+    return mapping;
+}
+
 /**
  * Create a new member
  *
@@ -34,20 +50,7 @@
 {
     GRVMember *newMember = [NSEntityDescription insertNewObjectForEntityForName:@"GRVMember" inManagedObjectContext:context];
     
-    NSDateFormatter *rfc3339DateFormatter = [GRVFormatterUtils generateRFC3339DateFormatter];
-    
-    // Setup all the dates
-    NSString *rfc3339UpdatedAt = [[memberDictionary objectForKey:kGRVRESTMemberUpdatedAtKey] description];
-    NSDate *updatedAt = [rfc3339DateFormatter dateFromString:rfc3339UpdatedAt];
-    
-    NSString *rfc3339CreatedAt = [[memberDictionary objectForKey:kGRVRESTMemberCreatedAtKey] description];
-    NSDate *createdAt = [rfc3339DateFormatter dateFromString:rfc3339CreatedAt];
-    
-    // Get and save dictionary attributes being sure call the description method
-    // incase dictionary values are NULL
-    newMember.createdAt = createdAt;
-    newMember.status = [memberDictionary objectForKey:kGRVRESTMemberStatusKey];
-    newMember.updatedAt = updatedAt;
+    [[GRVMember attributeMapping] applyToObject:newMember fromDictionary:memberDictionary];
     
     // Setup required relationships
     newMember.user = [GRVUser userWithUserInfo:[memberDictionary objectForKey:kGRVRESTMemberUserKey]
@@ -58,7 +61,8 @@
 }
 
 /**
- * Update an existing member with a given member object from server
+ * Update an existing member with a given member object from server.
+ * Only attributes that have changed get written.
  *
  * @param existingMember    Existing GRVMember object to be updated
  * @param memberDictionary  Member object with all attributes from server
@@ -66,21 +70,7 @@
 + (void)syncMember:(GRVMember *)existingMember
     withMemberInfo:(NSDictionary *)memberDictionary
 {
-    NSDateFormatter *rfc3339DateFormatter = [GRVFormatterUtils generateRFC3339DateFormatter];
-    
-    // get updatedAt date which is used for sync
-    NSString *rfc3339UpdatedAt = [[memberDictionary objectForKey:kGRVRESTMemberUpdatedAtKey] description];
-    NSDate *updatedAt = [rfc3339DateFormatter dateFromString:rfc3339UpdatedAt];
-    
-    // only perform a sync on member object if there are any changes
-    if (![updatedAt isEqualToDate:existingMember.updatedAt]) {
-        
-        // get and set properties that will be sync'd
-        existingMember.status = [memberDictionary objectForKey:kGRVRESTMemberStatusKey];
-        
-        // finally sync updatedAt
-        existingMember.updatedAt = updatedAt;
-    }
+    [[GRVMember attributeMapping] applyToObject:existingMember fromDictionary:memberDictionary];
     
     // Member might not have changed but its linked user might have changed so
     // account for that
@@ -106,7 +96,7 @@
                                 usingAdditionalPredicate:^NSPredicate *{
                                     return [NSPredicate predicateWithFormat:@"video == %@", video];
                                 }
-                                 withObjectIdentifierKey:@"user.phoneNumber"
+                                 withObjectIdentifierKey:@"user.canonicalPhoneNumber"
                                     andDictIdentifierKey:kGRVRESTMemberIdentifierKey];
 }
 
@@ -143,7 +133,7 @@
                                 usingAdditionalPredicate:^NSPredicate *{
                                     return [NSPredicate predicateWithFormat:@"video == %@", video];
                                 }
-                                 withObjectIdentifierKey:@"user.phoneNumber"
+                                 withObjectIdentifierKey:@"user.canonicalPhoneNumber"
                                     andDictIdentifierKey:kGRVRESTMemberIdentifierKey
                                        usingCreateObject:^NSManagedObject *(NSDictionary *objectDictionary, NSManagedObjectContext *context) {
                                            return [GRVMember newMemberWithMemberInfo:objectDictionary associatedVideo:video inManagedObjectContext:context];
@@ -10,10 +10,20 @@
 #import <CoreData/CoreData.h>
 
 /**
- * GRVModelManager is a singleton class that ensures we have just one instance
- * of UIManagedDocument throughout this application for each actual document.
+ * GRVModelManager is a singleton class that ensures we have just one Core Data
+ * stack throughout this application for each user's store.
  * This way all changes will always be seen by all readers and writers of the
- * document.
+ * store.
+ *
+ * @discussion The stack is a SQLite store in write-ahead logging (WAL) mode,
+ *      so reads aren't blocked while another context writes. A private queue
+ *      writer context saves to the store and is the parent of the main thread
+ *      context, so disk I/O stays off the main thread. Worker contexts save
+ *      directly to the store and their changes are merged into the writer and
+ *      main thread contexts. Updated objects aren't faulted in for the merge:
+ *      only those the main thread context already has registered are
+ *      refreshed, and faults among them stay faults.
+ *
  * This class also handles reading and writing of user settings
  */
 @interface GRVModelManager : NSObject
@@ -28,12 +38,13 @@
  * Database handle for background operations.
  * Need to use a shared version so that all workers see same data.
  *
- * Would just use managedObjectContext.parentContext as the background
- * worker context, however it doesn't push changes down to the main
- * thread context. So need to make the worker context a child of the
- * main thread context.
+ * This context saves straight to the persistent store, so a save doesn't go
+ * through the main thread context. Once saved, its changes are merged into the
+ * main thread context on the main queue, refreshing only the updated objects
+ * the main thread context has registered. This merge is queued before any
+ * block the worker dispatches to the main queue after saving.
  *
- * @ref http://floriankugler.com/blog/2013/4/2/the-concurrent-core-data-stack
+ * @ref http://floriankugler.com/blog/2013/4/29/concurrent-core-data-stack-performance-shootout
  *
  * @warning This context needs to always ensure its data is up to date by doing
  * either of the following:
@@ -69,7 +80,19 @@
  */
 @property (strong, nonatomic, readonly) NSManagedObjectContext *workerContextLongRunning;
 
+#pragma mark Measurements
+/**
+ * Total time, in seconds, the main thread spent merging worker context saves.
+ */
+@property (nonatomic, readonly) NSTimeInterval mainThreadMergeTime;
+
 #pragma mark NSUserDefault Settings
+/*
+ * The current user's settings are read from and written to an in-memory copy,
+ * so these are cheap enough for use while scrolling. Changes are written to
+ * NSUserDefaults a few seconds later, or when the app enters the background.
+ */
+
 /**
  * Does the user want to receive sounds from the app?
  */
@@ -112,34 +135,56 @@
 
 #pragma mark - Instance Methods
 /**
- * Setup document for a given authenticated app user.
- * This sets up the internal UIManagedDocument and its associated managedObjectContext.
- * This will close a previously opened document that is still open
+ * Setup the Core Data stack for a given authenticated app user.
+ * This adds the user's SQLite store and sets up the associated
+ * managedObjectContext. The store is added off the main thread as it might
+ * need migrating.
+ * This will close a previously opened store that is still open
  *
  * @param phoneNumber
  *      Unique identifier of a user is an associated E.164 format phone number.
  * @param documentIsReady
- *      A block object to be executed when the document and managed object context
+ *      A block object to be executed when the store and managed object context
  *      are setup. This block has no return value and takes no arguments.
  */
 - (void)setupDocumentForUser:(NSString *)phoneNumber completionHandler:(void (^)())documentIsReady;
 
 
 /**
- * Asynchronously save and close userDocument.
+ * Asynchronously save and close the user's store.
  *
  * @param documentIsClosed
- *      block to be called when document is closed successfully.
+ *      block to be called when the store is closed.
  */
 - (void)closeUserDocument:(void (^)())documentIsClosed;
 
 
 /**
- * Force an asynchronous manual save of the usually auto-saved userDocument.
+ * Force an asynchronous manual save of the usually auto-saved main thread
+ * context, all the way to disk.
  *
  * @param documentIsSaved
- *      block to be called when document is saved.
+ *      block to be called on the main queue when the save is done.
  */
 - (void)saveUserDocument:(void (^)())documentIsSaved;
 
+/**
+ * Merge objects deleted directly in the persistent store, such as by a batch
+ * delete, into the writer and main thread contexts. The main thread merge is
+ * done on the main queue.
+ *
+ * @param objectIDs     IDs of the deleted objects
+ */
+- (void)mergeDeletedObjectIDs:(NSArray *)objectIDs;
+
+/**
+ * Write any pending user settings changes to NSUserDefaults now.
+ */
+- (void)flushUserSettings;
+
+/**
+ * Reset all measurements to zero.
+ */
+- (void)resetMeasurements;
+
 @end
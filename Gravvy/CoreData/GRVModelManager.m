@@ -7,15 +7,35 @@
 //
 
 #import "GRVModelManager.h"
-#import "GRVManagedDocument.h"
+#import "GRVVideo+HTTP.h"
+#import "GRVUser+HTTP.h"
 #import "GRVConstants.h"
 
 // Constants
 /**
- * kUserDocumentBase is Managed Document base location
+ * kUserDocumentBase is the base name of a user's Core Data directory
  */
 static NSString *const kUserDocumentBase      = @"UserDocument";
 
+/**
+ * Location of the SQLite store within a user's Core Data directory. This is
+ * where UIManagedDocument kept it, so existing stores carry over.
+ */
+static NSString *const kUserStoreContentDirectory = @"StoreContent";
+static NSString *const kUserStoreFileName      = @"persistentStore";
+
+/**
+ * Delay between a change in the main context and it being saved. Changes
+ * made within this window are saved together.
+ */
+static NSTimeInterval const kAutosaveDelay = 3.0;
+
+/**
+ * Delay between a change in user settings and it being written to
+ * NSUserDefaults. Changes made within this window are written together.
+ */
+static NSTimeInterval const kUserSettingsFlushDelay = 5.0;
+
 /**
  * kUserKeyBase is base string for NSUserDefaults user settings dictionary key
  */
@@ -35,24 +55,65 @@ static NSString *const kProfileConfiguredKey = @"kGRVProfileConfiguredKey";
 @property (strong, nonatomic, readwrite) NSManagedObjectContext *workerContext;
 @property (strong, nonatomic, readwrite) NSManagedObjectContext *workerContextVideo;
 @property (strong, nonatomic, readwrite) NSManagedObjectContext *workerContextLongRunning;
+@property (nonatomic, readwrite) NSTimeInterval mainThreadMergeTime;
 
 @property (strong, nonatomic) NSString *phoneNumber; // cache phone number being used.
 
 /**
- * The documents for this app are separated by user, so this will be updated for
- * each authenticated user that logs into the app
+ * The managed object model for the application, loaded from the app bundle.
  */
-@property (strong, nonatomic) UIManagedDocument *userDocument;
+@property (strong, nonatomic) NSManagedObjectModel *managedObjectModel;
+
+/**
+ * The persistent stores for this app are separated by user, so this will be
+ * updated for each authenticated user that logs into the app
+ */
+@property (strong, nonatomic) NSPersistentStoreCoordinator *persistentStoreCoordinator;
+
+/**
+ * Private queue context that is the parent of the main thread context and does
+ * the actual writing of its changes to disk, off the main thread.
+ */
+@property (strong, nonatomic) NSManagedObjectContext *writerContext;
+
+/**
+ * Has a save of the main thread context been scheduled?
+ */
+@property (nonatomic) BOOL autosaveScheduled;
+
+/**
+ * In-memory copy of the current user's settings dictionary. All reads and
+ * writes of user settings go through this, and writes reach NSUserDefaults in
+ * a delayed flush.
+ */
+@property (strong, nonatomic) NSMutableDictionary *userSettings;
+
+/**
+ * Have user settings changed since they were last written to NSUserDefaults?
+ */
+@property (nonatomic) BOOL userSettingsDirty;
 
 @end
 
 @implementation GRVModelManager
 #pragma mark - Properties
-- (void)setUserDocument:(UIManagedDocument *)userDocument
+- (NSManagedObjectModel *)managedObjectModel
+{
+    // lazy instantiation
+    if (!_managedObjectModel) {
+        NSURL *modelURL = [[NSBundle mainBundle] URLForResource:@"Gravvy"
+                                                  withExtension:@"momd"];
+        _managedObjectModel = [[NSManagedObjectModel alloc] initWithContentsOfURL:modelURL];
+    }
+    return _managedObjectModel;
+}
+
+- (void)setPersistentStoreCoordinator:(NSPersistentStoreCoordinator *)persistentStoreCoordinator
 {
-    // modifying the user document means the context should be reset. The context
-    // will be set appropriately when the document is used.
-    _userDocument = userDocument;
+    // modifying the persistent store coordinator means the contexts should be
+    // reset. The contexts will be set appropriately when the store is added.
+    _persistentStoreCoordinator = persistentStoreCoordinator;
+    self.writerContext = nil;
     self.managedObjectContext = nil;
 }
 
@@ -60,6 +121,11 @@ static NSString *const kProfileConfiguredKey = @"kGRVProfileConfiguredKey";
 {
     // modifying the main thread context means the background thread context should
     // be reset.
+    if (_managedObjectContext) {
+        [[NSNotificationCenter defaultCenter] removeObserver:self
+                                                        name:NSManagedObjectContextObjectsDidChangeNotification
+                                                      object:_managedObjectContext];
+    }
     _managedObjectContext = managedObjectContext;
     self.workerContext = nil;
     self.workerContextVideo = nil;
@@ -78,9 +144,7 @@ static NSString *const kProfileConfiguredKey = @"kGRVProfileConfiguredKey";
     // when each worker context goes off creating objects common to different
     // background operations, such as GRVUsers.
     if (!_workerContext && self.managedObjectContext) {
-        _workerContext = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
-        _workerContext.parentContext = self.managedObjectContext;
-        _workerContext.stalenessInterval = 0.0; // no staleness acceptable
+        _workerContext = [self newWorkerContext];
     }
     return _workerContext;
 }
@@ -88,9 +152,7 @@ static NSString *const kProfileConfiguredKey = @"kGRVProfileConfiguredKey";
 - (NSManagedObjectContext *)workerContextVideo
 {
     if (!_workerContextVideo && self.managedObjectContext) {
-        _workerContextVideo = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
-        _workerContextVideo.parentContext = self.managedObjectContext;
-        _workerContextVideo.stalenessInterval = 0.0; // no staleness acceptable
+        _workerContextVideo = [self newWorkerContext];
     }
     return _workerContextVideo;
 }
@@ -98,9 +160,7 @@ static NSString *const kProfileConfiguredKey = @"kGRVProfileConfiguredKey";
 - (NSManagedObjectContext *)workerContextLongRunning
 {
     if (!_workerContextLongRunning && self.managedObjectContext) {
-        _workerContextLongRunning = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
-        _workerContextLongRunning.parentContext = self.managedObjectContext;
-        _workerContextLongRunning.stalenessInterval = 0.0; // no staleness acceptable
+        _workerContextLongRunning = [self newWorkerContext];
     }
     return _workerContextLongRunning;
 }
@@ -182,23 +242,27 @@ static NSString *const kProfileConfiguredKey = @"kGRVProfileConfiguredKey";
 
 - (id)userSettingsObjectForKey:(NSString *)settingsKey
 {
-    NSDictionary *userSettings = [[NSUserDefaults standardUserDefaults] dictionaryForKey:[self userSettingsKey]];
-    return [userSettings objectForKey:settingsKey];
+    return [self.userSettings objectForKey:settingsKey];
 }
 
 - (void)setUserSettingsObject:(id)object forKey:(NSString *)settingsKey
 {
-    NSString *userKey = [self userSettingsKey];
-    NSMutableDictionary *mutableUserSettings = [[[NSUserDefaults standardUserDefaults] dictionaryForKey:userKey] mutableCopy];
+    // Nothing to do if there's no user or the setting is unchanged
+    if (!self.userSettings) return;
+    id currentObject = [self.userSettings objectForKey:settingsKey];
+    if ((object == currentObject) || [object isEqual:currentObject]) return;
     
     if (!object) {
-        [mutableUserSettings removeObjectForKey:settingsKey];
+        [self.userSettings removeObjectForKey:settingsKey];
     } else {
-        [mutableUserSettings setObject:object forKey:settingsKey];
+        [self.userSettings setObject:object forKey:settingsKey];
     }
     
-    [[NSUserDefaults standardUserDefaults] setObject:mutableUserSettings forKey:userKey];
-    [[NSUserDefaults standardUserDefaults] synchronize]; // never forget saving to disk
+    // Write to NSUserDefaults later, along with any other changes made by then
+    if (!self.userSettingsDirty) {
+        self.userSettingsDirty = YES;
+        [self performSelector:@selector(flushUserSettings) withObject:nil afterDelay:kUserSettingsFlushDelay];
+    }
 }
 
 
@@ -241,48 +305,78 @@ static NSString *const kProfileConfiguredKey = @"kGRVProfileConfiguredKey";
 {
     self = [super init];
     if (self) {
-        // custom initialization here...
+        NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+        
+        // Worker contexts save straight to the store, so their changes are
+        // merged into the main thread context
+        [notificationCenter addObserver:self
+                               selector:@selector(managedObjectContextDidSave:)
+                                   name:NSManagedObjectContextDidSaveNotification
+                                 object:nil];
+        
+        // Don't lose unsaved changes when the app stops running
+        [notificationCenter addObserver:self
+                               selector:@selector(saveBeforeSuspension:)
+                                   name:UIApplicationDidEnterBackgroundNotification
+                                 object:nil];
+        [notificationCenter addObserver:self
+                               selector:@selector(saveBeforeSuspension:)
+                                   name:UIApplicationWillTerminateNotification
+                                 object:nil];
     }
     return self;
 }
 
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
 
 #pragma mark - Instance Methods
 #pragma mark Public
+/**
+ * Setup the Core Data stack for a given authenticated app user.
+ * This will close a previously opened store that is still open
+ *
+ * @param phoneNumber
+ *      Unique identifier of a user is an associated E.164 format phone number.
+ * @param documentIsReady
+ *      A block object to be executed when the store and managed object context
+ *      are setup. This block has no return value and takes no arguments.
+ */
 - (void)setupDocumentForUser:(NSString *)phoneNumber completionHandler:(void (^)())documentIsReady
 {
     // register default settings for user at this time
     [self registerDefaultSettings:phoneNumber];
     
-    // clear out managed object context which will soon be setup again.
-    self.managedObjectContext = nil;
-    
-    // if a document is already open close it out before setting up document
-    if (self.userDocument) {
+    // if a store is already open close it out before setting up the new one.
+    // The managed object context is only cleared out, to be setup again, once
+    // its changes have been saved.
+    if (self.persistentStoreCoordinator) {
         [self closeUserDocument:^{
-            self.userDocument = nil;
+            self.managedObjectContext = nil;
             [self setupNewDocumentForUser:phoneNumber completionHandler:documentIsReady];
         }];
         
     } else {
+        self.managedObjectContext = nil;
         [self setupNewDocumentForUser:phoneNumber completionHandler:documentIsReady];
     }
 }
 
 
 /**
- * Asynchronously save and close userDocument.
+ * Asynchronously save and close the user's store.
  *
  * @param documentIsClosed
- *      block to be called when document is closed successfully.
+ *      block to be called when the store is closed.
  */
 - (void)closeUserDocument:(void (^)())documentIsClosed
 {
-    [self.userDocument closeWithCompletionHandler:^(BOOL success) {
-        // it would be ideal to check for success first, but if this fails
-        // it's game over anyways.
-        // we indicate document closure by clearing out userDocument
-        self.userDocument = nil;
+    [self saveUserDocument:^{
+        // we indicate closure by clearing out the persistent store coordinator
+        self.persistentStoreCoordinator = nil;
         
         // notify all listeners that this managedObjectContext is no longer valid
         [[NSNotificationCenter defaultCenter] postNotificationName:kGRVMOCDeletedNotification
@@ -293,114 +387,296 @@ static NSString *const kProfileConfiguredKey = @"kGRVProfileConfiguredKey";
 
 
 /**
- * Force an asynchronous manual save of the usually auto-saved userDocument.
+ * Force an asynchronous manual save of the usually auto-saved main thread
+ * context, all the way to disk.
  *
  * @param documentIsSaved
- *      block to be called when document is saved.
+ *      block to be called on the main queue when the save is done.
  */
 - (void)saveUserDocument:(void (^)())documentIsSaved
 {
-    [self.userDocument saveToURL:self.userDocument.fileURL
-                forSaveOperation:UIDocumentSaveForOverwriting
-               completionHandler:^(BOOL success) {
-                   if (success) {
-                       if (documentIsSaved) documentIsSaved();
-                   }
-               }
-     ];
+    // A save now covers any scheduled autosave
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(autosave) object:nil];
+    self.autosaveScheduled = NO;
+    
+    NSManagedObjectContext *writerContext = self.writerContext;
+    if (!writerContext) {
+        if (documentIsSaved) documentIsSaved();
+        return;
+    }
+    
+    // Push main thread changes down to the writer context, which is quick as
+    // it's all in memory, then let the writer context do the disk I/O on its
+    // own queue.
+    NSError *error;
+    if ([self.managedObjectContext hasChanges] && ![self.managedObjectContext save:&error]) {
+        NSLog(@"[%@ %@] %@ (%@)", NSStringFromClass([self class]), NSStringFromSelector(_cmd), [error localizedDescription], [error localizedFailureReason]);
+    }
+    
+    [writerContext performBlock:^{
+        NSError *writerError;
+        if ([writerContext hasChanges] && ![writerContext save:&writerError]) {
+            NSLog(@"[%@ %@] %@ (%@)", NSStringFromClass([self class]), NSStringFromSelector(_cmd), [writerError localizedDescription], [writerError localizedFailureReason]);
+        }
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (documentIsSaved) documentIsSaved();
+        });
+    }];
+}
+
+- (void)mergeDeletedObjectIDs:(NSArray *)objectIDs
+{
+    if (![objectIDs count]) return;
+    NSDictionary *changes = @{NSDeletedObjectsKey : objectIDs};
+    
+    NSManagedObjectContext *writerContext = self.writerContext;
+    [writerContext performBlock:^{
+        [NSManagedObjectContext mergeChangesFromRemoteContextSave:changes intoContexts:@[writerContext]];
+    }];
+    
+    dispatch_async(dispatch_get_main_queue(), ^{
+        NSManagedObjectContext *mainContext = self.managedObjectContext;
+        if (!mainContext || (mainContext.parentContext != writerContext)) return;
+        
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+        [NSManagedObjectContext mergeChangesFromRemoteContextSave:changes intoContexts:@[mainContext]];
+        self.mainThreadMergeTime += CFAbsoluteTimeGetCurrent() - startTime;
+    });
+}
+
+- (void)flushUserSettings
+{
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(flushUserSettings) object:nil];
+    if (!self.userSettingsDirty) return;
+    
+    self.userSettingsDirty = NO;
+    [[NSUserDefaults standardUserDefaults] setObject:[self.userSettings copy]
+                                              forKey:[self userSettingsKey]];
+}
+
+- (void)resetMeasurements
+{
+    self.mainThreadMergeTime = 0.0;
 }
 
 
 #pragma mark Private: CoreData
 /**
- * Setup document for a given authenticated app user. This sets up the internal
- * UIManagedDocument and its associated managedObjectContext
+ * Setup the Core Data stack for a given authenticated app user. This adds the
+ * user's SQLite store to a new persistent store coordinator and sets up the
+ * writer and main thread contexts on top of it.
  *
  * This is different from the public method setupDocumentForUser:completionHandler:
- * in that it doesn't close a previously opened document.
+ * in that it doesn't close a previously opened store.
  *
  * @param phoneNumber
  *      Unique identifier of a user is an E.164 format phone number.
  * @param documentIsReady
- *      A block object to be executed when the document and managed object context
+ *      A block object to be executed when the store and managed object context
  *      are setup. This block has no return value and takes no arguments.
  *
- * @warning You probably shouldn't call this without first closing the document.
+ * @warning You probably shouldn't call this without first closing the store.
  */
 - (void)setupNewDocumentForUser:(NSString *)phoneNumber completionHandler:(void (^)())documentIsReady
 {
-    // construct authenticated user's document directory.
+    // construct authenticated user's store location in the application's
+    // document directory.
     NSString *docPath = [NSString stringWithFormat:@"%@%@", kUserDocumentBase, phoneNumber];
-    
-    // setup userDocument @property as a document in the application's document directory
     NSURL *docURL = [[[NSFileManager defaultManager] URLsForDirectory:NSDocumentDirectory inDomains:NSUserDomainMask] lastObject];
+    NSURL *storeDirectoryURL = [[docURL URLByAppendingPathComponent:docPath] URLByAppendingPathComponent:kUserStoreContentDirectory];
+    NSURL *storeURL = [storeDirectoryURL URLByAppendingPathComponent:kUserStoreFileName];
     
-    docURL = [docURL URLByAppendingPathComponent:docPath];
+    NSPersistentStoreCoordinator *coordinator = [[NSPersistentStoreCoordinator alloc] initWithManagedObjectModel:self.managedObjectModel];
+    self.persistentStoreCoordinator = coordinator;
     
-    self.userDocument = [[GRVManagedDocument alloc] initWithFileURL:docURL];
-    
-    // support automatic migration
-    // see documentation of NSPersistentStoreCoordinator for details
+    // support automatic migration (see documentation of
+    // NSPersistentStoreCoordinator for details) and use write-ahead logging so
+    // readers aren't blocked by the writer.
     NSDictionary *options = @{NSMigratePersistentStoresAutomaticallyOption  : @(YES),
-                              NSInferMappingModelAutomaticallyOption        : @(YES)};
-    self.userDocument.persistentStoreOptions = options;
+                              NSInferMappingModelAutomaticallyOption        : @(YES),
+                              NSSQLitePragmasOption                         : @{@"journal_mode" : @"WAL"}};
     
-    // use userDocument to setup managedObjectContext @property
-    [self useUserDocument:^{
-        // notify all listeners that this managedObjectContext is now setup
-        [[NSNotificationCenter defaultCenter] postNotificationName:kGRVMOCAvailableNotification
-                                                            object:self];
-        if (documentIsReady) documentIsReady();
-    }];
+    // Adding the store can mean a migration so do it off the main thread
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), ^{
+        [[NSFileManager defaultManager] createDirectoryAtURL:storeDirectoryURL
+                                 withIntermediateDirectories:YES
+                                                  attributes:nil
+                                                       error:NULL];
+        NSError *error;
+        NSPersistentStore *store = [coordinator addPersistentStoreWithType:NSSQLiteStoreType
+                                                             configuration:nil
+                                                                       URL:storeURL
+                                                                   options:options
+                                                                     error:&error];
+        if (!store) NSLog(@"[%@ %@] %@ (%@)", NSStringFromClass([self class]), NSStringFromSelector(_cmd), [error localizedDescription], [error localizedFailureReason]);
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            // if the store was closed/replaced while being added, it's no
+            // longer wanted.
+            if (!store || (self.persistentStoreCoordinator != coordinator)) return;
+            
+            [self setupContextsWithPersistentStoreCoordinator:coordinator];
+            
+            // A store migrated from an older model might need its derived
+            // attributes filled in.
+            [self updateMigratedAttributes];
+            
+            // notify all listeners that this managedObjectContext is now setup
+            [[NSNotificationCenter defaultCenter] postNotificationName:kGRVMOCAvailableNotification
+                                                                object:self];
+            if (documentIsReady) documentIsReady();
+        });
+    });
 }
 
 /**
- * Either creates, opens or just uses the userDocument.
- * Creating and opening are async, so in the completion handler we set our model
- *   (managedObjectContext).
- * This sets up the managedObjectContext property if it isn't already setup
- *   then it calls the ^(void)documentIsReady block.
- *
- * @param documentIsReady
- *      block to be called when document is ready and managedObjectContext
- *      property is setup.
+ * Setup the writer and main thread contexts on a persistent store coordinator.
+ * Worker contexts are created lazily from the same coordinator.
  */
-- (void)useUserDocument:(void (^)())documentIsReady
+- (void)setupContextsWithPersistentStoreCoordinator:(NSPersistentStoreCoordinator *)coordinator
 {
-    // access the shared instance of the document
-    NSURL *url = self.userDocument.fileURL;
-    UIManagedDocument *document = self.userDocument;
+    NSManagedObjectContext *writerContext = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
+    writerContext.persistentStoreCoordinator = coordinator;
+    writerContext.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy;
+    self.writerContext = writerContext;
     
-    // must first open/create the document to use it so check to see if it
-    // exists
-    if (![[NSFileManager defaultManager] fileExistsAtPath:[url path]]) {
-        // if document doesn't exist create it
-        [document saveToURL:url forSaveOperation:UIDocumentSaveForCreating completionHandler:^(BOOL success) {
-            if (success) {
-                self.managedObjectContext = document.managedObjectContext;
-                // just created this document so this would be a good time to call
-                // methods to populate the data. However there is no need for
-                // that in this case.
-                if (documentIsReady) documentIsReady();
-            }
-        }];
+    NSManagedObjectContext *mainContext = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSMainQueueConcurrencyType];
+    mainContext.parentContext = writerContext;
+    mainContext.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy;
+    self.managedObjectContext = mainContext;
+    
+    // Changes on the main thread context get saved in the background after a
+    // short delay, so there's no need to save after every small change.
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(managedObjectContextObjectsDidChange:)
+                                                 name:NSManagedObjectContextObjectsDidChangeNotification
+                                               object:mainContext];
+}
+
+/**
+ * Create a background context that saves directly to the persistent store
+ * coordinator, rather than through the main thread context.
+ */
+- (NSManagedObjectContext *)newWorkerContext
+{
+    NSManagedObjectContext *context = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
+    context.persistentStoreCoordinator = self.persistentStoreCoordinator;
+    context.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy;
+    context.stalenessInterval = 0.0; // no staleness acceptable
+    return context;
+}
+
+/**
+ * Is a context one of the worker contexts? Only saves from these need merging
+ * as they go straight to the persistent store.
+ */
+- (BOOL)isWorkerContext:(NSManagedObjectContext *)context
+{
+    return (context &&
+            ((context == _workerContext) ||
+             (context == _workerContextVideo) ||
+             (context == _workerContextLongRunning)));
+}
+
+/**
+ * Save the main thread context if it has changes. This is the target of the
+ * delayed autosave.
+ */
+- (void)autosave
+{
+    self.autosaveScheduled = NO;
+    if ([self.managedObjectContext hasChanges]) {
+        [self saveUserDocument:nil];
+    }
+}
+
+/**
+ * Fill in attributes that lightweight migration can't derive from the data of
+ * older model versions. Each step only touches objects that still need it, so
+ * this is cheap after the first run on a migrated store.
+ */
+- (void)updateMigratedAttributes
+{
+    [GRVVideo updateClipsCountsInManagedObjectContext:self.managedObjectContext];
+    [GRVVideo updateCanonicalHashKeysInManagedObjectContext:self.managedObjectContext];
+    [GRVUser updateCanonicalPhoneNumbersInManagedObjectContext:self.managedObjectContext];
+}
+
+
+#pragma mark - Notification Observer Methods
+/**
+ * Merge a worker context's saved changes into the main thread context and the
+ * writer context, so both see what is now in the persistent store.
+ */
+- (void)managedObjectContextDidSave:(NSNotification *)aNotification
+{
+    NSManagedObjectContext *savedContext = aNotification.object;
+    if (![self isWorkerContext:savedContext]) return;
+    
+    NSManagedObjectContext *writerContext = self.writerContext;
+    [writerContext performBlock:^{
+        [writerContext mergeChangesFromContextDidSaveNotification:aNotification];
+    }];
+    
+    // Merging on the main queue directly, rather than with performBlock:,
+    // keeps this ahead of any completion block the worker dispatches to the
+    // main queue after saving.
+    NSSet *updatedObjects = [aNotification.userInfo objectForKey:NSUpdatedObjectsKey];
+    NSMutableArray *updatedObjectIDs = [NSMutableArray arrayWithCapacity:[updatedObjects count]];
+    for (NSManagedObject *managedObject in updatedObjects) {
+        [updatedObjectIDs addObject:managedObject.objectID];
+    }
+    
+    dispatch_async(dispatch_get_main_queue(), ^{
+        NSManagedObjectContext *mainContext = self.managedObjectContext;
+        if (!mainContext || (mainContext.parentContext != writerContext)) return;
         
-    } else if (document.documentState == UIDocumentStateClosed) {
-        // if document exists but is closed, open it
-        [document openWithCompletionHandler:^(BOOL success) {
-            if (success) {
-                self.managedObjectContext = document.managedObjectContext;
-                // if already open, no need to attempt populating the data.
-                if (documentIsReady) documentIsReady();
-            }
-        }];
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
         
-    } else {
-        // if document is already open try to use it
-        self.managedObjectContext = document.managedObjectContext;
-        // again already open, so no need to attempt populating the data.
-        if (documentIsReady) documentIsReady();
-    }
+        [mainContext mergeChangesFromContextDidSaveNotification:aNotification];
+        
+        // Only objects the main context has already registered, such as those
+        // fetched results controllers are tracking, need their new values.
+        // Refreshing them reports them as changed so fetched results
+        // controllers pick them up, and a fault stays a fault, so nothing is
+        // fetched on the main thread.
+        for (NSManagedObjectID *objectID in updatedObjectIDs) {
+            NSManagedObject *registeredObject = [mainContext objectRegisteredForID:objectID];
+            if (registeredObject) [mainContext refreshObject:registeredObject mergeChanges:YES];
+        }
+        
+        self.mainThreadMergeTime += CFAbsoluteTimeGetCurrent() - startTime;
+    });
+}
+
+- (void)managedObjectContextObjectsDidChange:(NSNotification *)aNotification
+{
+    if (self.autosaveScheduled || ![self.managedObjectContext hasChanges]) return;
+    
+    self.autosaveScheduled = YES;
+    [self performSelector:@selector(autosave) withObject:nil afterDelay:kAutosaveDelay];
+}
+
+- (void)saveBeforeSuspension:(NSNotification *)aNotification
+{
+    // User settings are small so write them to disk right away
+    [self flushUserSettings];
+    [[NSUserDefaults standardUserDefaults] synchronize];
+    
+    // Keep running long enough for the writer context to finish saving
+    UIApplication *application = [UIApplication sharedApplication];
+    __block UIBackgroundTaskIdentifier backgroundTask = [application beginBackgroundTaskWithExpirationHandler:^{
+        [application endBackgroundTask:backgroundTask];
+        backgroundTask = UIBackgroundTaskInvalid;
+    }];
+    
+    [self saveUserDocument:^{
+        if (backgroundTask != UIBackgroundTaskInvalid) {
+            [application endBackgroundTask:backgroundTask];
+            backgroundTask = UIBackgroundTaskInvalid;
+        }
+    }];
 }
 
 
@@ -413,6 +689,9 @@ static NSString *const kProfileConfiguredKey = @"kGRVProfileConfiguredKey";
  */
 - (void)registerDefaultSettings:(NSString *)phoneNumber;
 {
+    // Don't lose the settings changes of a previous user
+    [self flushUserSettings];
+    
     self.phoneNumber = phoneNumber; // cache phone number.
     
     // Create the preference defaults
@@ -425,7 +704,12 @@ static NSString *const kProfileConfiguredKey = @"kGRVProfileConfiguredKey";
     
     // Register the preference defaults
     [[NSUserDefaults standardUserDefaults] registerDefaults:userDefaults];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    
+    // Load the user's settings into memory, where they are read and written
+    // from now on.
+    NSDictionary *savedSettings = [[NSUserDefaults standardUserDefaults] dictionaryForKey:[self userSettingsKey]];
+    self.userSettings = [NSMutableDictionary dictionaryWithDictionary:appDefaults];
+    [self.userSettings addEntriesFromDictionary:savedSettings];
 }
 
 /**
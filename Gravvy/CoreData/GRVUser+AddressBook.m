@@ -33,6 +33,7 @@ static NSString *const kGRVAddressBookUserPhoneNumberKey = @"phoneNumber";
 {
     GRVUser *newUser = [NSEntityDescription insertNewObjectForEntityForName:@"GRVUser" inManagedObjectContext:context];
     newUser.phoneNumber = phoneNumber;
+    newUser.canonicalPhoneNumber = [GRVCoreDataImport canonicalIdentifier:phoneNumber];
     
     return newUser;
 }
@@ -110,7 +111,7 @@ static NSString *const kGRVAddressBookUserPhoneNumberKey = @"phoneNumber";
                                   inManagedObjectContext:context
                                                 forClass:[GRVUser class]
                                 usingAdditionalPredicate:nil
-                                 withObjectIdentifierKey:@"phoneNumber"
+                                 withObjectIdentifierKey:@"canonicalPhoneNumber"
                                     andDictIdentifierKey:kGRVAddressBookUserPhoneNumberKey
                                        usingCreateObject:^NSManagedObject *(NSDictionary *objectDictionary, NSManagedObjectContext *context) {
                                            NSString *phoneNumber = [objectDictionary objectForKey:kGRVAddressBookUserPhoneNumberKey];
@@ -14,6 +14,7 @@
  *
  * Property             Purpose
  * avatarThumbnailURL   URL where thumbnail image can be downloaded
+ * canonicalPhoneNumber phoneNumber in canonical form, used for indexed lookups
  * favorited            Is user a recent contact of app user?
  * fullName             User's full name
  * phoneNumber          User's unique identifier, an E.164 formatted phone number.
@@ -100,6 +101,15 @@
  */
 + (void)refreshLikersOfVideo:(GRVVideo *)video withCompletion:(void (^)())likersAreRefreshed;
 
+/**
+ * Set the canonicalPhoneNumber @property of all users that don't have one.
+ * This is only needed for stores migrated from before canonicalPhoneNumber
+ * existed.
+ *
+ * @param context   handle to database
+ */
++ (void)updateCanonicalPhoneNumbersInManagedObjectContext:(NSManagedObjectContext *)context;
+
 #pragma mark - Instance Methods
 /**
  * Download thumbnail image data of user if not already done and there is a
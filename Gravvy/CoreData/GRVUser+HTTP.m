@@ -8,9 +8,9 @@
 
 #import "GRVUser+HTTP.h"
 #import "GRVUserThumbnail+Create.h"
-#import "GRVFormatterUtils.h"
 #import "GRVConstants.h"
 #import "GRVCoreDataImport.h"
+#import "GRVAttributeMapping.h"
 #import "GRVHTTPManager.h"
 #import "GRVContact.h"
 #import "GRVAccountManager.h"
@@ -22,6 +22,22 @@
 
 #pragma mark - Class Methods
 #pragma mark Private
+/**
+ * Mapping of a user's JSON attributes, other than the phone number
+ * identifier and avatar thumbnail URL which need special handling.
+ */
++ (GRVAttributeMapping *)attributeMapping
+{
+    static GRVAttributeMapping *mapping = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mapping = [GRVAttributeMapping mappingWithAttributes:@[
+            @[kGRVRESTUserFullNameKey,  @"fullName",    @(GRVAttributeTypeString)],
+            @[kGRVRESTUserUpdatedAtKey, @"updatedAt",   @(GRVAttributeTypeDate)]]];
+    });
+    return mapping;
+}
+
 /**
  * Create a new user
  *
@@ -36,18 +52,12 @@
     GRVUser *newUser = [NSEntityDescription insertNewObjectForEntityForName:@"GRVUser"
                                                      inManagedObjectContext:context];
     
-    NSDateFormatter *rfc3339DateFormatter = [GRVFormatterUtils generateRFC3339DateFormatter];
-    
-    // Setup all the dates
-    NSString *rfc3339UpdatedAt = [[userDictionary objectForKey:kGRVRESTUserUpdatedAtKey] description];
-    NSDate *updatedAt = [rfc3339DateFormatter dateFromString:rfc3339UpdatedAt];
-    
     // Get and save dictionary attributes being sure call the description method
     // incase dictionary values are NULL
     newUser.avatarThumbnailURL = [[userDictionary objectForKey:kGRVRESTUserAvatarThumbnailKey] description];
-    newUser.fullName = [[userDictionary objectForKey:kGRVRESTUserFullNameKey] description];
-    newUser.updatedAt = updatedAt;
+    [[GRVUser attributeMapping] applyToObject:newUser fromDictionary:userDictionary];
     newUser.phoneNumber = [[userDictionary objectForKey:kGRVRESTUserPhoneNumberKey] description];
+    newUser.canonicalPhoneNumber = [GRVCoreDataImport canonicalIdentifier:newUser.phoneNumber];
     
     if ([[GRVAccountManager sharedManager].phoneNumber isEqualToString:newUser.phoneNumber]) {
         newUser.relationshipType = @(GRVUserRelationshipTypeMe);
@@ -72,37 +82,16 @@
 + (void)syncUser:(GRVUser *)existingUser
     withUserInfo:(NSDictionary *)userDictionary
 {
-    NSDateFormatter *rfc3339DateFormatter = [GRVFormatterUtils generateRFC3339DateFormatter];
-    
-    // get updatedAt date which is used for sync
-    NSString *rfc3339UpdatedAt = [[userDictionary objectForKey:kGRVRESTUserUpdatedAtKey] description];
-    NSDate *updatedAt = [rfc3339DateFormatter dateFromString:rfc3339UpdatedAt];
+    // Only attributes that have changed get written
+    [[GRVUser attributeMapping] applyToObject:existingUser fromDictionary:userDictionary];
     
-    // Get avatarThumbnailURL to be used for syncing in the event of CDN changes
+    // only change thumbnail data if thumbnail URL changes, such as on CDN changes
     NSString *avatarThumbnailURL = [userDictionary[kGRVRESTUserAvatarThumbnailKey] description];
-    
-    // only perform a sync if there are any changes and also account for CDN changes
-    if (![updatedAt isEqualToDate:existingUser.updatedAt] ||
-        ![avatarThumbnailURL isEqualToString:existingUser.avatarThumbnailURL]) {
-        
-        // get properties that will be sync'd
-        NSString *fullName = [userDictionary[kGRVRESTUserFullNameKey] description];
-        
-        // only update fullName if it changed
-        if (![fullName isEqualToString:existingUser.fullName]) {
-            existingUser.fullName = fullName;
-        }
-        
-        // only change thumbnail data if thumbnail URL changes
-        if (![avatarThumbnailURL isEqualToString:existingUser.avatarThumbnailURL]) {
-            existingUser.avatarThumbnailURL = avatarThumbnailURL;
-            [GRVUserThumbnail userThumbnailWithImage:nil
-                                      associatedUser:existingUser
-                              inManagedObjectContext:existingUser.managedObjectContext];
-        }
-        
-        // finally update updatedAt
-        existingUser.updatedAt = updatedAt;
+    if (![avatarThumbnailURL isEqualToString:existingUser.avatarThumbnailURL]) {
+        existingUser.avatarThumbnailURL = avatarThumbnailURL;
+        [GRVUserThumbnail userThumbnailWithImage:nil
+                                  associatedUser:existingUser
+                          inManagedObjectContext:existingUser.managedObjectContext];
     }
     
     // Ensure relationship type is right
@@ -139,12 +128,12 @@
         // Get all unique identifier values from the object dictionaries.
         NSMutableArray *phoneNumbers = [[NSMutableArray alloc] init];
         for (NSDictionary *userDictionary in userDicts) {
-            NSString *phoneNumber = [[userDictionary valueForKeyPath:kGRVRESTUserPhoneNumberKey] description];
+            NSString *phoneNumber = [GRVCoreDataImport canonicalIdentifier:[userDictionary valueForKeyPath:kGRVRESTUserPhoneNumberKey]];
             [phoneNumbers addObject:phoneNumber];
         }
         
         NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:@"GRVUser"];
-        fetchRequest.predicate = [NSPredicate predicateWithFormat:@"(favorited == YES) AND (NOT (phoneNumber IN[c] %@))", phoneNumbers];
+        fetchRequest.predicate = [NSPredicate predicateWithFormat:@"(favorited == YES) AND (NOT (canonicalPhoneNumber IN %@))", phoneNumbers];
     } else {
         fetchRequest.predicate = [NSPredicate predicateWithFormat:@"favorited == YES"];
     }
@@ -186,7 +175,7 @@
                                   inManagedObjectContext:context
                                                 forClass:[GRVUser class]
                                 usingAdditionalPredicate:nil
-                                 withObjectIdentifierKey:@"phoneNumber"
+                                 withObjectIdentifierKey:@"canonicalPhoneNumber"
                                     andDictIdentifierKey:kGRVRESTUserPhoneNumberKey
                                        usingCreateObject:^NSManagedObject *(NSDictionary *objectDictionary, NSManagedObjectContext *context) {
                                            return [GRVUser newUserWithUserInfo:objectDictionary inManagedObjectContext:context];
@@ -204,7 +193,7 @@
                             inManagedObjectContext:context
                                           forClass:[GRVUser class]
                                      withPredicate:^NSPredicate *{
-                                         return [NSPredicate predicateWithFormat:@"phoneNumber ==[c] %@", phoneNumber];
+                                         return [NSPredicate predicateWithFormat:@"canonicalPhoneNumber == %@", [GRVCoreDataImport canonicalIdentifier:phoneNumber]];
                                          
                                      } usingCreateObject:nil
                                         syncObject:nil];
@@ -236,18 +225,16 @@
                              // Update users that are no longer recent contacts
                              [GRVUser unmarkFavoritedUsersNotInUserInfoArray:usersJSON inManagedObjectContext:workerContext];
                              
-                             // Refresh the corresponding users
-                             NSArray *favoritedUsers = [GRVUser usersWithUserInfoArray:usersJSON inManagedObjectContext:workerContext];
-                             for (GRVUser *user in favoritedUsers) {
-                                 user.favorited = @(YES);
-                             }
-                            
-                             // Push changes up to main thread context. Alternatively,
-                             // could turn all objects into faults but this is easier.
-                             [workerContext save:NULL];
-                             
-                             // ensure context is cleaned up for next use.
-                             [workerContext reset];
+                             // Refresh the corresponding users in batches, each
+                             // of which is saved and faulted out before the next.
+                             GRVCoreDataImportStatistics *statistics = [GRVCoreDataImport importObjects:usersJSON inBatchesOfSize:kGRVCoreDataImportBatchSize inManagedObjectContext:workerContext usingImportBatch:^NSArray *(NSArray *batch, NSManagedObjectContext *context) {
+                                 NSArray *favoritedUsers = [GRVUser usersWithUserInfoArray:batch inManagedObjectContext:context];
+                                 for (GRVUser *user in favoritedUsers) {
+                                     user.favorited = @(YES);
+                                 }
+                                 return favoritedUsers;
+                             }];
+                             [GRVCoreDataImport setLastImportStatistics:statistics forClass:[GRVUser class]];
                              
                              // finally execute the callback block on main queue
                              dispatch_async(dispatch_get_main_queue(), ^{
@@ -319,6 +306,18 @@
                  }];
 }
 
++ (void)updateCanonicalPhoneNumbersInManagedObjectContext:(NSManagedObjectContext *)context
+{
+    NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:@"GRVUser"];
+    request.predicate = [NSPredicate predicateWithFormat:@"canonicalPhoneNumber == nil"];
+    
+    NSError *error;
+    NSArray *users = [context executeFetchRequest:request error:&error];
+    for (GRVUser *user in users) {
+        user.canonicalPhoneNumber = [GRVCoreDataImport canonicalIdentifier:user.phoneNumber];
+    }
+}
+
 #pragma mark - Instance Methods
 #pragma mark Public
 - (void)updateThumbnailImage
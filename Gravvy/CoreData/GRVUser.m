@@ -18,6 +18,7 @@
 @implementation GRVUser
 
 @dynamic avatarThumbnailURL;
+@dynamic canonicalPhoneNumber;
 @dynamic favorited;
 @dynamic fullName;
 @dynamic phoneNumber;
@@ -8,14 +8,23 @@
 
 #import "GRVVideo.h"
 
+@class GRVRefreshTrace;
+
 /**
  * Using this file as a location to document the GRVVideo model which is what
  * represents a video.
  *
  * Property                 Purpose
+ * canonicalHashKey         hashKey in canonical form, used for indexed lookups
+ * clipsCount               Number of associated clips. This is maintained on
+ *                          clip import and deletion so feed fetches can filter
+ *                          on it without counting the clips relationship.
  * createdAt                Video creation date
  * currentClipIndex         Index of current clip being played in collection of
  *                          associated ordered clips.
+ * fingerprint              Fingerprint of the server's representation of the
+ *                          video when it was last imported, so a refresh can
+ *                          skip it if unchanged. Local changes clear it.
  * hashKey                  Video's unique identifier
  * likesCount               Number of likes
  * membership               Is user a member/invited to this video.
@@ -114,6 +123,21 @@
  */
 + (void)refreshVideos:(BOOL)reorder withCompletion:(void (^)())videosAreRefreshed;
 
+/**
+ * Refresh the videos which the authenticated user is a member of, recording
+ * the request, import, reorder and save stages in a trace. The merge stage is
+ * begun after the save, for the caller to end once on the main queue.
+ *
+ * @param reorder               Should the videos be re-ordered after refresh?
+ * @param trace                 Trace of the refresh, or nil to not trace it.
+ *      It's marked failed if the videos couldn't be refreshed.
+ * @param videosAreRefreshed    block to be called after refreshing videos. This
+ *      is run on the main queue.
+ *
+ * @see refreshVideos:withCompletion:
+ */
++ (void)refreshVideos:(BOOL)reorder trace:(GRVRefreshTrace *)trace withCompletion:(void (^)())videosAreRefreshed;
+
 /**
  * Set the order @property of the given collection of videos using the following
  * logic
@@ -123,9 +147,30 @@
  * - score DESC: rank indicator
  * - updatedAt DESC: in the unlikely event the score isn't unique, video with 
  *   recent update wins
+ *
+ * Only videos whose position changed have their order rewritten.
+ *
+ * @see GRVVideoRanking
  */
 + (void)reorderVideos:(NSArray *)videos;
 
+/**
+ * Set the clipsCount @property of all videos whose clips haven't been counted.
+ * This is only needed for stores migrated from before clipsCount existed, where
+ * it defaults to 0.
+ *
+ * @param context   handle to database
+ */
++ (void)updateClipsCountsInManagedObjectContext:(NSManagedObjectContext *)context;
+
+/**
+ * Set the canonicalHashKey @property of all videos that don't have one. This
+ * is only needed for stores migrated from before canonicalHashKey existed.
+ *
+ * @param context   handle to database
+ */
++ (void)updateCanonicalHashKeysInManagedObjectContext:(NSManagedObjectContext *)context;
+
 
 #pragma mark - Instance Methods
 /**
@@ -139,21 +184,48 @@
 - (BOOL)hasPendingNotifications;
 
 /**
- * Record play of this video on the server and locally
+ * The clip at the video's currentClipIndex, clamped to the last clip. This is
+ * an O(1) lookup in the ordered clips relationship.
  *
- * @param videoIsPlayed block to be called after playing the video
+ * @return current clip, or nil if the video has no clips.
+ */
+- (GRVClip *)currentClip;
+
+/**
+ * Put the video's clips in ascending clip order. This is a no-op if they are
+ * already ordered, so it's safe to call after every clip import.
+ */
+- (void)sortClips;
+
+/**
+ * Set clipsCount to the number of clips the video has, ignoring any clips
+ * pending deletion. This is a no-op if the count hasn't changed, so it's safe
+ * to call after every clip import or deletion.
+ */
+- (void)updateClipsCount;
+
+/**
+ * Record play of this video on the server and locally.
+ * The play is sent to the server by GRVVideoMutationQueue, collapsed with
+ * other plays of this video.
+ *
+ * @param videoIsPlayed block to be called after the play is recorded
  */
 - (void)play:(void (^)())videoIsPlayed;
 
 /**
- * Record like/unlike of this video on the server and locally
+ * Record like/unlike of this video locally, and on the server.
+ * The like state is updated immediately and sent to the server by
+ * GRVVideoMutationQueue, so toggles that cancel out are never sent.
  *
- * @param likeIsToggled   block to be called after toggling the like of a video
+ * @param likeIsToggled   block to be called after the like state is synced
+ *      with the server, or reverted on failure
  */
 - (void)toggleLike:(void (^)())likeIsToggled;
 
 /**
- * Clear notifications of this video on the server and locally
+ * Clear notifications of this video on the server and locally.
+ * The clear is sent to the server by GRVVideoMutationQueue.
  * 
  * @param notificationsCleared  block to be called after clearing notifications
  */
@@ -189,11 +261,17 @@
 /**
  * Delete a given collection of clips from this video locally and on the server.
  *
+ * At most kGRVClipDeleteMaxConcurrentRequests delete requests are in flight at
+ * once. Clips deleted on the server are deleted locally together, once all
+ * requests have finished.
+ *
  * @param clips             Array of clip objects to be deleted
- * @param clipsAreDeleted   block to be called after deleting clips. It takes two
- *      arguments, the error object and the response object
+ * @param clipsAreDeleted   block to be called after deleting clips. It takes
+ *      three arguments: the error object and response object of a failed
+ *      delete, if any, and a dictionary of the error of each clip that couldn't
+ *      be deleted, keyed by clip identifier.
  */
-- (void)deleteClips:(NSArray *)clips withCompletion:(void (^)(NSError *error, id responseObject))clipsAreDeleted;
+- (void)deleteClips:(NSArray *)clips withCompletion:(void (^)(NSError *error, id responseObject, NSDictionary *clipErrors))clipsAreDeleted;
 
 /**
  * Refresh this video.
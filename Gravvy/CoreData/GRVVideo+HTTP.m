@@ -11,17 +11,94 @@
 #import "GRVClip+HTTP.h"
 #import "GRVMember.h"
 #import "GRVCoreDataImport.h"
+#import "GRVAttributeMapping.h"
 #import "GRVFormatterUtils.h"
 #import "GRVRestUtils.h"
 #import "GRVConstants.h"
 #import "GRVHTTPManager.h"
+#import "GRVJSONListReader.h"
 #import "GRVModelManager.h"
 #import "GRVAccountManager.h"
+#import "GRVVideoMutationQueue.h"
+#import "GRVRefreshTrace.h"
+#import "GRVVideoRanking.h"
 
 @implementation GRVVideo (HTTP)
 
 #pragma mark - Class Methods
 #pragma mark Private
+/**
+ * Mapping of the attributes in the minimal JSON representation of a video, as
+ * found in the activity stream.
+ */
++ (GRVAttributeMapping *)minimalAttributeMapping
+{
+    static GRVAttributeMapping *mapping = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mapping = [GRVAttributeMapping mappingWithAttributes:@[
+            @[kGRVRESTVideoTitleKey,                @"title",                   @(GRVAttributeTypeString)],
+            @[kGRVRESTVideoPhotoSmallThumbnailKey,  @"photoSmallThumbnailURL",  @(GRVAttributeTypeString)]]];
+    });
+    return mapping;
+}
+
+/**
+ * Mapping of the attributes in the full JSON representation of a video that
+ * only change along with the video's updatedAt.
+ */
++ (GRVAttributeMapping *)fullAttributeMapping
+{
+    static GRVAttributeMapping *mapping = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mapping = [GRVAttributeMapping mappingWithAttributes:@[
+            @[kGRVRESTVideoCreatedAtKey,            @"createdAt",               @(GRVAttributeTypeDate)],
+            @[kGRVRESTVideoLikedKey,                @"liked",                   @(GRVAttributeTypeBoolean)],
+            @[kGRVRESTVideoLikesCountKey,           @"likesCount",              @(GRVAttributeTypeNumber)],
+            @[kGRVRESTVideoUnseenClipsCountKey,     @"unseenClipsCount",        @(GRVAttributeTypeNumber)],
+            @[kGRVRESTVideoUnseenLikesCountKey,     @"unseenLikesCount",        @(GRVAttributeTypeNumber)],
+            @[kGRVRESTVideoPhotoSmallThumbnailKey,  @"photoSmallThumbnailURL",  @(GRVAttributeTypeString)],
+            @[kGRVRESTVideoPhotoThumbnailKey,       @"photoThumbnailURL",       @(GRVAttributeTypeString)],
+            @[kGRVRESTVideoPlaysCountKey,           @"playsCount",              @(GRVAttributeTypeNumber)],
+            @[kGRVRESTVideoTitleKey,                @"title",                   @(GRVAttributeTypeString)],
+            @[kGRVRESTVideoUpdatedAtKey,            @"updatedAt",               @(GRVAttributeTypeDate)]]];
+    });
+    return mapping;
+}
+
+/**
+ * Mapping of the attributes in the full JSON representation of a video that
+ * change independent of the video's updatedAt.
+ */
++ (GRVAttributeMapping *)participationAttributeMapping
+{
+    static GRVAttributeMapping *mapping = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mapping = [GRVAttributeMapping mappingWithAttributes:@[
+            @[kGRVRESTVideoMembershipKey,           @"membership",              @(GRVAttributeTypeNumber)],
+            @[kGRVRESTVideoScoreKey,                @"score",                   @(GRVAttributeTypeNumber)]]];
+    });
+    return mapping;
+}
+
+/**
+ * Mapping of URL attributes, which can change with the CDN independent of the
+ * video's updatedAt.
+ */
++ (GRVAttributeMapping *)URLAttributeMapping
+{
+    static GRVAttributeMapping *mapping = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mapping = [GRVAttributeMapping mappingWithAttributes:@[
+            @[kGRVRESTVideoPhotoSmallThumbnailKey,  @"photoSmallThumbnailURL",  @(GRVAttributeTypeString)],
+            @[kGRVRESTVideoPhotoThumbnailKey,       @"photoThumbnailURL",       @(GRVAttributeTypeString)]]];
+    });
+    return mapping;
+}
+
 /**
  * Create a new video
  *
@@ -33,39 +110,23 @@
 {
     GRVVideo *newVideo = [NSEntityDescription insertNewObjectForEntityForName:@"GRVVideo" inManagedObjectContext:context];
     
-    NSDateFormatter *rfc3339DateFormatter = [GRVFormatterUtils generateRFC3339DateFormatter];
-    
-    // Setup all the dates
-    NSString *rfc3339CreatedAt = [[videoDictionary objectForKey:kGRVRESTVideoCreatedAtKey] description];
-    NSDate *createdAt = [rfc3339DateFormatter dateFromString:rfc3339CreatedAt];
-    
-    NSString *rfc3339UpdatedAt = [[videoDictionary objectForKey:kGRVRESTVideoUpdatedAtKey] description];
-    NSDate *updatedAt = [rfc3339DateFormatter dateFromString:rfc3339UpdatedAt];
-    
     // Get and save dictionary attributes being sure call the description method
     // incase dictionary values are NULL
     newVideo.hashKey = [[videoDictionary objectForKey:kGRVRESTVideoHashKeyKey] description];
-    newVideo.title = [[videoDictionary objectForKey:kGRVRESTVideoTitleKey] description];
-    newVideo.photoSmallThumbnailURL = [[videoDictionary objectForKey:kGRVRESTVideoPhotoSmallThumbnailKey] description];
+    newVideo.canonicalHashKey = [GRVCoreDataImport canonicalIdentifier:newVideo.hashKey];
     newVideo.currentClipIndex = @(0);
     
     newVideo.order = @(kGRVVideoOrderNew);
     
+    [[GRVVideo minimalAttributeMapping] applyToObject:newVideo fromDictionary:videoDictionary];
+    
     // Optional fields not present in the minimal JSON retrieved by the activity
     // stream might not be present so don't setup those fields or set an updatedAt
     // timestamp. The sync method works properly when we get the full JSON object.
     if ([videoDictionary objectForKey:kGRVRESTVideoPhotoThumbnailKey]) {
         // Working with a full JSON representation
-        newVideo.createdAt = createdAt;
-        newVideo.liked = @([[videoDictionary objectForKey:kGRVRESTVideoLikedKey] boolValue]);
-        newVideo.likesCount = [videoDictionary objectForKey:kGRVRESTVideoLikesCountKey];
-        newVideo.membership = [videoDictionary objectForKey:kGRVRESTVideoMembershipKey];
-        newVideo.unseenClipsCount = [videoDictionary objectForKey:kGRVRESTVideoUnseenClipsCountKey];
-        newVideo.unseenLikesCount = [videoDictionary objectForKey:kGRVRESTVideoUnseenLikesCountKey];
-        newVideo.photoThumbnailURL = [[videoDictionary objectForKey:kGRVRESTVideoPhotoThumbnailKey] description];
-        newVideo.playsCount = [videoDictionary objectForKey:kGRVRESTVideoPlaysCountKey];
-        newVideo.score = [videoDictionary objectForKey:kGRVRESTVideoScoreKey];
-        newVideo.updatedAt = updatedAt;
+        [[GRVVideo fullAttributeMapping] applyToObject:newVideo fromDictionary:videoDictionary];
+        [[GRVVideo participationAttributeMapping] applyToObject:newVideo fromDictionary:videoDictionary];
         
         [newVideo updateParticipation];
         
@@ -73,6 +134,10 @@
         // Setup the clips
         NSArray *clipDicts = [videoDictionary objectForKey:kGRVRESTVideoClipsKey];
         [GRVClip clipsWithClipInfoArray:clipDicts associatedVideo:newVideo inManagedObjectContext:context];
+        [newVideo sortClips];
+        [newVideo updateClipsCount];
+        
+        newVideo.fingerprint = [GRVCoreDataImport fingerprintForObjectInfo:videoDictionary];
     }
     
     // Setup the relationships
@@ -87,6 +152,10 @@
  * Update an existing video with a given video object from server
  * Note that we get our NSManagedObjectContext by asking the GRVVideo for it
  *
+ * A full JSON representation that's unchanged since the video was last synced
+ * with one, as determined by its fingerprint, is skipped along with its clips
+ * and owner.
+ *
  * @param existingVideo     Existing GRVVideo object to be updated
  * @param videoDictionary   Video object with all attributes from server
  */
@@ -94,6 +163,17 @@
     withVideoInfo:(NSDictionary *)videoDictionary
 {
     NSManagedObjectContext *context = existingVideo.managedObjectContext;
+    
+    BOOL fullRepresentation = ([videoDictionary objectForKey:kGRVRESTVideoPhotoThumbnailKey] != nil);
+    
+    // Nothing to sync if the server's representation hasn't changed since the
+    // last full sync
+    NSString *fingerprint = nil;
+    if (fullRepresentation) {
+        fingerprint = [GRVCoreDataImport fingerprintForObjectInfo:videoDictionary];
+        if ([GRVCoreDataImport isUnchangedObject:existingVideo withFingerprint:fingerprint]) return;
+    }
+    
     NSDateFormatter *rfc3339DateFormatter = [GRVFormatterUtils generateRFC3339DateFormatter];
     
     // get updatedAt date which is used for sync
@@ -108,69 +188,49 @@
         // Clip dictionaries only available if we have the full JSON representation
         [GRVClip deleteClipsNotInClipInfoArray:clipDicts associatedVideo:existingVideo inManagedObjectContext:context];
         [GRVClip clipsWithClipInfoArray:clipDicts associatedVideo:existingVideo inManagedObjectContext:context];
+        [existingVideo sortClips];
+        [existingVideo updateClipsCount];
     }
     
     // video might not have changed but video owner might have been updated
     GRVUser *owner = [GRVUser userWithUserInfo:[videoDictionary objectForKey:kGRVRESTVideoOwnerKey]
                         inManagedObjectContext:context];
     
-    // only perform a sync if there are any changes
+    BOOL changed = NO;
+    
+    // only perform a sync if there are any changes. Local changes (like a
+    // toggled like) are kept till the server's representation changes.
     if (![updatedAt isEqualToDate:existingVideo.updatedAt]) {
         
         // If this isn't a minimal JSON object, update all fields including the
         // owner which was set to a dummy value by the Activity Stream.
-        if ([videoDictionary objectForKey:kGRVRESTVideoPhotoThumbnailKey]) {
+        if (fullRepresentation) {
             // Working with a full JSON representation
-            
-            NSString *rfc3339CreatedAt = [[videoDictionary objectForKey:kGRVRESTVideoCreatedAtKey] description];
-            NSDate *createdAt = [rfc3339DateFormatter dateFromString:rfc3339CreatedAt];
-            
-            // Update properties that will be sync'd
-            existingVideo.createdAt = createdAt;
-            existingVideo.liked = @([[videoDictionary objectForKey:kGRVRESTVideoLikedKey] boolValue]);
-            existingVideo.likesCount = [videoDictionary objectForKey:kGRVRESTVideoLikesCountKey];
-            existingVideo.unseenClipsCount = [videoDictionary objectForKey:kGRVRESTVideoUnseenClipsCountKey];
-            existingVideo.unseenLikesCount = [videoDictionary objectForKey:kGRVRESTVideoUnseenLikesCountKey];
-            existingVideo.photoSmallThumbnailURL = [[videoDictionary objectForKey:kGRVRESTVideoPhotoSmallThumbnailKey] description];
-            existingVideo.photoThumbnailURL = [[videoDictionary objectForKey:kGRVRESTVideoPhotoThumbnailKey] description];
-            existingVideo.playsCount = [videoDictionary objectForKey:kGRVRESTVideoPlaysCountKey];
-            existingVideo.title = [[videoDictionary objectForKey:kGRVRESTVideoTitleKey] description];
-            existingVideo.updatedAt = updatedAt;
-            existingVideo.owner = owner;
+            [[GRVVideo fullAttributeMapping] applyToObject:existingVideo fromDictionary:videoDictionary];
+            if (existingVideo.owner != owner) existingVideo.owner = owner;
             
         } else {
             // Working with minimal JSON representation
-            NSString *title = [[videoDictionary objectForKey:kGRVRESTVideoTitleKey] description];
-            NSString *photoSmallThumbnailURL = [[videoDictionary objectForKey:kGRVRESTVideoPhotoSmallThumbnailKey] description];
-            
-            // Only update fields if they've changed
-            if (![title isEqualToString:existingVideo.title] || ![photoSmallThumbnailURL isEqualToString:existingVideo.photoSmallThumbnailURL]) {
-                existingVideo.title = title;
-                existingVideo.photoSmallThumbnailURL = photoSmallThumbnailURL;
-            }
+            changed = [[GRVVideo minimalAttributeMapping] applyToObject:existingVideo fromDictionary:videoDictionary];
         }
     }
     
     // Some changes happen independent of the updated_at time on the full JSON
     // representation
-    if ([videoDictionary objectForKey:kGRVRESTVideoPhotoThumbnailKey]) {
-        existingVideo.membership = [videoDictionary objectForKey:kGRVRESTVideoMembershipKey];
-        existingVideo.score = [videoDictionary objectForKey:kGRVRESTVideoScoreKey];
-        
+    if (fullRepresentation) {
+        [[GRVVideo participationAttributeMapping] applyToObject:existingVideo fromDictionary:videoDictionary];
         [existingVideo updateParticipation];
     }
     
     // Account for CDN changes on URLs
-    NSString *photoSmallThumbnailURL = [[videoDictionary objectForKey:kGRVRESTVideoPhotoSmallThumbnailKey] description];
-    NSString *photoThumbnailURL = [[videoDictionary objectForKey:kGRVRESTVideoPhotoThumbnailKey] description];
-    
-    if ([photoThumbnailURL length] && ![existingVideo.photoThumbnailURL isEqualToString:photoThumbnailURL]) {
-        // We of course check that this is also a full JSON representation when
-        // checking for URL changes
-        existingVideo.photoThumbnailURL = photoThumbnailURL;
-    }
-    if (![existingVideo.photoSmallThumbnailURL isEqualToString:photoSmallThumbnailURL] ) {
-        existingVideo.photoSmallThumbnailURL = photoSmallThumbnailURL;
+    changed = [[GRVVideo URLAttributeMapping] applyToObject:existingVideo fromDictionary:videoDictionary] || changed;
+    
+    // Remember what a full sync was done with. Writes from a minimal
+    // representation mean the video no longer matches its last full sync.
+    if (fullRepresentation) {
+        if (![existingVideo.fingerprint isEqualToString:fingerprint]) existingVideo.fingerprint = fingerprint;
+    } else if (changed && existingVideo.fingerprint) {
+        existingVideo.fingerprint = nil;
     }
 }
 
@@ -189,7 +249,7 @@
                                   inManagedObjectContext:context
                                                 forClass:[GRVVideo class]
                                 usingAdditionalPredicate:nil
-                                 withObjectIdentifierKey:@"hashKey"
+                                 withObjectIdentifierKey:@"canonicalHashKey"
                                     andDictIdentifierKey:kGRVRESTVideoHashKeyKey];
 }
 
@@ -204,8 +264,8 @@
                                      withPredicate:^NSPredicate *{
                                          // get the video object's unique identifier
                                          // call description incase dictionary value is NULL
-                                         NSString *hashKey = [[videoDictionary objectForKey:kGRVRESTVideoHashKeyKey] description];
-                                         return [NSPredicate predicateWithFormat:@"hashKey ==[c] %@", hashKey];
+                                         NSString *hashKey = [GRVCoreDataImport canonicalIdentifier:[videoDictionary objectForKey:kGRVRESTVideoHashKeyKey]];
+                                         return [NSPredicate predicateWithFormat:@"canonicalHashKey == %@", hashKey];
                                          
                                      } usingCreateObject:^NSManagedObject *(NSDictionary *objectDictionary, NSManagedObjectContext *context) {
                                          return [GRVVideo newVideoWithVideoInfo:objectDictionary inManagedObjectContext:context];
@@ -222,7 +282,7 @@
                                   inManagedObjectContext:context
                                                 forClass:[GRVVideo class]
                                 usingAdditionalPredicate:nil
-                                 withObjectIdentifierKey:@"hashKey"
+                                 withObjectIdentifierKey:@"canonicalHashKey"
                                     andDictIdentifierKey:kGRVRESTVideoHashKeyKey
                                        usingCreateObject:^NSManagedObject *(NSDictionary *objectDictionary, NSManagedObjectContext *context) {
                                            return [GRVVideo newVideoWithVideoInfo:objectDictionary inManagedObjectContext:context];
@@ -239,7 +299,7 @@
                             inManagedObjectContext:context
                                           forClass:[GRVVideo class]
                                      withPredicate:^NSPredicate *{
-                                         return [NSPredicate predicateWithFormat:@"hashKey ==[c] %@", videoHashKey];
+                                         return [NSPredicate predicateWithFormat:@"canonicalHashKey == %@", [GRVCoreDataImport canonicalIdentifier:videoHashKey]];
                                          
                                      }
                                  usingCreateObject:nil
@@ -288,73 +348,127 @@
 }
 
 + (void)refreshVideos:(BOOL)reorder withCompletion:(void (^)())videosAreRefreshed
+{
+    [GRVVideo refreshVideos:reorder trace:nil withCompletion:videosAreRefreshed];
+}
+
++ (void)refreshVideos:(BOOL)reorder trace:(GRVRefreshTrace *)trace withCompletion:(void (^)())videosAreRefreshed
 {
     // don't proceed if managedObjectContext isn't setup or user isn't authenticated
     if (![GRVModelManager sharedManager].managedObjectContext || ![GRVAccountManager sharedManager].isAuthenticated) {
         // execute the callback block
+        [trace markFailed];
+        if (videosAreRefreshed) videosAreRefreshed();
+        return;
+    }
+    
+    // Use worker context for background execution
+    NSManagedObjectContext *workerContext = [GRVModelManager sharedManager].workerContextVideo;
+    if (!workerContext) {
+        // No worker context available so execute callback block
+        [trace markFailed];
         if (videosAreRefreshed) videosAreRefreshed();
         return;
     }
     
+    // The response is read, and the callbacks executed, on the worker
+    // context's queue.
     GRVHTTPManager *httpManager = [GRVHTTPManager sharedManager];
+    [trace beginStage:GRVRefreshTraceStageRequest];
     [httpManager request:GRVHTTPMethodGET
                   forURL:kGRVRESTUserVideos
               parameters:nil
-                 success:^(NSURLSessionDataTask *task, id responseObject) {
+  inManagedObjectContext:workerContext
+                 listKey:kGRVRESTListResultsKey
+                 success:^(NSURLSessionDataTask *task, GRVJSONListReader *videosJSON) {
+                     [trace endStage:GRVRefreshTraceStageRequest];
                      
-                     // get array of video dictionaries in response
-                     NSArray *videosJSON = [responseObject objectForKey:kGRVRESTListResultsKey];
-                     // Use worker context for background execution
-                     NSManagedObjectContext *workerContext = [GRVModelManager sharedManager].workerContextVideo;
-                     if (workerContext) {
-                         [workerContext performBlock:^{
-                             // Delete videos that you aren't still a member of
-                             [GRVVideo deleteVideosNotInVideoInfoArray:videosJSON inManagedObjectContext:workerContext];
-                             
-                             // Now refresh the videos
-                             NSArray *refreshedVideos = [GRVVideo videosWithVideoInfoArray:videosJSON inManagedObjectContext:workerContext];
-                             
-                             if (reorder) {
-                                 [GRVVideo reorderVideos:refreshedVideos];
-                             }
-                             
-                             // Push changes up to main thread context. Alternatively,
-                             // could turn all objects into faults but this is easier.
-                             [workerContext save:NULL];
-                             
-                             // ensure context is cleaned up for next use.
-                             [workerContext reset];
-                             
-                             // finally execute the callback block on main queue
-                             dispatch_async(dispatch_get_main_queue(), ^{
-                                 if (videosAreRefreshed) videosAreRefreshed();
-                             });
-                         }];
-                         
+                     // Refresh the videos in batches, each of which is parsed
+                     // from the response, saved and faulted out before the
+                     // next. Hold on to just their identifiers.
+                     NSMutableArray *videoIdentifiers = [NSMutableArray array];
+                     [trace beginStage:GRVRefreshTraceStageImport];
+                     GRVCoreDataImportStatistics *statistics = [GRVCoreDataImport importObjectsFromEnumerator:videosJSON inBatchesOfSize:kGRVCoreDataImportBatchSize inManagedObjectContext:workerContext usingImportBatch:^NSArray *(NSArray *batch, NSManagedObjectContext *context) {
+                         for (NSDictionary *videoDictionary in batch) {
+                             id hashKey = [videoDictionary objectForKey:kGRVRESTVideoHashKeyKey];
+                             if (hashKey) [videoIdentifiers addObject:@{kGRVRESTVideoHashKeyKey : hashKey}];
+                         }
+                         return [GRVVideo videosWithVideoInfoArray:batch inManagedObjectContext:context];
+                     }];
+                     [GRVCoreDataImport setLastImportStatistics:statistics forClass:[GRVVideo class]];
+                     
+                     // Delete videos that you aren't still a member of, but
+                     // only if the entire list could be read.
+                     if (!videosJSON.error) {
+                         [GRVVideo deleteVideosNotInVideoInfoArray:videoIdentifiers inManagedObjectContext:workerContext];
                      } else {
-                         // No worker context available so execute callback block
-                         if (videosAreRefreshed) videosAreRefreshed();
+                         [trace markFailed];
+                     }
+                     [trace endStage:GRVRefreshTraceStageImport];
+                     
+                     if (reorder) {
+                         [trace beginStage:GRVRefreshTraceStageReorder];
+                         // Reordering needs all refreshed videos at once, but
+                         // just their sort attributes.
+                         NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:@"GRVVideo"];
+                         request.predicate = [NSPredicate predicateWithFormat:@"self IN %@", statistics.importedObjectIDs];
+                         NSArray *refreshedVideos = [workerContext executeFetchRequest:request error:NULL];
+                         [GRVVideo reorderVideos:refreshedVideos];
+                         [trace endStage:GRVRefreshTraceStageReorder];
                      }
+                     
+                     // Push changes to the store, from where they get merged
+                     // into the main thread context.
+                     [trace beginStage:GRVRefreshTraceStageSave];
+                     if ([workerContext hasChanges]) [workerContext save:NULL];
+                     [trace endStage:GRVRefreshTraceStageSave];
+                     [trace beginStage:GRVRefreshTraceStageMerge];
+                     
+                     // ensure context is cleaned up for next use.
+                     [workerContext reset];
+                     
+                     // finally execute the callback block on main queue
+                     dispatch_async(dispatch_get_main_queue(), ^{
+                         if (videosAreRefreshed) videosAreRefreshed();
+                     });
                  }
                  failure:^(NSURLSessionDataTask *task, NSError *error, id responseObject) {
-                     // do nothing but execute the callback block
-                     if (videosAreRefreshed) videosAreRefreshed();
+                     [trace endStage:GRVRefreshTraceStageRequest];
+                     [trace markFailed];
+                     // do nothing but execute the callback block on main queue
+                     dispatch_async(dispatch_get_main_queue(), ^{
+                         if (videosAreRefreshed) videosAreRefreshed();
+                     });
                  }];
 }
 
 + (void)reorderVideos:(NSArray *)videos
 {
-    NSSortDescriptor *participationSort = [NSSortDescriptor sortDescriptorWithKey:@"participation" ascending:NO];
-    NSSortDescriptor *unseenClipsCountSort = [NSSortDescriptor sortDescriptorWithKey:@"unseenClipsCount" ascending:NO];
-    NSSortDescriptor *unseenLikesCountSort = [NSSortDescriptor sortDescriptorWithKey:@"unseenLikesCount" ascending:NO];
-    NSSortDescriptor *scoreSort = [NSSortDescriptor sortDescriptorWithKey:@"score" ascending:NO];
-    NSSortDescriptor *updatedAtSort = [NSSortDescriptor sortDescriptorWithKey:@"updatedAt" ascending:NO];
-    
-    videos = [videos sortedArrayUsingDescriptors:@[participationSort, unseenClipsCountSort, unseenLikesCountSort, scoreSort, updatedAtSort]];
-    NSUInteger idx = 0;
+    [GRVVideoRanking rankVideos:videos];
+}
+
++ (void)updateClipsCountsInManagedObjectContext:(NSManagedObjectContext *)context
+{
+    NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:@"GRVVideo"];
+    request.predicate = [NSPredicate predicateWithFormat:@"(clipsCount == 0) AND (clips.@count > 0)"];
+    request.relationshipKeyPathsForPrefetching = @[@"clips"];
+    
+    NSError *error;
+    NSArray *videos = [context executeFetchRequest:request error:&error];
+    for (GRVVideo *video in videos) {
+        [video updateClipsCount];
+    }
+}
+
++ (void)updateCanonicalHashKeysInManagedObjectContext:(NSManagedObjectContext *)context
+{
+    NSFetchRequest *request = [NSFetchRequest fetchRequestWithEntityName:@"GRVVideo"];
+    request.predicate = [NSPredicate predicateWithFormat:@"canonicalHashKey == nil"];
+    
+    NSError *error;
+    NSArray *videos = [context executeFetchRequest:request error:&error];
     for (GRVVideo *video in videos) {
-        video.order = @(idx);
-        idx++;
+        video.canonicalHashKey = [GRVCoreDataImport canonicalIdentifier:video.hashKey];
     }
 }
 
@@ -366,18 +480,23 @@
  */
 - (void)updateParticipation
 {
-    
+    GRVVideoParticipation participation;
     if ([self isVideoOwner] && [self.playsCount integerValue] == 0) {
         // Check if video is just created by the user
         // TODO: add a time limit
-        self.participation = @(GRVVideoParticipationCreated);
+        participation = GRVVideoParticipationCreated;
 
     } else if ([self.membership integerValue] <= GRVVideoMembershipInvited) {
         // Have you been invited to the video and haven't viewed it yet?
-        self.participation = @(GRVVideoParticipationInvited);
+        participation = GRVVideoParticipationInvited;
     
     } else {
-        self.participation = @(GRVVideoParticipationDefault);
+        participation = GRVVideoParticipationDefault;
+    }
+    
+    // Only write a changed value, to not mark the video as updated
+    if (!self.participation || ([self.participation integerValue] != participation)) {
+        self.participation = @(participation);
     }
 }
 
@@ -394,69 +513,74 @@
             ([self.membership integerValue] <= GRVVideoMembershipInvited));
 }
 
-- (void)play:(void (^)())videoIsPlayed
+- (GRVClip *)currentClip
 {
-    NSString *videoDetailPlayURL = [GRVRestUtils videoDetailPlayURL:self.hashKey];
+    NSUInteger clipsCount = [self.clips count];
+    if (!clipsCount) return nil;
     
-    // Start by assume a successful operation for immediate user feedback
-    self.playsCount = @([self.playsCount integerValue]);
+    NSUInteger clipIndex = MIN([self.currentClipIndex unsignedIntegerValue], clipsCount-1);
+    return [self.clips objectAtIndex:clipIndex];
+}
+
+- (void)sortClips
+{
+    NSSortDescriptor *orderSd = [NSSortDescriptor sortDescriptorWithKey:@"order" ascending:YES];
+    NSArray *sortedClips = [self.clips sortedArrayUsingDescriptors:@[orderSd]];
     
-    [[GRVHTTPManager sharedManager] request:GRVHTTPMethodPUT forURL:videoDetailPlayURL parameters:nil success:^(NSURLSessionDataTask *task, id responseObject) {
-        // refresh video
-        self.playsCount = [responseObject objectForKey:kGRVRESTVideoPlaysCountKey];
-        if ([self.membership integerValue] <= GRVVideoMembershipInvited) {
-            self.membership = @(GRVVideoMembershipViewed);
-        }
-        if (videoIsPlayed) videoIsPlayed();
-    } failure:nil];
+    // Only touch the relationship if the order changed so we don't dirty an
+    // unchanged video
+    if (![sortedClips isEqualToArray:[self.clips array]]) {
+        self.clips = [NSOrderedSet orderedSetWithArray:sortedClips];
+    }
 }
 
-- (void)toggleLike:(void (^)())likeIsToggled
+- (void)updateClipsCount
+{
+    NSUInteger clipsCount = 0;
+    for (GRVClip *clip in self.clips) {
+        if (!clip.isDeleted) clipsCount++;
+    }
+    
+    // Only set the attribute if the count changed so we don't dirty an
+    // unchanged video
+    if ([self.clipsCount unsignedIntegerValue] != clipsCount) {
+        self.clipsCount = @(clipsCount);
+    }
+}
+
+- (void)play:(void (^)())videoIsPlayed
 {
-    NSString *videoDetailLikeURL = [GRVRestUtils videoDetailLikeURL:self.hashKey];
+    // Local changes mean the video no longer matches the server's last
+    // representation of it
+    if (self.fingerprint) self.fingerprint = nil;
     
+    // Plays are collapsed with others of this video and sent in a batch
+    [[GRVVideoMutationQueue sharedQueue] enqueuePlayOfVideo:self completion:videoIsPlayed];
+}
+
+- (void)toggleLike:(void (^)())likeIsToggled
+{
     // Start by assume a successful operation for immediate user feedback
     BOOL originalLiked = [self.liked boolValue];
     NSUInteger originalLikesCount = [self.likesCount integerValue];
     
     // if already liked, then unlike and vice-versa
     self.liked = @(!originalLiked);
-    GRVHTTPMethod method;
-    if (originalLiked) {
-        method = GRVHTTPMethodDELETE;
-        self.likesCount = @(originalLikesCount - 1);
-    } else {
-        method = GRVHTTPMethodPUT;
-        self.likesCount = @(originalLikesCount + 1);
-    }
-    
-    [[GRVHTTPManager sharedManager] request:method forURL:videoDetailLikeURL parameters:nil success:^(NSURLSessionDataTask *task, id responseObject) {
-        // refresh video
-        [self refreshVideo:nil];
-        if (likeIsToggled) likeIsToggled();
-        
-    } failure:^(NSURLSessionDataTask *task, NSError *error, id responseObject) {
-        // revert like action
-        self.liked = @(originalLiked);
-        self.likesCount = @(originalLikesCount);
-        if (likeIsToggled) likeIsToggled();
-    }];
+    self.likesCount = originalLiked ? @(originalLikesCount - 1) : @(originalLikesCount + 1);
+    if (self.fingerprint) self.fingerprint = nil;
+    
+    // The like is reconciled, or reverted, from the server's response when
+    // it's sent in a batch. Toggles that cancel out are never sent.
+    [[GRVVideoMutationQueue sharedQueue] enqueueLikeToggleOfVideo:self
+                                                         wasLiked:originalLiked
+                                                       likesCount:originalLikesCount
+                                                       completion:likeIsToggled];
 }
 
 - (void)clearNotifications:(void (^)())notificationsCleared
 {
-    NSString *videoDetailClearNotificationsURL = [GRVRestUtils videoDetailClearNotificationsURL:self.hashKey];
-    
-    
-    [[GRVHTTPManager sharedManager] request:GRVHTTPMethodPUT forURL:videoDetailClearNotificationsURL parameters:nil success:^(NSURLSessionDataTask *task, id responseObject) {
-        // clear video notification stats
-        self.unseenClipsCount = @(0);
-        self.unseenLikesCount = @(0);
-        if ([self.membership integerValue] <= GRVVideoMembershipInvited) {
-            self.membership = @(GRVVideoMembershipViewed);
-        }
-        if (notificationsCleared) notificationsCleared();
-    } failure:nil];
+    if (self.fingerprint) self.fingerprint = nil;
+    [[GRVVideoMutationQueue sharedQueue] enqueueClearNotificationsOfVideo:self completion:notificationsCleared];
 }
 
 - (void)revokeMembershipWithCompletion:(void (^)())membershipIsRevoked
@@ -513,6 +637,8 @@
     [[GRVHTTPManager sharedManager] request:GRVHTTPMethodDELETE forURL:videoClipDetailURL parameters:nil success:^(NSURLSessionDataTask *task, id responseObject) {
         // Perform a local hard-delete as the clip is gone on the server
         [clip.managedObjectContext deleteObject:clip];
+        [self updateClipsCount];
+        if (self.fingerprint) self.fingerprint = nil;
         if (clipIsDeleted) clipIsDeleted(nil, responseObject);
         
     } failure:^(NSURLSessionDataTask *task, NSError *error, id responseObject) {
@@ -520,33 +646,73 @@
     }];
 }
 
-- (void)deleteClips:(NSArray *)clips withCompletion:(void (^)(NSError *error, id responseObject))clipsAreDeleted
+- (void)deleteClips:(NSArray *)clips withCompletion:(void (^)(NSError *error, id responseObject, NSDictionary *clipErrors))clipsAreDeleted
 {
     NSUInteger clipsCount = [clips count];
     if (!clipsCount) {
-        if (clipsAreDeleted) clipsAreDeleted(nil, nil);
+        if (clipsAreDeleted) clipsAreDeleted(nil, nil, @{});
+        return;
     }
     
-    __block NSUInteger deletedClipsCount = 0;
+    NSMutableArray *pendingClips = [clips mutableCopy];
+    NSMutableArray *deletedClips = [NSMutableArray array];
+    NSMutableDictionary *clipErrors = [NSMutableDictionary dictionary];
+    __block NSUInteger finishedClipsCount = 0;
     __block NSError *deleteError = nil;
     __block id deleteResponseObject = nil;
     
-    for (GRVClip *clip in clips) {
-        [self deleteClip:clip withCompletion:^(NSError *error, id responseObject) {
-            // One more clip deleted (or at least we tried to)
-            deletedClipsCount++;
+    // Called as each clip's request finishes. Local deletions are applied all
+    // at once, after the last request, so observers see a single change.
+    void (^clipIsFinished)() = ^{
+        finishedClipsCount++;
+        if (finishedClipsCount < clipsCount) return;
+        
+        for (GRVClip *clip in deletedClips) {
+            [self.managedObjectContext deleteObject:clip];
+        }
+        [self.managedObjectContext processPendingChanges];
+        [self updateClipsCount];
+        if (self.fingerprint) self.fingerprint = nil;
+        
+        if (clipsAreDeleted) clipsAreDeleted(deleteError, deleteResponseObject, clipErrors);
+    };
+    
+    // Start the delete request of the next pending clip. Each finished request
+    // starts the next, which bounds the number of concurrent requests.
+    void (^__block __weak weakDeleteNextClip)();
+    void (^deleteNextClip)();
+    weakDeleteNextClip = deleteNextClip = ^{
+        GRVClip *clip = [pendingClips firstObject];
+        if (!clip) return;
+        [pendingClips removeObjectAtIndex:0];
+        
+        void (^strongDeleteNextClip)() = weakDeleteNextClip;
+        NSNumber *clipIdentifier = clip.identifier;
+        NSString *videoClipDetailURL = [GRVRestUtils videoClipDetailURL:self.hashKey clip:clipIdentifier];
+        
+        [[GRVHTTPManager sharedManager] request:GRVHTTPMethodDELETE forURL:videoClipDetailURL parameters:nil success:^(NSURLSessionDataTask *task, id responseObject) {
+            [deletedClips addObject:clip];
+            clipIsFinished();
+            strongDeleteNextClip();
             
-            if (error) {
-                // if there's an error log it here
+        } failure:^(NSURLSessionDataTask *task, NSError *error, id responseObject) {
+            // if you get a 404 error it means the clip is already gone from the
+            // server so delete it locally too
+            NSUInteger statusCode = [GRVHTTPManager statusCodeFromRequestFailure:error];
+            if (statusCode == GRVHTTPStatusCode404NotFound) {
+                [deletedClips addObject:clip];
+            } else {
+                if (clipIdentifier) [clipErrors setObject:error forKey:clipIdentifier];
                 deleteError = error;
                 deleteResponseObject = responseObject;
             }
-            
-            if (deletedClipsCount >= clipsCount) {
-                // Finally done with all the clips so execute callback
-                if (clipsAreDeleted) clipsAreDeleted(deleteError, deleteResponseObject);
-            }
+            clipIsFinished();
+            strongDeleteNextClip();
         }];
+    };
+    
+    for (NSUInteger i = 0; i < MIN(kGRVClipDeleteMaxConcurrentRequests, clipsCount); i++) {
+        deleteNextClip();
     }
 }
 
@@ -13,8 +13,11 @@
 
 @interface GRVVideo : NSManagedObject
 
+@property (nonatomic, retain) NSString * canonicalHashKey;
+@property (nonatomic, retain) NSNumber * clipsCount;
 @property (nonatomic, retain) NSDate * createdAt;
 @property (nonatomic, retain) NSNumber * currentClipIndex;
+@property (nonatomic, retain) NSString * fingerprint;
 @property (nonatomic, retain) NSString * hashKey;
 @property (nonatomic, retain) NSNumber * liked;
 @property (nonatomic, retain) NSNumber * likesCount;
@@ -31,7 +34,7 @@
 @property (nonatomic, retain) NSDate * updatedAt;
 @property (nonatomic, retain) NSSet *activitiesUsingAsObject;
 @property (nonatomic, retain) NSSet *activitiesUsingAsTarget;
-@property (nonatomic, retain) NSSet *clips;
+@property (nonatomic, retain) NSOrderedSet *clips;
 @property (nonatomic, retain) NSSet *members;
 @property (nonatomic, retain) GRVUser *owner;
 @property (nonatomic, retain) NSSet *likers;
@@ -49,10 +52,16 @@
 - (void)addActivitiesUsingAsTarget:(NSSet *)values;
 - (void)removeActivitiesUsingAsTarget:(NSSet *)values;
 
+- (void)insertObject:(GRVClip *)value inClipsAtIndex:(NSUInteger)idx;
+- (void)removeObjectFromClipsAtIndex:(NSUInteger)idx;
+- (void)insertClips:(NSArray *)value atIndexes:(NSIndexSet *)indexes;
+- (void)removeClipsAtIndexes:(NSIndexSet *)indexes;
+- (void)replaceObjectInClipsAtIndex:(NSUInteger)idx withObject:(GRVClip *)value;
+- (void)replaceClipsAtIndexes:(NSIndexSet *)indexes withClips:(NSArray *)values;
 - (void)addClipsObject:(GRVClip *)value;
 - (void)removeClipsObject:(GRVClip *)value;
-- (void)addClips:(NSSet *)values;
-- (void)removeClips:(NSSet *)values;
+- (void)addClips:(NSOrderedSet *)values;
+- (void)removeClips:(NSOrderedSet *)values;
 
 - (void)addMembersObject:(GRVMember *)value;
 - (void)removeMembersObject:(GRVMember *)value;
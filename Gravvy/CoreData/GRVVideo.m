@@ -15,8 +15,11 @@
 
 @implementation GRVVideo
 
+@dynamic canonicalHashKey;
+@dynamic clipsCount;
 @dynamic createdAt;
 @dynamic currentClipIndex;
+@dynamic fingerprint;
 @dynamic hashKey;
 @dynamic liked;
 @dynamic likesCount;
@@ -0,0 +1,101 @@
+//
+//  GRVVideoMutationQueue.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/26/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class GRVVideo;
+
+/**
+ * GRVVideoMutationQueue holds a video's plays, likes and notification clears
+ * till they're sent to the server in a flush. Mutations of the same video made
+ * between flushes are collapsed so each results in at most one request:
+ *      - Repeated plays are recorded as a single play.
+ *      - Like/unlike toggles are reduced to the final like state, and no
+ *        request is sent if that's what the server already has.
+ *      - Repeated notification clears are sent once.
+ *
+ * Local state is updated optimistically by the caller and reconciled from the
+ * server's responses, without refetching the video. A failed like is reverted.
+ *
+ * Mutations are flushed kGRVVideoMutationFlushDelay seconds after the first is
+ * enqueued, and when the app enters the background. Call flush when leaving a
+ * screen that makes mutations.
+ *
+ * @warning Use this on the main thread with videos in the main context.
+ */
+@interface GRVVideoMutationQueue : NSObject
+
+#pragma mark - Properties
+/**
+ * Measurements: number of mutations enqueued and number of requests sent to
+ * the server for them.
+ */
+@property (nonatomic, readonly) NSUInteger enqueuedMutationsCount;
+@property (nonatomic, readonly) NSUInteger sentRequestsCount;
+
+
+#pragma mark - Class Methods
+/**
+ * Single instance queue.
+ * It creates the instance if this hasn't been done or simply returns it.
+ *
+ * @return An initialized GRVVideoMutationQueue object.
+ */
++ (instancetype)sharedQueue;
+
+
+#pragma mark - Instance Methods
+/**
+ * Record a play of a video.
+ *
+ * @param video         Video that was played
+ * @param completion    Block to be called after the play is recorded on the
+ *      server and the video's plays count is updated.
+ */
+- (void)enqueuePlayOfVideo:(GRVVideo *)video completion:(void (^)())completion;
+
+/**
+ * Record a like/unlike toggle of a video whose `liked` and `likesCount` have
+ * already been updated locally.
+ *
+ * @param video         Video that was toggled
+ * @param wasLiked      Video's like state before the toggle
+ * @param likesCount    Video's likes count before the toggle
+ * @param completion    Block to be called after the video's like state is
+ *      synced with the server, or reverted on failure.
+ */
+- (void)enqueueLikeToggleOfVideo:(GRVVideo *)video
+                        wasLiked:(BOOL)wasLiked
+                      likesCount:(NSUInteger)likesCount
+                      completion:(void (^)())completion;
+
+/**
+ * Record a clear of a video's notifications.
+ *
+ * @param video         Video whose notifications are cleared
+ * @param completion    Block to be called after the notifications are cleared
+ *      on the server and the video's unseen counts are reset.
+ */
+- (void)enqueueClearNotificationsOfVideo:(GRVVideo *)video completion:(void (^)())completion;
+
+/**
+ * Send all enqueued mutations to the server now.
+ */
+- (void)flush;
+
+/**
+ * Reset the measurements.
+ */
+- (void)resetMeasurements;
+
+/**
+ * Summary of the measurements, for logging.
+ */
+- (NSString *)measurementsDescription;
+
+@end
@@ -0,0 +1,328 @@
+//
+//  GRVVideoMutationQueue.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/26/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVVideoMutationQueue.h"
+#import "GRVVideo+HTTP.h"
+#import "GRVHTTPManager.h"
+#import "GRVRestUtils.h"
+#import "GRVConstants.h"
+
+/**
+ * Collapsed mutations of a video waiting to be sent to the server.
+ */
+@interface GRVPendingVideoMutations : NSObject
+
+@property (strong, nonatomic) GRVVideo *video;
+
+@property (nonatomic) BOOL play;
+@property (strong, nonatomic) NSMutableArray *playCompletions;
+
+/**
+ * Has the like been toggled? If so, what's the server's like state and count
+ * it was toggled from? The video's current like state is the one to be sent.
+ */
+@property (nonatomic) BOOL likeToggled;
+@property (nonatomic) BOOL serverLiked;
+@property (nonatomic) NSUInteger serverLikesCount;
+@property (strong, nonatomic) NSMutableArray *likeCompletions;
+
+@property (nonatomic) BOOL clearNotifications;
+@property (strong, nonatomic) NSMutableArray *clearNotificationsCompletions;
+
+@end
+
+@implementation GRVPendingVideoMutations
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _playCompletions = [NSMutableArray array];
+        _likeCompletions = [NSMutableArray array];
+        _clearNotificationsCompletions = [NSMutableArray array];
+    }
+    return self;
+}
+
+@end
+
+
+@interface GRVVideoMutationQueue ()
+
+/**
+ * Pending mutations keyed by video hash key.
+ */
+@property (strong, nonatomic) NSMutableDictionary *pendingMutations;
+
+// redefine measurements as readwrite
+@property (nonatomic, readwrite) NSUInteger enqueuedMutationsCount;
+@property (nonatomic, readwrite) NSUInteger sentRequestsCount;
+
+@end
+
+@implementation GRVVideoMutationQueue
+
+#pragma mark - Class Methods
++ (instancetype)sharedQueue
+{
+    static GRVVideoMutationQueue *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[self alloc] initPrivate];
+    });
+    return sharedInstance;
+}
+
+/**
+ * Execute an array of completion blocks.
+ */
++ (void)callCompletions:(NSArray *)completions
+{
+    for (void (^completion)() in completions) {
+        completion();
+    }
+}
+
+
+#pragma mark - Initializers
+/*
+ * ideally we would make the designated initializer of the superclass call
+ *   the new designated initializer, but that doesn't make sense in this case.
+ * if a programmer calls [GRVVideoMutationQueue alloc] init], let him know the
+ *   error of his ways.
+ */
+- (instancetype)init
+{
+    @throw [NSException exceptionWithName:@"Singleton"
+                                   reason:@"Use +[GRVVideoMutationQueue sharedQueue]"
+                                 userInfo:nil];
+    return nil;
+}
+
+// here is the real (secret) initializer
+// this is the official designated initializer so call the designated
+// initializer of the superclass
+- (instancetype)initPrivate
+{
+    self = [super init];
+    if (self) {
+        _pendingMutations = [NSMutableDictionary dictionary];
+
+        // Don't leave mutations behind when the app might be suspended
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(flush)
+                                                     name:UIApplicationDidEnterBackgroundNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+
+#pragma mark - Instance Methods
+#pragma mark Private
+/**
+ * Get the pending mutations of a video, creating them if necessary, and
+ * schedule a flush if this is the first pending video.
+ */
+- (GRVPendingVideoMutations *)pendingMutationsOfVideo:(GRVVideo *)video
+{
+    self.enqueuedMutationsCount++;
+
+    GRVPendingVideoMutations *mutations = [self.pendingMutations objectForKey:video.hashKey];
+    if (!mutations) {
+        if (![self.pendingMutations count]) {
+            [self performSelector:@selector(flush) withObject:nil afterDelay:kGRVVideoMutationFlushDelay];
+        }
+        mutations = [[GRVPendingVideoMutations alloc] init];
+        mutations.video = video;
+        [self.pendingMutations setObject:mutations forKey:video.hashKey];
+    }
+    return mutations;
+}
+
+/**
+ * Apply a count from a video's server representation, if it has one and it
+ * differs, so unchanged videos aren't dirtied.
+ *
+ * @param key               REST key of the count in the response
+ * @param responseObject    Server's response to a mutation request
+ * @param video             Video whose count is updated
+ * @param countKey          Video attribute of the count
+ *
+ * @return YES if the response had the count.
+ */
++ (BOOL)applyCountForKey:(NSString *)key fromResponseObject:(id)responseObject toVideo:(GRVVideo *)video countKey:(NSString *)countKey
+{
+    id count = [responseObject isKindOfClass:[NSDictionary class]] ? [responseObject objectForKey:key] : nil;
+    if (![count isKindOfClass:[NSNumber class]]) return NO;
+    if (![count isEqual:[video valueForKey:countKey]]) [video setValue:count forKey:countKey];
+    return YES;
+}
+
+/**
+ * Send a video's play.
+ */
+- (void)sendPlay:(GRVPendingVideoMutations *)mutations
+{
+    GRVVideo *video = mutations.video;
+    NSArray *completions = [mutations.playCompletions copy];
+
+    self.sentRequestsCount++;
+    NSString *videoDetailPlayURL = [GRVRestUtils videoDetailPlayURL:video.hashKey];
+    [[GRVHTTPManager sharedManager] request:GRVHTTPMethodPUT forURL:videoDetailPlayURL parameters:nil requestClass:GRVHTTPRequestClassAnalytics success:^(NSURLSessionDataTask *task, id responseObject) {
+        [GRVVideoMutationQueue applyCountForKey:kGRVRESTVideoPlaysCountKey fromResponseObject:responseObject toVideo:video countKey:@"playsCount"];
+        if ([video.membership integerValue] <= GRVVideoMembershipInvited) {
+            video.membership = @(GRVVideoMembershipViewed);
+        }
+        [GRVVideoMutationQueue callCompletions:completions];
+    } failure:nil];
+}
+
+/**
+ * Send a video's like state, if it differs from the server's.
+ */
+- (void)sendLike:(GRVPendingVideoMutations *)mutations
+{
+    GRVVideo *video = mutations.video;
+    NSArray *completions = [mutations.likeCompletions copy];
+
+    BOOL liked = [video.liked boolValue];
+    if (liked == mutations.serverLiked) {
+        // Toggles cancelled out so there's nothing to send
+        [GRVVideoMutationQueue callCompletions:completions];
+        return;
+    }
+
+    self.sentRequestsCount++;
+    NSString *videoDetailLikeURL = [GRVRestUtils videoDetailLikeURL:video.hashKey];
+    GRVHTTPMethod method = liked ? GRVHTTPMethodPUT : GRVHTTPMethodDELETE;
+
+    [[GRVHTTPManager sharedManager] request:method forURL:videoDetailLikeURL parameters:nil success:^(NSURLSessionDataTask *task, id responseObject) {
+        // The server now has this like state. Use its likes count if it
+        // provided one, otherwise keep the optimistic count.
+        id likesCount = [responseObject isKindOfClass:[NSDictionary class]] ? [responseObject objectForKey:kGRVRESTVideoLikesCountKey] : nil;
+        if (![likesCount isKindOfClass:[NSNumber class]]) likesCount = video.likesCount;
+
+        GRVPendingVideoMutations *newerMutations = [self.pendingMutations objectForKey:video.hashKey];
+        if (newerMutations.likeToggled) {
+            // Toggled again since, so this is the state that was toggled from
+            newerMutations.serverLiked = liked;
+            newerMutations.serverLikesCount = [likesCount unsignedIntegerValue];
+        } else if (![likesCount isEqual:video.likesCount]) {
+            video.likesCount = likesCount;
+        }
+        [GRVVideoMutationQueue callCompletions:completions];
+
+    } failure:^(NSURLSessionDataTask *task, NSError *error, id responseObject) {
+        GRVPendingVideoMutations *newerMutations = [self.pendingMutations objectForKey:video.hashKey];
+        if (newerMutations.likeToggled) {
+            // Toggled again since, and the server still has the original state
+            newerMutations.serverLiked = mutations.serverLiked;
+            newerMutations.serverLikesCount = mutations.serverLikesCount;
+        } else {
+            // revert like action
+            video.liked = @(mutations.serverLiked);
+            video.likesCount = @(mutations.serverLikesCount);
+        }
+        [GRVVideoMutationQueue callCompletions:completions];
+    }];
+}
+
+/**
+ * Send a video's notifications clear.
+ */
+- (void)sendClearNotifications:(GRVPendingVideoMutations *)mutations
+{
+    GRVVideo *video = mutations.video;
+    NSArray *completions = [mutations.clearNotificationsCompletions copy];
+
+    self.sentRequestsCount++;
+    NSString *videoDetailClearNotificationsURL = [GRVRestUtils videoDetailClearNotificationsURL:video.hashKey];
+    [[GRVHTTPManager sharedManager] request:GRVHTTPMethodPUT forURL:videoDetailClearNotificationsURL parameters:nil success:^(NSURLSessionDataTask *task, id responseObject) {
+        // clear video notification stats, using the server's if it sent them
+        if (![GRVVideoMutationQueue applyCountForKey:kGRVRESTVideoUnseenClipsCountKey fromResponseObject:responseObject toVideo:video countKey:@"unseenClipsCount"] &&
+            [video.unseenClipsCount integerValue]) {
+            video.unseenClipsCount = @(0);
+        }
+        if (![GRVVideoMutationQueue applyCountForKey:kGRVRESTVideoUnseenLikesCountKey fromResponseObject:responseObject toVideo:video countKey:@"unseenLikesCount"] &&
+            [video.unseenLikesCount integerValue]) {
+            video.unseenLikesCount = @(0);
+        }
+        [GRVVideoMutationQueue applyCountForKey:kGRVRESTVideoPlaysCountKey fromResponseObject:responseObject toVideo:video countKey:@"playsCount"];
+        if ([video.membership integerValue] <= GRVVideoMembershipInvited) {
+            video.membership = @(GRVVideoMembershipViewed);
+        }
+        [GRVVideoMutationQueue callCompletions:completions];
+    } failure:nil];
+}
+
+#pragma mark Public
+- (void)enqueuePlayOfVideo:(GRVVideo *)video completion:(void (^)())completion
+{
+    GRVPendingVideoMutations *mutations = [self pendingMutationsOfVideo:video];
+    mutations.play = YES;
+    if (completion) [mutations.playCompletions addObject:[completion copy]];
+}
+
+- (void)enqueueLikeToggleOfVideo:(GRVVideo *)video
+                        wasLiked:(BOOL)wasLiked
+                      likesCount:(NSUInteger)likesCount
+                      completion:(void (^)())completion
+{
+    GRVPendingVideoMutations *mutations = [self pendingMutationsOfVideo:video];
+    if (!mutations.likeToggled) {
+        // First toggle since the last flush, so this is the server's state
+        mutations.likeToggled = YES;
+        mutations.serverLiked = wasLiked;
+        mutations.serverLikesCount = likesCount;
+    }
+    if (completion) [mutations.likeCompletions addObject:[completion copy]];
+}
+
+- (void)enqueueClearNotificationsOfVideo:(GRVVideo *)video completion:(void (^)())completion
+{
+    GRVPendingVideoMutations *mutations = [self pendingMutationsOfVideo:video];
+    mutations.clearNotifications = YES;
+    if (completion) [mutations.clearNotificationsCompletions addObject:[completion copy]];
+}
+
+- (void)flush
+{
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(flush) object:nil];
+
+    NSArray *allMutations = [self.pendingMutations allValues];
+    [self.pendingMutations removeAllObjects];
+
+    for (GRVPendingVideoMutations *mutations in allMutations) {
+        // Nothing to send for videos deleted in the meantime
+        if (mutations.video.isDeleted || !mutations.video.managedObjectContext) continue;
+
+        if (mutations.play) [self sendPlay:mutations];
+        if (mutations.likeToggled) [self sendLike:mutations];
+        if (mutations.clearNotifications) [self sendClearNotifications:mutations];
+    }
+}
+
+- (void)resetMeasurements
+{
+    self.enqueuedMutationsCount = 0;
+    self.sentRequestsCount = 0;
+}
+
+- (NSString *)measurementsDescription
+{
+    return [NSString stringWithFormat:@"video mutations: %lu enqueued, %lu requests sent",
+            (unsigned long)self.enqueuedMutationsCount, (unsigned long)self.sentRequestsCount];
+}
+
+@end
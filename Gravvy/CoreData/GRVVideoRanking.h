@@ -0,0 +1,42 @@
+//
+//  GRVVideoRanking.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/28/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * `GRVVideoRanking` orders the videos list. Each video gets a sort key packed
+ * from its attributes and compared as C types, rather than sorting managed
+ * objects with KVC-based sort descriptors.
+ *
+ * @discussion Videos are ranked by:
+ *      - participation DESC: new and unseen videos first
+ *      - unseen clips count DESC: unseen clips next
+ *      - unseen likes count DESC: unseen likes
+ *      - score DESC: rank indicator
+ *      - updatedAt DESC: in the unlikely event the score isn't unique, video
+ *        with recent update wins
+ *      - order ASC: videos that tie on everything keep their current order
+ *
+ *      Participation and the unseen counts are packed into a single 64-bit
+ *      integer, so the common case is decided by one integer comparison.
+ */
+@interface GRVVideoRanking : NSObject
+
+#pragma mark - Class Methods
+/**
+ * Rank a collection of videos and set their `order` to their rank, starting
+ * at 0. A video's order is only written if its rank changed, so unmoved
+ * videos aren't dirtied and don't generate fetched results changes.
+ *
+ * @param videos    GRVVideo objects to be ranked
+ *
+ * @return number of videos whose order was changed.
+ */
++ (NSUInteger)rankVideos:(NSArray *)videos;
+
+@end
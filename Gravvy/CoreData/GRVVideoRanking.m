@@ -0,0 +1,95 @@
+//
+//  GRVVideoRanking.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/28/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVVideoRanking.h"
+#import "GRVVideo.h"
+#import <float.h>
+
+/**
+ * Sort key of a video.
+ *
+ * `counts` packs participation into its top 16 bits and the unseen clips and
+ * unseen likes counts into the next two 24 bits, so comparing it compares the
+ * three attributes in that order. `currentOrder` is the video's order before
+ * ranking and `index` its position in the array being ranked.
+ */
+typedef struct {
+    uint64_t counts;
+    double score;
+    double updatedAt;
+    NSInteger currentOrder;
+    NSUInteger index;
+} GRVVideoRankKey;
+
+/**
+ * Clamp a non-negative attribute to the number of bits it's packed in.
+ */
+static uint64_t GRVPackedValue(NSNumber *value, unsigned int bits)
+{
+    long long integerValue = [value longLongValue];
+    uint64_t maxValue = (1ULL << bits) - 1;
+    if (integerValue <= 0) return 0;
+    return ((uint64_t)integerValue > maxValue) ? maxValue : (uint64_t)integerValue;
+}
+
+/**
+ * qsort comparator that puts higher ranked keys first.
+ */
+static int GRVCompareVideoRankKeys(const void *a, const void *b)
+{
+    const GRVVideoRankKey *keyA = a;
+    const GRVVideoRankKey *keyB = b;
+    if (keyA->counts != keyB->counts) return (keyA->counts > keyB->counts) ? -1 : 1;
+    if (keyA->score != keyB->score) return (keyA->score > keyB->score) ? -1 : 1;
+    if (keyA->updatedAt != keyB->updatedAt) return (keyA->updatedAt > keyB->updatedAt) ? -1 : 1;
+    if (keyA->currentOrder != keyB->currentOrder) return (keyA->currentOrder < keyB->currentOrder) ? -1 : 1;
+    if (keyA->index != keyB->index) return (keyA->index < keyB->index) ? -1 : 1;
+    return 0;
+}
+
+@implementation GRVVideoRanking
+
+#pragma mark - Class Methods
+#pragma mark Public
++ (NSUInteger)rankVideos:(NSArray *)videos
+{
+    NSUInteger count = [videos count];
+    if (!count) return 0;
+
+    GRVVideoRankKey *keys = malloc(count * sizeof(GRVVideoRankKey));
+    if (!keys) return 0;
+
+    NSUInteger index = 0;
+    for (GRVVideo *video in videos) {
+        GRVVideoRankKey *key = &keys[index];
+        key->counts = ((GRVPackedValue(video.participation, 16) << 48) |
+                       (GRVPackedValue(video.unseenClipsCount, 24) << 24) |
+                       GRVPackedValue(video.unseenLikesCount, 24));
+        key->score = video.score ? [video.score doubleValue] : -DBL_MAX;
+        key->updatedAt = video.updatedAt ? [video.updatedAt timeIntervalSinceReferenceDate] : -DBL_MAX;
+        key->currentOrder = video.order ? [video.order integerValue] : NSIntegerMax;
+        key->index = index;
+        index++;
+    }
+
+    qsort(keys, count, sizeof(GRVVideoRankKey), GRVCompareVideoRankKeys);
+
+    NSUInteger changedCount = 0;
+    for (NSUInteger rank = 0; rank < count; rank++) {
+        GRVVideo *video = videos[keys[rank].index];
+        if (!video.order || ([video.order integerValue] != (NSInteger)rank)) {
+            video.order = @(rank);
+            changedCount++;
+        }
+    }
+
+    free(keys);
+    return changedCount;
+}
+
+@end
@@ -100,6 +100,50 @@ extern const NSUInteger kGRVCacheMemoryCapacity;
  */
 extern const NSUInteger kGRVCacheDiskCapacity;
 
+/**
+ * kGRVPreviewImageCacheMemoryCapacity is the memory capacity, in bytes, of
+ * decoded feed preview image bitmaps held by GRVPreviewImageLoader.
+ */
+extern const NSUInteger kGRVPreviewImageCacheMemoryCapacity;
+
+/**
+ * kGRVContactThumbnailCacheMemoryCapacity is the memory capacity, in bytes, of
+ * decoded address book contact thumbnails held by GRVContactThumbnailLoader.
+ */
+extern const NSUInteger kGRVContactThumbnailCacheMemoryCapacity;
+
+/**
+ * kGRVCoreDataImportBatchSize is the number of JSON objects (or address book
+ * records) imported into Core Data per batch. The worker context is saved and
+ * reset between batches, which bounds memory use on large payloads.
+ */
+extern const NSUInteger kGRVCoreDataImportBatchSize;
+
+/**
+ * kGRVVideoMutationFlushDelay is how long, in seconds, plays, likes and
+ * notification clears are held by GRVVideoMutationQueue to be collapsed before
+ * they're sent to the server.
+ */
+extern const NSTimeInterval kGRVVideoMutationFlushDelay;
+
+/**
+ * kGRVClipDeleteMaxConcurrentRequests is the maximum number of clip delete
+ * requests in flight at once when deleting a collection of clips.
+ */
+extern const NSUInteger kGRVClipDeleteMaxConcurrentRequests;
+
+/**
+ * kGRVHTTPMetricsBufferCapacity is the number of most recent HTTP requests
+ * whose timing metrics are kept for export.
+ */
+extern const NSUInteger kGRVHTTPMetricsBufferCapacity;
+
+/**
+ * kGRVRefreshTraceHistoryCount is the number of most recent videos refresh
+ * traces kept for the summary.
+ */
+extern const NSUInteger kGRVRefreshTraceHistoryCount;
+
 
 // -----------------------------------------------------------------------------
 // Video Configuration info.
@@ -125,6 +169,18 @@ extern const float kGRVVideoSizeHeight;
  */
 extern const float kGRVVideoPhotoCompressionQuality;
 
+/**
+ * User avatar size. Uploaded avatars are downsampled to fit within this as the
+ * server doesn't keep anything larger.
+ */
+extern const float kGRVUserAvatarSizeWidth;
+extern const float kGRVUserAvatarSizeHeight;
+
+/**
+ * User avatar image compression quality when converting to JPEG
+ */
+extern const float kGRVUserAvatarCompressionQuality;
+
 
 // -----------------------------------------------------------------------------
 // PopTip Configuration info.
@@ -336,6 +392,21 @@ extern NSString *const kGRVRESTActivityTargetKey;
 extern NSString *const kGRVRESTActivityVerbKey;
 
 
+// -----------------------------------------------------------------------------
+// Address Book Contact Keys
+// -----------------------------------------------------------------------------
+/**
+ * Keys of the contact info dictionaries that address book person records are
+ * read into for syncing GRVContact objects. The phone numbers are an array of
+ * strings.
+ */
+extern NSString *const kGRVContactRecordIdKey;
+extern NSString *const kGRVContactFirstNameKey;
+extern NSString *const kGRVContactLastNameKey;
+extern NSString *const kGRVContactUpdatedAtKey;
+extern NSString *const kGRVContactPhoneNumbersKey;
+
+
 // -----------------------------------------------------------------------------
 // User Credentials
 // -----------------------------------------------------------------------------
@@ -411,6 +482,15 @@ extern NSString *const kGRVHTTPAuthenticationNotification;
  */
 extern NSString *const kGRVContactsRefreshedNotification;
 
+/**
+ * kGRVContactThumbnailLoadedNotification is the NSNotification identifier for
+ * an address book contact thumbnail being loaded into memory. The contact's
+ * recordId is in the userInfo under kGRVContactThumbnailRecordIdKey. Avatar
+ * views waiting on that contact's thumbnail observe this to update themselves.
+ */
+extern NSString *const kGRVContactThumbnailLoadedNotification;
+extern NSString *const kGRVContactThumbnailRecordIdKey;
+
 
 // -----------------------------------------------------------------------------
 // Custom Type Defs
@@ -426,6 +506,19 @@ typedef enum : NSUInteger {
     GRVHTTPMethodDELETE
 } GRVHTTPMethod;
 
+/**
+ * HTTP Request Classes: each class of request has its own priority and cap on
+ * concurrent requests in the shared HTTP session.
+ */
+typedef enum : NSUInteger {
+    GRVHTTPRequestClassMetadata = 0,    // REST API JSON requests
+    GRVHTTPRequestClassVideoBytes,      // clip MP4 downloads for playback
+    GRVHTTPRequestClassThumbnail,       // preview and avatar image downloads
+    GRVHTTPRequestClassUpload,          // multipart clip, video and avatar uploads
+    GRVHTTPRequestClassAnalytics,       // play reporting
+    GRVHTTPRequestClassCount            // number of request classes
+} GRVHTTPRequestClass;
+
 
 /**
  * HTTP Status Codes as defined in RFC 2616 and RFC 6585
@@ -34,6 +34,13 @@ const BOOL kGRVReachabilityRequired     = YES;
 // -----------------------------------------------------------------------------
 const NSUInteger kGRVCacheMemoryCapacity    = 2 * 1024 * 1024;      // 2mb
 const NSUInteger kGRVCacheDiskCapacity      = 256 * 1024 * 1024;    // 256mb
+const NSUInteger kGRVPreviewImageCacheMemoryCapacity = 24 * 1024 * 1024; // 24mb
+const NSUInteger kGRVContactThumbnailCacheMemoryCapacity = 4 * 1024 * 1024; // 4mb
+const NSUInteger kGRVCoreDataImportBatchSize = 50;
+const NSTimeInterval kGRVVideoMutationFlushDelay = 2.0;
+const NSUInteger kGRVClipDeleteMaxConcurrentRequests = 3;
+const NSUInteger kGRVHTTPMetricsBufferCapacity = 500;
+const NSUInteger kGRVRefreshTraceHistoryCount = 10;
 
 // -----------------------------------------------------------------------------
 // Video Configuration info.
@@ -43,6 +50,9 @@ const NSTimeInterval kGRVClipMinimumDuration = 1.0;
 const float kGRVVideoSizeWidth = 480.0;
 const float kGRVVideoSizeHeight = 480.0;
 const float kGRVVideoPhotoCompressionQuality = 0.4;
+const float kGRVUserAvatarSizeWidth = 480.0;
+const float kGRVUserAvatarSizeHeight = 480.0;
+const float kGRVUserAvatarCompressionQuality = 0.4;
 
 
 // -----------------------------------------------------------------------------
@@ -170,6 +180,16 @@ NSString *const kGRVRESTActivityTargetKey           = @"target";
 NSString *const kGRVRESTActivityVerbKey             = @"verb";
 
 
+// -----------------------------------------------------------------------------
+// Address Book Contact Keys
+// -----------------------------------------------------------------------------
+NSString *const kGRVContactRecordIdKey              = @"recordId";
+NSString *const kGRVContactFirstNameKey             = @"firstName";
+NSString *const kGRVContactLastNameKey              = @"lastName";
+NSString *const kGRVContactUpdatedAtKey             = @"updatedAt";
+NSString *const kGRVContactPhoneNumbersKey          = @"phoneNumbers";
+
+
 // -----------------------------------------------------------------------------
 // User Credentials
 // -----------------------------------------------------------------------------
@@ -194,6 +214,8 @@ NSString *const kGRVMOCAvailableNotification        = @"kGRVMOCAvailableNotifica
 NSString *const kGRVMOCDeletedNotification          = @"kGRVMOCDeletedNotification";
 NSString *const kGRVHTTPAuthenticationNotification  = @"kGRVHTTPAuthenticationNotification";
 NSString *const kGRVContactsRefreshedNotification   = @"kGRVContactsRefreshedNotification";
+NSString *const kGRVContactThumbnailLoadedNotification = @"kGRVContactThumbnailLoadedNotification";
+NSString *const kGRVContactThumbnailRecordIdKey       = @"recordId";
 
 
 // EOF
\ No newline at end of file
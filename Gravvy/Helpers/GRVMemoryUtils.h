@@ -0,0 +1,24 @@
+//
+//  GRVMemoryUtils.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/27/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * This helper class provides utility methods for measuring the app's memory
+ * use.
+ */
+@interface GRVMemoryUtils : NSObject
+
+/**
+ * Current resident memory size of the app. This can be called on any thread.
+ *
+ * @return resident memory size in bytes, or 0 if it couldn't be read.
+ */
++ (NSUInteger)residentMemory;
+
+@end
@@ -0,0 +1,22 @@
+//
+//  GRVMemoryUtils.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/27/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVMemoryUtils.h"
+#import <mach/mach.h>
+
+@implementation GRVMemoryUtils
+
++ (NSUInteger)residentMemory
+{
+    struct mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    kern_return_t result = task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count);
+    return (result == KERN_SUCCESS) ? (NSUInteger)info.resident_size : 0;
+}
+
+@end
@@ -0,0 +1,101 @@
+//
+//  GRVRefreshTrace.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/28/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Stages of a videos refresh, in pipeline order.
+ */
+typedef enum : NSUInteger {
+    GRVRefreshTraceStageRequest = 0,    // HTTP request till its response is read
+    GRVRefreshTraceStageImport,         // batched import and delete of videos
+    GRVRefreshTraceStageReorder,        // reordering of refreshed videos
+    GRVRefreshTraceStageSave,           // worker context save
+    GRVRefreshTraceStageMerge,          // save till merged into the main context
+    GRVRefreshTraceStageUIUpdate,       // table view update on the main thread
+    GRVRefreshTraceStageCount
+} GRVRefreshTraceStage;
+
+/**
+ * `GRVRefreshTrace` records named intervals for each stage of a videos refresh,
+ * from the pull-to-refresh through the HTTP request, import, save and merge to
+ * the table view update. The most recent traces are kept for a summary.
+ *
+ * @discussion Tracing is only available in debug builds, and only when the
+ *      GRVTraceRefreshes user default is set, e.g. with the launch argument
+ *      `-GRVTraceRefreshes YES`. Otherwise traceIfEnabled returns nil, so
+ *      tracing a refresh costs a nil message per stage.
+ *
+ *      On iOS 10 and later each stage is also emitted as a signpost interval,
+ *      with the stage as the code and the trace identifier as the first
+ *      argument, so stages show up under Points of Interest in Instruments.
+ *
+ *      A trace's stages can begin and end on any thread, but a stage must end
+ *      on the thread it began on or after it.
+ */
+@interface GRVRefreshTrace : NSObject
+
+#pragma mark - Properties
+/**
+ * Identifier of the trace, unique for this launch.
+ */
+@property (nonatomic, readonly) NSUInteger identifier;
+
+/**
+ * Did the refresh reorder the videos?
+ */
+@property (nonatomic, readonly) BOOL reorder;
+
+/**
+ * Did the refresh fail? Failed refreshes are listed in the summary but left
+ * out of its averages, as they skip stages or end early.
+ */
+@property (nonatomic, readonly, getter=isFailed) BOOL failed;
+
+
+#pragma mark - Class Methods
+/**
+ * Start a trace of a refresh if tracing is enabled.
+ *
+ * @param reorder   Does the refresh reorder the videos?
+ *
+ * @return A new GRVRefreshTrace, or nil if tracing is disabled.
+ */
++ (instancetype)traceIfEnabledWithReorder:(BOOL)reorder;
+
+/**
+ * Summary of the most recent finished traces, oldest first: each stage's
+ * duration and the total per refresh, and the average of each stage over the
+ * refreshes that didn't fail.
+ */
++ (NSString *)recentTracesSummary;
+
+
+#pragma mark - Instance Methods
+/**
+ * Mark the beginning and end of a stage of the refresh.
+ */
+- (void)beginStage:(GRVRefreshTraceStage)stage;
+- (void)endStage:(GRVRefreshTraceStage)stage;
+
+/**
+ * Duration, in seconds, of a stage or 0 if it didn't end.
+ */
+- (NSTimeInterval)durationOfStage:(GRVRefreshTraceStage)stage;
+
+/**
+ * Mark the refresh as failed. It still needs to be finished.
+ */
+- (void)markFailed;
+
+/**
+ * Mark the end of the refresh and add the trace to the recent traces.
+ */
+- (void)finish;
+
+@end
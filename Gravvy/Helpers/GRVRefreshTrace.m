@@ -0,0 +1,189 @@
+//
+//  GRVRefreshTrace.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/28/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVRefreshTrace.h"
+#import <QuartzCore/QuartzCore.h>
+#if __has_include(<sys/kdebug_signpost.h>)
+#import <sys/kdebug_signpost.h>
+#define GRV_SIGNPOSTS_AVAILABLE 1
+#endif
+#import "GRVConstants.h"
+
+#pragma mark - Constants
+/**
+ * User defaults key that enables tracing.
+ */
+static NSString *const kGRVTraceRefreshesKey = @"GRVTraceRefreshes";
+
+/**
+ * Signpost code of the first stage. Each stage's code is offset by the stage.
+ */
+static const uint32_t kGRVRefreshTraceSignpostCode = 100;
+
+/**
+ * Names of the stages in the summary, indexed by GRVRefreshTraceStage.
+ */
+static NSString *const kGRVRefreshTraceStageNames[GRVRefreshTraceStageCount] = {
+    @"request", @"import", @"reorder", @"save", @"merge", @"ui"
+};
+
+
+@interface GRVRefreshTrace () {
+    CFTimeInterval _stageBeginTimes[GRVRefreshTraceStageCount];
+    CFTimeInterval _stageDurations[GRVRefreshTraceStageCount];
+}
+
+@property (nonatomic) CFTimeInterval beginTime;
+@property (nonatomic) NSTimeInterval totalDuration;
+
+// redefine readonly properties as readwrite
+@property (nonatomic, readwrite) NSUInteger identifier;
+@property (nonatomic, readwrite) BOOL reorder;
+@property (nonatomic, readwrite, getter=isFailed) BOOL failed;
+
+@end
+
+@implementation GRVRefreshTrace
+
+#pragma mark - Class Methods
+#pragma mark Private
+/**
+ * Is tracing enabled? This is read once per launch.
+ */
++ (BOOL)isEnabled
+{
+#if DEBUG
+    static BOOL enabled = NO;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        enabled = [[NSUserDefaults standardUserDefaults] boolForKey:kGRVTraceRefreshesKey];
+    });
+    return enabled;
+#else
+    return NO;
+#endif
+}
+
+/**
+ * Most recent finished traces, oldest first. Only accessed while synchronized
+ * on the class.
+ */
++ (NSMutableArray *)recentTraces
+{
+    static NSMutableArray *recentTraces = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        recentTraces = [NSMutableArray arrayWithCapacity:kGRVRefreshTraceHistoryCount];
+    });
+    return recentTraces;
+}
+
+#pragma mark Public
++ (instancetype)traceIfEnabledWithReorder:(BOOL)reorder
+{
+    if (![GRVRefreshTrace isEnabled]) return nil;
+
+    static NSUInteger lastIdentifier = 0;
+    GRVRefreshTrace *trace = [[GRVRefreshTrace alloc] init];
+    @synchronized([GRVRefreshTrace class]) {
+        trace.identifier = ++lastIdentifier;
+    }
+    trace.reorder = reorder;
+    trace.beginTime = CACurrentMediaTime();
+    return trace;
+}
+
++ (NSString *)recentTracesSummary
+{
+    NSArray *traces = nil;
+    @synchronized([GRVRefreshTrace class]) {
+        traces = [[GRVRefreshTrace recentTraces] copy];
+    }
+    if (![traces count]) return @"No refreshes traced";
+
+    NSMutableString *summary = [NSMutableString string];
+    NSTimeInterval stageTotals[GRVRefreshTraceStageCount] = {0};
+    NSTimeInterval total = 0.0;
+    NSUInteger succeededCount = 0;
+    for (GRVRefreshTrace *trace in traces) {
+        [summary appendFormat:@"#%lu%@%@:", (unsigned long)trace.identifier, (trace.reorder ? @" reorder" : @""), (trace.isFailed ? @" failed" : @"")];
+        for (NSUInteger stage = 0; stage < GRVRefreshTraceStageCount; stage++) {
+            NSTimeInterval duration = [trace durationOfStage:stage];
+            if (!trace.isFailed) stageTotals[stage] += duration;
+            if (duration > 0.0) {
+                [summary appendFormat:@" %@ %.0fms", kGRVRefreshTraceStageNames[stage], duration * 1000.0];
+            }
+        }
+        if (!trace.isFailed) {
+            total += trace.totalDuration;
+            succeededCount++;
+        }
+        [summary appendFormat:@", total %.0fms\n", trace.totalDuration * 1000.0];
+    }
+
+    if (!succeededCount) {
+        [summary appendString:@"average: no refreshes succeeded"];
+        return summary;
+    }
+    [summary appendString:@"average:"];
+    for (NSUInteger stage = 0; stage < GRVRefreshTraceStageCount; stage++) {
+        [summary appendFormat:@" %@ %.0fms", kGRVRefreshTraceStageNames[stage], stageTotals[stage] / succeededCount * 1000.0];
+    }
+    [summary appendFormat:@", total %.0fms", total / succeededCount * 1000.0];
+    return summary;
+}
+
+
+#pragma mark - Instance Methods
+#pragma mark Public
+- (void)beginStage:(GRVRefreshTraceStage)stage
+{
+    if (stage >= GRVRefreshTraceStageCount) return;
+    _stageBeginTimes[stage] = CACurrentMediaTime();
+#ifdef GRV_SIGNPOSTS_AVAILABLE
+    if (&kdebug_signpost_start != NULL) {
+        kdebug_signpost_start(kGRVRefreshTraceSignpostCode + (uint32_t)stage, self.identifier, 0, 0, stage);
+    }
+#endif
+}
+
+- (void)endStage:(GRVRefreshTraceStage)stage
+{
+    if ((stage >= GRVRefreshTraceStageCount) || !_stageBeginTimes[stage]) return;
+    _stageDurations[stage] = CACurrentMediaTime() - _stageBeginTimes[stage];
+#ifdef GRV_SIGNPOSTS_AVAILABLE
+    if (&kdebug_signpost_end != NULL) {
+        kdebug_signpost_end(kGRVRefreshTraceSignpostCode + (uint32_t)stage, self.identifier, 0, 0, stage);
+    }
+#endif
+}
+
+- (NSTimeInterval)durationOfStage:(GRVRefreshTraceStage)stage
+{
+    return (stage < GRVRefreshTraceStageCount) ? _stageDurations[stage] : 0.0;
+}
+
+- (void)markFailed
+{
+    self.failed = YES;
+}
+
+- (void)finish
+{
+    self.totalDuration = CACurrentMediaTime() - self.beginTime;
+
+    @synchronized([GRVRefreshTrace class]) {
+        NSMutableArray *recentTraces = [GRVRefreshTrace recentTraces];
+        [recentTraces addObject:self];
+        if ([recentTraces count] > kGRVRefreshTraceHistoryCount) {
+            [recentTraces removeObjectAtIndex:0];
+        }
+    }
+}
+
+@end
@@ -24,4 +24,16 @@
  */
 + (UIImage *)imageWithColor:(UIColor *)color;
 
+/**
+ * Decode the image into a bitmap, so it isn't decoded on the main thread when
+ * it is first drawn.
+ *
+ * @warning This does the actual decoding so should not be called on the main
+ *      thread.
+ *
+ * @return decoded image with the same scale and orientation, or this image if
+ *      it can't be decoded.
+ */
+- (UIImage *)decodedImage;
+
 @end
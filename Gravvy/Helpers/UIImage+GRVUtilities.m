@@ -25,4 +25,36 @@
     return image;
 }
 
+- (UIImage *)decodedImage
+{
+    CGImageRef imageRef = self.CGImage;
+    if (!imageRef) return self;
+    
+    size_t width = CGImageGetWidth(imageRef);
+    size_t height = CGImageGetHeight(imageRef);
+    
+    // Only keep an alpha channel if the image has one
+    CGImageAlphaInfo alphaInfo = CGImageGetAlphaInfo(imageRef);
+    BOOL opaque = ((alphaInfo == kCGImageAlphaNone) ||
+                   (alphaInfo == kCGImageAlphaNoneSkipFirst) ||
+                   (alphaInfo == kCGImageAlphaNoneSkipLast));
+    CGBitmapInfo bitmapInfo = kCGBitmapByteOrder32Host | (opaque ? kCGImageAlphaNoneSkipFirst : kCGImageAlphaPremultipliedFirst);
+    
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef context = CGBitmapContextCreate(NULL, width, height, 8, 0, colorSpace, bitmapInfo);
+    CGColorSpaceRelease(colorSpace);
+    if (!context) return self;
+    
+    CGContextDrawImage(context, CGRectMake(0, 0, width, height), imageRef);
+    CGImageRef decodedImageRef = CGBitmapContextCreateImage(context);
+    CGContextRelease(context);
+    if (!decodedImageRef) return self;
+    
+    UIImage *decodedImage = [UIImage imageWithCGImage:decodedImageRef
+                                                scale:self.scale
+                                          orientation:self.imageOrientation];
+    CGImageRelease(decodedImageRef);
+    return decodedImage;
+}
+
 @end
@@ -0,0 +1,58 @@
+//
+//  GRVHTTPFixtureProtocol.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/27/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * HTTP Fixture Modes
+ */
+typedef enum : NSUInteger {
+    GRVHTTPFixtureModeOff = 0,  // requests go to the network as usual
+    GRVHTTPFixtureModeRecord,   // requests go to the network and are saved
+    GRVHTTPFixtureModeReplay    // requests are served from saved fixtures only
+} GRVHTTPFixtureMode;
+
+/**
+ * `GRVHTTPFixtureProtocol` is a URL protocol that records HTTP responses as
+ * fixtures and replays them offline, so sync paths like feed refresh, contact
+ * sync and clip playback can be benchmarked repeatably without the live API.
+ *
+ * @discussion It's configured with user defaults, which are easiest set as
+ *      launch arguments in the scheme, e.g. `-GRVHTTPFixtureMode replay`:
+ *      - GRVHTTPFixtureMode: `record` or `replay`. Anything else is off.
+ *      - GRVHTTPFixtureLatency: seconds before a replayed response starts.
+ *      - GRVHTTPFixtureBandwidth: bytes per second a replayed body is
+ *        delivered at, or 0 for as fast as possible.
+ *
+ *      Fixtures are keyed by HTTP method, URL and body, and kept in
+ *      fixturesDirectoryURL. A replayed request without a fixture fails with
+ *      NSURLErrorResourceUnavailable. Streamed bodies, such as those of
+ *      multipart uploads, are read into memory to key their fixtures.
+ *
+ *      Register it in a session configuration's protocolClasses. Only debug
+ *      builds do so.
+ */
+@interface GRVHTTPFixtureProtocol : NSURLProtocol
+
+#pragma mark - Class Methods
+/**
+ * Fixture mode from user defaults.
+ */
++ (GRVHTTPFixtureMode)mode;
+
+/**
+ * Directory fixtures are saved in and replayed from.
+ */
++ (NSURL *)fixturesDirectoryURL;
+
+/**
+ * Delete all saved fixtures.
+ */
++ (void)removeAllFixtures;
+
+@end
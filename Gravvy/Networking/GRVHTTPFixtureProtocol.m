@@ -0,0 +1,345 @@
+//
+//  GRVHTTPFixtureProtocol.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/27/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVHTTPFixtureProtocol.h"
+#import <CommonCrypto/CommonDigest.h>
+
+#pragma mark - Constants
+/**
+ * User defaults keys of the fixture configuration.
+ */
+static NSString *const kGRVHTTPFixtureModeKey       = @"GRVHTTPFixtureMode";
+static NSString *const kGRVHTTPFixtureLatencyKey    = @"GRVHTTPFixtureLatency";
+static NSString *const kGRVHTTPFixtureBandwidthKey  = @"GRVHTTPFixtureBandwidth";
+
+/**
+ * Fixture file keys.
+ */
+static NSString *const kGRVHTTPFixtureMethodKey     = @"method";
+static NSString *const kGRVHTTPFixtureURLKey        = @"url";
+static NSString *const kGRVHTTPFixtureStatusKey     = @"status";
+static NSString *const kGRVHTTPFixtureHeadersKey    = @"headers";
+
+/**
+ * Number of body chunks delivered per second when bandwidth is limited.
+ */
+static const NSUInteger kGRVHTTPFixtureChunksPerSecond = 10;
+
+
+@interface GRVHTTPFixtureProtocol ()
+
+/**
+ * Thread and run loop modes the client must be called back on.
+ */
+@property (strong, nonatomic) NSThread *clientThread;
+@property (copy, nonatomic) NSArray *runLoopModes;
+
+/**
+ * Copy of the request with its body read from its body stream. Fixtures are
+ * keyed by it and recorded requests are made with it, as the stream can only
+ * be read once.
+ */
+@property (strong, nonatomic) NSURLRequest *fixtureRequest;
+
+/**
+ * Network task of a recorded request.
+ */
+@property (strong, nonatomic) NSURLSessionDataTask *recordingTask;
+
+/**
+ * Has loading been stopped? Only accessed on the client thread.
+ */
+@property (nonatomic, getter=isStopped) BOOL stopped;
+
+@end
+
+@implementation GRVHTTPFixtureProtocol
+
+#pragma mark - Class Methods
+#pragma mark Public
++ (GRVHTTPFixtureMode)mode
+{
+    NSString *mode = [[NSUserDefaults standardUserDefaults] stringForKey:kGRVHTTPFixtureModeKey];
+    if ([mode isEqualToString:@"record"]) return GRVHTTPFixtureModeRecord;
+    if ([mode isEqualToString:@"replay"]) return GRVHTTPFixtureModeReplay;
+    return GRVHTTPFixtureModeOff;
+}
+
++ (NSURL *)fixturesDirectoryURL
+{
+    NSURL *documentsURL = [[[NSFileManager defaultManager] URLsForDirectory:NSDocumentDirectory inDomains:NSUserDomainMask] lastObject];
+    return [documentsURL URLByAppendingPathComponent:@"HTTPFixtures" isDirectory:YES];
+}
+
++ (void)removeAllFixtures
+{
+    [[NSFileManager defaultManager] removeItemAtURL:[GRVHTTPFixtureProtocol fixturesDirectoryURL] error:NULL];
+}
+
+#pragma mark Private
+/**
+ * Session that recorded requests are made with. It doesn't use this protocol.
+ */
++ (NSURLSession *)recordingSession
+{
+    static NSURLSession *recordingSession = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        recordingSession = [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration defaultSessionConfiguration]];
+    });
+    return recordingSession;
+}
+
+/**
+ * Body of a request. NSURLSession hands requests to URL protocols with their
+ * body in HTTPBodyStream rather than HTTPBody, and reading it consumes it.
+ *
+ * @return the body data, or nil if the request has no body.
+ */
++ (NSData *)bodyOfRequest:(NSURLRequest *)request
+{
+    if (request.HTTPBody || !request.HTTPBodyStream) return request.HTTPBody;
+
+    NSInputStream *bodyStream = request.HTTPBodyStream;
+    NSMutableData *body = [NSMutableData data];
+    uint8_t buffer[16384];
+    NSInteger length = 0;
+    [bodyStream open];
+    while ((length = [bodyStream read:buffer maxLength:sizeof(buffer)]) > 0) {
+        [body appendBytes:buffer length:(NSUInteger)length];
+    }
+    [bodyStream close];
+    return body;
+}
+
+/**
+ * Copy of a request with any body stream read into HTTPBody, so the body can
+ * be read more than once.
+ */
++ (NSURLRequest *)fixtureRequestForRequest:(NSURLRequest *)request
+{
+    if (request.HTTPBody || !request.HTTPBodyStream) return request;
+
+    NSMutableURLRequest *fixtureRequest = [request mutableCopy];
+    fixtureRequest.HTTPBody = [GRVHTTPFixtureProtocol bodyOfRequest:request];
+    return fixtureRequest;
+}
+
+/**
+ * File name, without extension, of a request's fixture: the SHA-1 of its HTTP
+ * method, URL and body.
+ *
+ * @warning A body stream is consumed, so use a request from
+ *      fixtureRequestForRequest: to name a fixture more than once.
+ */
++ (NSString *)fixtureNameForRequest:(NSURLRequest *)request
+{
+    NSString *HTTPMethod = request.HTTPMethod ? request.HTTPMethod : @"GET";
+    NSMutableData *keyData = [[[NSString stringWithFormat:@"%@ %@\n", HTTPMethod, [request.URL absoluteString]] dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+    NSData *body = [GRVHTTPFixtureProtocol bodyOfRequest:request];
+    if (body) [keyData appendData:body];
+
+    unsigned char digest[CC_SHA1_DIGEST_LENGTH];
+    CC_SHA1([keyData bytes], (CC_LONG)[keyData length], digest);
+
+    NSMutableString *fixtureName = [NSMutableString stringWithCapacity:CC_SHA1_DIGEST_LENGTH * 2];
+    for (NSUInteger i = 0; i < CC_SHA1_DIGEST_LENGTH; i++) {
+        [fixtureName appendFormat:@"%02x", digest[i]];
+    }
+    return fixtureName;
+}
+
+/**
+ * URLs of the response and body files of a request's fixture.
+ */
++ (NSURL *)responseURLForRequest:(NSURLRequest *)request
+{
+    NSString *fileName = [[GRVHTTPFixtureProtocol fixtureNameForRequest:request] stringByAppendingPathExtension:@"json"];
+    return [[GRVHTTPFixtureProtocol fixturesDirectoryURL] URLByAppendingPathComponent:fileName];
+}
+
++ (NSURL *)bodyURLForRequest:(NSURLRequest *)request
+{
+    NSString *fileName = [[GRVHTTPFixtureProtocol fixtureNameForRequest:request] stringByAppendingPathExtension:@"body"];
+    return [[GRVHTTPFixtureProtocol fixturesDirectoryURL] URLByAppendingPathComponent:fileName];
+}
+
+/**
+ * Save a request's response as a fixture.
+ */
++ (void)saveFixtureForRequest:(NSURLRequest *)request response:(NSHTTPURLResponse *)response data:(NSData *)data
+{
+    [[NSFileManager defaultManager] createDirectoryAtURL:[GRVHTTPFixtureProtocol fixturesDirectoryURL]
+                             withIntermediateDirectories:YES
+                                              attributes:nil
+                                                   error:NULL];
+
+    // The body is saved decoded, so drop headers that describe its encoding
+    NSMutableDictionary *headers = [response.allHeaderFields mutableCopy];
+    [headers removeObjectForKey:@"Content-Encoding"];
+    [headers removeObjectForKey:@"Content-Length"];
+    [headers removeObjectForKey:@"Transfer-Encoding"];
+
+    NSDictionary *fixture = @{kGRVHTTPFixtureMethodKey : (request.HTTPMethod ? request.HTTPMethod : @"GET"),
+                              kGRVHTTPFixtureURLKey : [request.URL absoluteString],
+                              kGRVHTTPFixtureStatusKey : @(response.statusCode),
+                              kGRVHTTPFixtureHeadersKey : headers ? headers : @{}};
+    NSData *fixtureData = [NSJSONSerialization dataWithJSONObject:fixture options:NSJSONWritingPrettyPrinted error:NULL];
+
+    [(data ? data : [NSData data]) writeToURL:[GRVHTTPFixtureProtocol bodyURLForRequest:request] atomically:YES];
+    [fixtureData writeToURL:[GRVHTTPFixtureProtocol responseURLForRequest:request] atomically:YES];
+}
+
+
+#pragma mark - NSURLProtocol
++ (BOOL)canInitWithRequest:(NSURLRequest *)request
+{
+    NSString *scheme = [[request.URL scheme] lowercaseString];
+    return (([GRVHTTPFixtureProtocol mode] != GRVHTTPFixtureModeOff) &&
+            ([scheme isEqualToString:@"http"] || [scheme isEqualToString:@"https"]));
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request
+{
+    return request;
+}
+
+- (void)startLoading
+{
+    self.clientThread = [NSThread currentThread];
+    NSString *currentMode = [[NSRunLoop currentRunLoop] currentMode];
+    self.runLoopModes = (currentMode && ![currentMode isEqualToString:NSDefaultRunLoopMode]) ? @[NSDefaultRunLoopMode, currentMode] : @[NSDefaultRunLoopMode];
+    self.fixtureRequest = [GRVHTTPFixtureProtocol fixtureRequestForRequest:self.request];
+
+    if ([GRVHTTPFixtureProtocol mode] == GRVHTTPFixtureModeRecord) {
+        [self startRecording];
+    } else {
+        [self startReplaying];
+    }
+}
+
+- (void)stopLoading
+{
+    self.stopped = YES;
+    [self.recordingTask cancel];
+}
+
+
+#pragma mark - Instance Methods
+#pragma mark Private
+/**
+ * Execute a block on the client thread, unless loading has been stopped.
+ */
+- (void)performOnClientThread:(dispatch_block_t)block
+{
+    [self performSelector:@selector(executeBlock:)
+                 onThread:self.clientThread
+               withObject:[block copy]
+            waitUntilDone:NO
+                    modes:self.runLoopModes];
+}
+
+- (void)executeBlock:(dispatch_block_t)block
+{
+    if (!self.isStopped) block();
+}
+
+/**
+ * Make the request on the network, save its response as a fixture and pass it
+ * on to the client.
+ */
+- (void)startRecording
+{
+    NSURLRequest *request = self.fixtureRequest;
+    self.recordingTask = [[GRVHTTPFixtureProtocol recordingSession] dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        if (!error && [response isKindOfClass:[NSHTTPURLResponse class]]) {
+            [GRVHTTPFixtureProtocol saveFixtureForRequest:request response:(NSHTTPURLResponse *)response data:data];
+        }
+
+        [self performOnClientThread:^{
+            if (error) {
+                [self.client URLProtocol:self didFailWithError:error];
+                return;
+            }
+            [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+            if ([data length]) [self.client URLProtocol:self didLoadData:data];
+            [self.client URLProtocolDidFinishLoading:self];
+        }];
+    }];
+    [self.recordingTask resume];
+}
+
+/**
+ * Serve the request's fixture after the configured latency, at the configured
+ * bandwidth.
+ */
+- (void)startReplaying
+{
+    NSUserDefaults *userDefaults = [NSUserDefaults standardUserDefaults];
+    NSTimeInterval latency = MAX([userDefaults doubleForKey:kGRVHTTPFixtureLatencyKey], 0.0);
+    double bandwidth = MAX([userDefaults doubleForKey:kGRVHTTPFixtureBandwidthKey], 0.0);
+
+    NSData *fixtureData = [NSData dataWithContentsOfURL:[GRVHTTPFixtureProtocol responseURLForRequest:self.fixtureRequest]];
+    NSDictionary *fixture = fixtureData ? [NSJSONSerialization JSONObjectWithData:fixtureData options:0 error:NULL] : nil;
+    NSData *body = [NSData dataWithContentsOfURL:[GRVHTTPFixtureProtocol bodyURLForRequest:self.fixtureRequest]];
+
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(latency * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [self performOnClientThread:^{
+            if (![fixture isKindOfClass:[NSDictionary class]] || !body) {
+                NSError *error = [NSError errorWithDomain:NSURLErrorDomain
+                                                     code:NSURLErrorResourceUnavailable
+                                                 userInfo:@{NSLocalizedDescriptionKey : @"No HTTP fixture recorded for this request.",
+                                                            NSURLErrorFailingURLErrorKey : self.request.URL}];
+                [self.client URLProtocol:self didFailWithError:error];
+                return;
+            }
+
+            NSMutableDictionary *headers = [fixture[kGRVHTTPFixtureHeadersKey] mutableCopy];
+            headers[@"Content-Length"] = [NSString stringWithFormat:@"%lu", (unsigned long)[body length]];
+            NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL
+                                                                      statusCode:[fixture[kGRVHTTPFixtureStatusKey] integerValue]
+                                                                     HTTPVersion:@"HTTP/1.1"
+                                                                    headerFields:headers];
+            [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+            [self sendBody:body fromOffset:0 bandwidth:bandwidth];
+        }];
+    });
+}
+
+/**
+ * Deliver a replayed body in chunks, each after the time it would take at the
+ * given bandwidth, then finish loading.
+ *
+ * @param bandwidth     Bytes per second, or 0 to deliver the body at once.
+ */
+- (void)sendBody:(NSData *)body fromOffset:(NSUInteger)offset bandwidth:(double)bandwidth
+{
+    NSUInteger chunkLength = [body length] - offset;
+    if (bandwidth > 0.0) {
+        chunkLength = MIN(chunkLength, MAX((NSUInteger)(bandwidth / kGRVHTTPFixtureChunksPerSecond), 1));
+    }
+
+    if (chunkLength) {
+        [self.client URLProtocol:self didLoadData:[body subdataWithRange:NSMakeRange(offset, chunkLength)]];
+    }
+
+    NSUInteger nextOffset = offset + chunkLength;
+    if (nextOffset >= [body length]) {
+        [self.client URLProtocolDidFinishLoading:self];
+        return;
+    }
+
+    NSTimeInterval chunkDuration = chunkLength / bandwidth;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(chunkDuration * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [self performOnClientThread:^{
+            [self sendBody:body fromOffset:nextOffset bandwidth:bandwidth];
+        }];
+    });
+}
+
+@end
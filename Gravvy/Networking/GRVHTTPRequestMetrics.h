@@ -0,0 +1,182 @@
+//
+//  GRVHTTPRequestMetrics.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/27/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRVConstants.h"
+
+/**
+ * Value of a GRVHTTPRequestMetrics duration that wasn't measured.
+ */
+extern const NSTimeInterval GRVHTTPRequestMetricsUnmeasured;
+
+/**
+ * GRVHTTPRequestMetrics is the timing of a single HTTP request, from being
+ * scheduled till it completed.
+ *
+ * @discussion Connection phases (DNS lookup, connect, TLS), cache hits and
+ *      connection reuse come from NSURLSessionTaskMetrics which is only
+ *      available on iOS 10 and later. On earlier versions these durations are
+ *      GRVHTTPRequestMetricsUnmeasured, `detailed` is NO, and time to first
+ *      byte is measured from when the task was started till its response.
+ */
+@interface GRVHTTPRequestMetrics : NSObject
+
+#pragma mark - Properties
+/**
+ * Request's endpoint: HTTP method and URL path relative to the REST API's base
+ * URL, with identifiers replaced by ":id", e.g. "PUT videos/:id/play/".
+ * Requests to other hosts use the host and file extension, e.g.
+ * "GET cdn.example.com/*.mp4".
+ */
+@property (copy, nonatomic) NSString *endpoint;
+
+@property (nonatomic) GRVHTTPRequestClass requestClass;
+
+/**
+ * HTTP status code of the response, or 0 if there was no response.
+ */
+@property (nonatomic) NSInteger statusCode;
+
+/**
+ * Did the request fail?
+ */
+@property (nonatomic) BOOL failed;
+
+/**
+ * When the request was scheduled.
+ */
+@property (strong, nonatomic) NSDate *startDate;
+
+/**
+ * Durations, in seconds:
+ *  - queueWaitTime: waiting for a slot of the request class
+ *  - domainLookupDuration, connectDuration, secureConnectionDuration:
+ *    connection phases, all 0 on a reused connection
+ *  - timeToFirstByte: from the request being sent till the first response byte
+ *  - transferDuration: from the first response byte till completion
+ *  - totalDuration: from being scheduled till completion
+ */
+@property (nonatomic) NSTimeInterval queueWaitTime;
+@property (nonatomic) NSTimeInterval domainLookupDuration;
+@property (nonatomic) NSTimeInterval connectDuration;
+@property (nonatomic) NSTimeInterval secureConnectionDuration;
+@property (nonatomic) NSTimeInterval timeToFirstByte;
+@property (nonatomic) NSTimeInterval transferDuration;
+@property (nonatomic) NSTimeInterval totalDuration;
+
+/**
+ * Body bytes sent and received.
+ */
+@property (nonatomic) long long bytesSent;
+@property (nonatomic) long long bytesReceived;
+
+/**
+ * Are connection phases, cache hits and connection reuse measured?
+ */
+@property (nonatomic, getter=isDetailed) BOOL detailed;
+
+/**
+ * Was the response loaded from the local cache? Did the request reuse an open
+ * connection? How many redirects were followed? Only measured when detailed.
+ *
+ * @note Requests aren't retried by GRVHTTPSessionManager, so there is no
+ *      retry count; redirects are the only repeated fetches.
+ */
+@property (nonatomic, getter=isFetchedFromCache) BOOL fetchedFromCache;
+@property (nonatomic, getter=isReusedConnection) BOOL reusedConnection;
+@property (nonatomic) NSUInteger redirectCount;
+
+
+#pragma mark - Class Methods
+/**
+ * Endpoint of a request.
+ *
+ * @param request   HTTP request
+ * @param baseURL   REST API's base URL
+ *
+ * @see endpoint
+ */
++ (NSString *)endpointForRequest:(NSURLRequest *)request baseURL:(NSURL *)baseURL;
+
+
+#pragma mark - Instance Methods
+/**
+ * JSON representation of the metrics. Unmeasured durations are left out, and
+ * durations are in milliseconds.
+ */
+- (NSDictionary *)JSONObject;
+
+@end
+
+
+/**
+ * GRVHTTPMetricsBuffer is a ring buffer of the metrics of the most recent
+ * requests, which can be summarized per endpoint and exported as JSON.
+ * It is safe to use from any thread.
+ */
+@interface GRVHTTPMetricsBuffer : NSObject
+
+#pragma mark - Properties
+/**
+ * Most number of metrics kept. Older metrics are overwritten.
+ */
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/**
+ * Number of metrics ever added, including those since overwritten.
+ */
+@property (readonly) NSUInteger totalMetricsCount;
+
+
+#pragma mark - Initializers
+/**
+ * Designated initializer.
+ *
+ * @param capacity  Most number of metrics kept.
+ *
+ * @return An initialized GRVHTTPMetricsBuffer object.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+
+#pragma mark - Instance Methods
+/**
+ * Add a request's metrics, overwriting the oldest if the buffer is full.
+ */
+- (void)addMetrics:(GRVHTTPRequestMetrics *)metrics;
+
+/**
+ * Metrics in the buffer, oldest first.
+ */
+- (NSArray *)allMetrics;
+
+/**
+ * Remove all metrics.
+ */
+- (void)removeAllMetrics;
+
+/**
+ * Per endpoint summary of the metrics in the buffer, sorted by endpoint. Each
+ * summary is a JSON dictionary with the endpoint, request count, failed count,
+ * bytes received and the p50 and p95 of the total duration and time to first
+ * byte, in milliseconds.
+ */
+- (NSArray *)endpointSummaries;
+
+/**
+ * Export the buffer as a JSON object with `endpoints`, the endpoint summaries,
+ * and `requests`, the metrics oldest first.
+ *
+ * @param error     If an error occurs, upon return contains an NSError object
+ *      that describes the problem.
+ *
+ * @return UTF-8 encoded JSON data, or nil on error.
+ */
+- (NSData *)JSONDataWithError:(NSError **)error;
+
+@end
@@ -0,0 +1,278 @@
+//
+//  GRVHTTPRequestMetrics.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/27/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVHTTPRequestMetrics.h"
+
+const NSTimeInterval GRVHTTPRequestMetricsUnmeasured = -1.0;
+
+/**
+ * Names of request classes in JSON, indexed by GRVHTTPRequestClass.
+ */
+static NSString *const kGRVHTTPRequestClassJSONNames[GRVHTTPRequestClassCount] = {
+    @"metadata", @"video_bytes", @"thumbnail", @"upload", @"analytics"
+};
+
+/**
+ * Convert a duration to whole milliseconds for JSON.
+ */
+static NSNumber *GRVMillisecondsFromDuration(NSTimeInterval duration)
+{
+    return @(llround(duration * 1000.0));
+}
+
+@implementation GRVHTTPRequestMetrics
+
+#pragma mark - Class Methods
++ (NSString *)endpointForRequest:(NSURLRequest *)request baseURL:(NSURL *)baseURL
+{
+    NSURL *URL = request.URL;
+    NSString *path = URL.path ? URL.path : @"";
+    NSString *basePath = baseURL.path ? baseURL.path : @"";
+
+    NSString *endpointPath = nil;
+    if ([URL.host isEqualToString:baseURL.host] && [path hasPrefix:basePath]) {
+        // REST API endpoint: identifiers (hash keys and primary keys) are
+        // the path components with digits.
+        NSString *relativePath = [path substringFromIndex:[basePath length]];
+        if ([relativePath hasPrefix:@"/"]) relativePath = [relativePath substringFromIndex:1];
+
+        NSMutableArray *components = [NSMutableArray array];
+        for (NSString *component in [relativePath componentsSeparatedByString:@"/"]) {
+            BOOL isIdentifier = ([component rangeOfCharacterFromSet:[NSCharacterSet decimalDigitCharacterSet]].location != NSNotFound);
+            [components addObject:(isIdentifier ? @":id" : component)];
+        }
+        endpointPath = [components componentsJoinedByString:@"/"];
+        // keep the trailing slash of REST API URLs
+        if (CFURLHasDirectoryPath((__bridge CFURLRef)URL) && ![endpointPath hasSuffix:@"/"]) {
+            endpointPath = [endpointPath stringByAppendingString:@"/"];
+        }
+
+    } else {
+        // media file: group by host and file type
+        NSString *pathExtension = [path pathExtension];
+        endpointPath = [NSString stringWithFormat:@"%@/*%@%@", URL.host,
+                        ([pathExtension length] ? @"." : @""), pathExtension];
+    }
+
+    NSString *HTTPMethod = request.HTTPMethod ? request.HTTPMethod : @"GET";
+    return [NSString stringWithFormat:@"%@ %@", HTTPMethod, endpointPath];
+}
+
+
+#pragma mark - Initialization
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _queueWaitTime = GRVHTTPRequestMetricsUnmeasured;
+        _domainLookupDuration = GRVHTTPRequestMetricsUnmeasured;
+        _connectDuration = GRVHTTPRequestMetricsUnmeasured;
+        _secureConnectionDuration = GRVHTTPRequestMetricsUnmeasured;
+        _timeToFirstByte = GRVHTTPRequestMetricsUnmeasured;
+        _transferDuration = GRVHTTPRequestMetricsUnmeasured;
+        _totalDuration = GRVHTTPRequestMetricsUnmeasured;
+    }
+    return self;
+}
+
+
+#pragma mark - Instance Methods
+- (NSDictionary *)JSONObject
+{
+    NSMutableDictionary *JSONObject = [NSMutableDictionary dictionary];
+    JSONObject[@"endpoint"] = self.endpoint ? self.endpoint : @"";
+    JSONObject[@"class"] = kGRVHTTPRequestClassJSONNames[self.requestClass];
+    JSONObject[@"status"] = @(self.statusCode);
+    JSONObject[@"failed"] = @(self.failed);
+    JSONObject[@"start"] = @([self.startDate timeIntervalSince1970]);
+    JSONObject[@"bytes_sent"] = @(self.bytesSent);
+    JSONObject[@"bytes_received"] = @(self.bytesReceived);
+
+    NSDictionary *durations = @{@"queue_ms"   : @(self.queueWaitTime),
+                                @"dns_ms"     : @(self.domainLookupDuration),
+                                @"connect_ms" : @(self.connectDuration),
+                                @"tls_ms"     : @(self.secureConnectionDuration),
+                                @"ttfb_ms"    : @(self.timeToFirstByte),
+                                @"transfer_ms": @(self.transferDuration),
+                                @"total_ms"   : @(self.totalDuration)};
+    [durations enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSNumber *duration, BOOL *stop) {
+        if ([duration doubleValue] >= 0.0) {
+            JSONObject[key] = GRVMillisecondsFromDuration([duration doubleValue]);
+        }
+    }];
+
+    if (self.isDetailed) {
+        JSONObject[@"cache_hit"] = @(self.isFetchedFromCache);
+        JSONObject[@"reused_connection"] = @(self.isReusedConnection);
+        JSONObject[@"redirects"] = @(self.redirectCount);
+    }
+
+    return JSONObject;
+}
+
+@end
+
+
+@interface GRVHTTPMetricsBuffer ()
+
+/**
+ * Buffer storage, and index of the slot the next metrics go in.
+ */
+@property (strong, nonatomic) NSMutableArray *metrics;
+@property (nonatomic) NSUInteger nextIndex;
+
+// redefine readonly properties as readwrite
+@property (readwrite) NSUInteger totalMetricsCount;
+
+@end
+
+@implementation GRVHTTPMetricsBuffer
+
+#pragma mark - Class Methods
+#pragma mark Private
+/**
+ * Nearest-rank percentile of sorted values.
+ *
+ * @param percentile    Percentile, from 0.0 to 1.0
+ * @param sortedValues  NSNumber values in ascending order. Not empty.
+ */
++ (double)percentile:(double)percentile ofSortedValues:(NSArray *)sortedValues
+{
+    NSUInteger rank = (NSUInteger)ceil(percentile * [sortedValues count]);
+    NSUInteger index = (rank > 0) ? (rank - 1) : 0;
+    return [sortedValues[index] doubleValue];
+}
+
+/**
+ * JSON dictionary of the p50 and p95 of durations.
+ *
+ * @param durations     Measured durations, in seconds.
+ * @param name          Name of the duration in the JSON keys.
+ */
++ (NSDictionary *)percentilesOfDurations:(NSArray *)durations named:(NSString *)name
+{
+    if (![durations count]) return @{};
+
+    NSArray *sortedDurations = [durations sortedArrayUsingSelector:@selector(compare:)];
+    double p50 = [GRVHTTPMetricsBuffer percentile:0.50 ofSortedValues:sortedDurations];
+    double p95 = [GRVHTTPMetricsBuffer percentile:0.95 ofSortedValues:sortedDurations];
+    return @{[NSString stringWithFormat:@"%@_p50_ms", name] : GRVMillisecondsFromDuration(p50),
+             [NSString stringWithFormat:@"%@_p95_ms", name] : GRVMillisecondsFromDuration(p95)};
+}
+
+
+#pragma mark - Initialization
+- (instancetype)init
+{
+    return [self initWithCapacity:kGRVHTTPMetricsBufferCapacity];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+    self = [super init];
+    if (self) {
+        _capacity = MAX(capacity, 1);
+        _metrics = [NSMutableArray arrayWithCapacity:_capacity];
+    }
+    return self;
+}
+
+
+#pragma mark - Instance Methods
+#pragma mark Public
+- (void)addMetrics:(GRVHTTPRequestMetrics *)metrics
+{
+    if (!metrics) return;
+
+    @synchronized(self) {
+        if ([self.metrics count] < self.capacity) {
+            [self.metrics addObject:metrics];
+        } else {
+            [self.metrics replaceObjectAtIndex:self.nextIndex withObject:metrics];
+        }
+        self.nextIndex = (self.nextIndex + 1) % self.capacity;
+        self.totalMetricsCount++;
+    }
+}
+
+- (NSArray *)allMetrics
+{
+    @synchronized(self) {
+        if ([self.metrics count] < self.capacity) return [self.metrics copy];
+
+        // full buffer: the oldest metrics are in the next slot to be written
+        NSRange olderRange = NSMakeRange(self.nextIndex, self.capacity - self.nextIndex);
+        NSArray *olderMetrics = [self.metrics subarrayWithRange:olderRange];
+        NSArray *newerMetrics = [self.metrics subarrayWithRange:NSMakeRange(0, self.nextIndex)];
+        return [olderMetrics arrayByAddingObjectsFromArray:newerMetrics];
+    }
+}
+
+- (void)removeAllMetrics
+{
+    @synchronized(self) {
+        [self.metrics removeAllObjects];
+        self.nextIndex = 0;
+    }
+}
+
+- (NSArray *)endpointSummaries
+{
+    // group metrics by endpoint
+    NSMutableDictionary *metricsByEndpoint = [NSMutableDictionary dictionary];
+    for (GRVHTTPRequestMetrics *metrics in [self allMetrics]) {
+        NSString *endpoint = metrics.endpoint ? metrics.endpoint : @"";
+        NSMutableArray *endpointMetrics = metricsByEndpoint[endpoint];
+        if (!endpointMetrics) {
+            endpointMetrics = [NSMutableArray array];
+            metricsByEndpoint[endpoint] = endpointMetrics;
+        }
+        [endpointMetrics addObject:metrics];
+    }
+
+    NSMutableArray *summaries = [NSMutableArray arrayWithCapacity:[metricsByEndpoint count]];
+    for (NSString *endpoint in [[metricsByEndpoint allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        NSArray *endpointMetrics = metricsByEndpoint[endpoint];
+
+        NSMutableArray *totalDurations = [NSMutableArray arrayWithCapacity:[endpointMetrics count]];
+        NSMutableArray *timesToFirstByte = [NSMutableArray arrayWithCapacity:[endpointMetrics count]];
+        NSUInteger failedCount = 0;
+        long long bytesReceived = 0;
+        for (GRVHTTPRequestMetrics *metrics in endpointMetrics) {
+            if (metrics.totalDuration >= 0.0) [totalDurations addObject:@(metrics.totalDuration)];
+            if (metrics.timeToFirstByte >= 0.0) [timesToFirstByte addObject:@(metrics.timeToFirstByte)];
+            if (metrics.failed) failedCount++;
+            bytesReceived += metrics.bytesReceived;
+        }
+
+        NSMutableDictionary *summary = [NSMutableDictionary dictionary];
+        summary[@"endpoint"] = endpoint;
+        summary[@"count"] = @([endpointMetrics count]);
+        summary[@"failed"] = @(failedCount);
+        summary[@"bytes_received"] = @(bytesReceived);
+        [summary addEntriesFromDictionary:[GRVHTTPMetricsBuffer percentilesOfDurations:totalDurations named:@"total"]];
+        [summary addEntriesFromDictionary:[GRVHTTPMetricsBuffer percentilesOfDurations:timesToFirstByte named:@"ttfb"]];
+        [summaries addObject:summary];
+    }
+    return summaries;
+}
+
+- (NSData *)JSONDataWithError:(NSError *__autoreleasing *)error
+{
+    NSMutableArray *requests = [NSMutableArray array];
+    for (GRVHTTPRequestMetrics *metrics in [self allMetrics]) {
+        [requests addObject:[metrics JSONObject]];
+    }
+
+    NSDictionary *JSONObject = @{@"total_requests" : @(self.totalMetricsCount),
+                                 @"endpoints" : [self endpointSummaries],
+                                 @"requests" : requests};
+    return [NSJSONSerialization dataWithJSONObject:JSONObject options:NSJSONWritingPrettyPrinted error:error];
+}
+
+@end
@@ -9,6 +9,41 @@
 #import "AFHTTPSessionManager.h"
 #import "GRVConstants.h"
 
+@class GRVHTTPMetricsBuffer;
+
+/**
+ * GRVHTTPRequestClassStatistics is a snapshot of the queue measurements of a
+ * class of requests.
+ */
+@interface GRVHTTPRequestClassStatistics : NSObject
+
+/**
+ * Number of tasks waiting for a slot, number running, and the most that have
+ * been waiting at once.
+ */
+@property (nonatomic, readonly) NSUInteger queuedTasksCount;
+@property (nonatomic, readonly) NSUInteger runningTasksCount;
+@property (nonatomic, readonly) NSUInteger peakQueuedTasksCount;
+
+/**
+ * Number of finished tasks, and how many of those failed.
+ */
+@property (nonatomic, readonly) NSUInteger completedTasksCount;
+@property (nonatomic, readonly) NSUInteger failedTasksCount;
+
+/**
+ * Total time, in seconds, that started tasks spent waiting for a slot.
+ */
+@property (nonatomic, readonly) NSTimeInterval queueWaitTime;
+
+/**
+ * Total response bytes received.
+ */
+@property (nonatomic, readonly) long long bytesReceived;
+
+@end
+
+
 /**
  * `GRVHTTPSessionManager` is a subclass of `AFHTTPSessionManager` with convenience
  * methods for making HTTP requests.
@@ -22,9 +57,21 @@
  * This class can be used as an alternative to using GRVJSONResponseSerializer
  *      which embeds the response object in the error object.
  * @see GRVJSONResponseSerializer
+ *
+ * Tasks are scheduled by request class (GRVHTTPRequestClass) so one session,
+ * and its connections, can be shared by all of the app's requests. Each class
+ * has its own task priority and cap on concurrently running tasks; tasks over
+ * the cap wait, in order, for a running task of their class to finish.
  */
 @interface GRVHTTPSessionManager : AFHTTPSessionManager
 
+#pragma mark - Properties
+/**
+ * Timing metrics of the most recent requests.
+ */
+@property (strong, nonatomic, readonly) GRVHTTPMetricsBuffer *metricsBuffer;
+
+
 #pragma mark - Class Methods
 /**
  * convert an GRVHTTPMethod to a standard HTTP method String
@@ -34,6 +81,11 @@
  */
 + (NSString *)httpMethodToString:(GRVHTTPMethod)httpMethod;
 
+/**
+ * Maximum number of concurrently running tasks of a request class.
+ */
++ (NSUInteger)maxConcurrentTasksForRequestClass:(GRVHTTPRequestClass)requestClass;
+
 
 #pragma mark - Instance Methods
 /**
@@ -68,6 +120,75 @@
                           success:(void (^)(NSURLSessionDataTask *task, id responseObject))success
                           failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure;
 
+/**
+ * Same as request:forURL:parameters:success:failure: but with per-request
+ * headers and for a given request class instead of GRVHTTPRequestClassMetadata.
+ *
+ * @param headers
+ *      HTTP headers added to this request only, on top of the request
+ *      serializer's. The serializer's headers are never mutated so this is how
+ *      authorization headers are set, which keeps concurrent requests safe.
+ */
+- (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
+                           forURL:(NSString *)URLString
+                       parameters:(id)parameters
+                          headers:(NSDictionary *)headers
+                     requestClass:(GRVHTTPRequestClass)requestClass
+                          success:(void (^)(NSURLSessionDataTask *task, id responseObject))success
+                          failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure;
+
+/**
+ * Creates and schedules an `NSURLSessionDataTask` for a request.
+ *
+ * @param request
+ *      The HTTP request for the task.
+ * @param requestClass
+ *      Class of the request, which determines its priority and when it starts.
+ * @param didReceiveData
+ *      A block object to be executed, on the session's delegate queue, each
+ *      time response data is received. This block has no return value and
+ *      takes two arguments: the data task, and the data just received.
+ * @param completionHandler
+ *      A block object to be executed when the task finishes. This block has no
+ *      return value and takes three arguments: the server response, the
+ *      response object created by the response serializer, and the error that
+ *      occurred, if any.
+ *
+ * @return the task, which is started by the scheduler and so shouldn't be
+ *      resumed by the caller.
+ */
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request
+                                 requestClass:(GRVHTTPRequestClass)requestClass
+                               didReceiveData:(void (^)(NSURLSessionDataTask *task, NSData *data))didReceiveData
+                            completionHandler:(void (^)(NSURLResponse *response, id responseObject, NSError *error))completionHandler;
+
+/**
+ * Creates and schedules an `NSURLSessionDataTask` whose response is only
+ * streamed to its didReceiveData block and never buffered, for large
+ * downloads that the caller keeps its own copy of.
+ *
+ * @param request
+ *      The HTTP request for the task.
+ * @param requestClass
+ *      Class of the request, which determines its priority and when it starts.
+ * @param didReceiveData
+ *      A block object to be executed, on the session's delegate queue, each
+ *      time response data is received. This block has no return value and
+ *      takes two arguments: the data task, and the data just received.
+ * @param completionHandler
+ *      A block object to be executed, on the session's delegate queue, when
+ *      the task finishes. This block has no return value and takes two
+ *      arguments: the server response and the error that occurred, if any.
+ *      The response isn't validated by the response serializer.
+ *
+ * @return the task, which is started by the scheduler and so shouldn't be
+ *      resumed by the caller. Cancel it to give up its slot.
+ */
+- (NSURLSessionDataTask *)streamingDataTaskWithRequest:(NSURLRequest *)request
+                                          requestClass:(GRVHTTPRequestClass)requestClass
+                                        didReceiveData:(void (^)(NSURLSessionDataTask *task, NSData *data))didReceiveData
+                                     completionHandler:(void (^)(NSURLResponse *response, NSError *error))completionHandler;
+
 /**
  * Creates and runs an `NSURLSessionDataTask` with a multipart `POST`/`PUT`/`PATCH`
  * request.
@@ -96,16 +217,46 @@
  *
  * @see -dataTaskWithRequest:completionHandler:
  *
- * @warning I would recommend you not use this but instead use a HTTPRequestOperation
- *      for a multi-part request. That solution is cleaner. This solution is
- *      included for completeness but look at this method's gory implementation
- *      details for more.
+ * @note The upload task is created once the multipart body has been written
+ *      to a temporary file, so this returns nil. Uploads are scheduled as
+ *      GRVHTTPRequestClassUpload.
+ */
+- (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
+                           forURL:(NSString *)URLString
+                       parameters:(id)parameters
+        constructingBodyWithBlock:(void (^)(id <AFMultipartFormData> formData))block
+                          success:(void (^)(NSURLSessionDataTask *task, id responseObject))success
+                          failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure;
+
+/**
+ * Same as request:forURL:parameters:constructingBodyWithBlock:success:failure:
+ * but with per-request headers.
+ *
+ * @see request:forURL:parameters:headers:requestClass:success:failure:
  */
 - (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
                            forURL:(NSString *)URLString
                        parameters:(id)parameters
+                          headers:(NSDictionary *)headers
         constructingBodyWithBlock:(void (^)(id <AFMultipartFormData> formData))block
                           success:(void (^)(NSURLSessionDataTask *task, id responseObject))success
                           failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure;
 
+#pragma mark Measurements
+/**
+ * Snapshot of the queue measurements of a request class.
+ */
+- (GRVHTTPRequestClassStatistics *)statisticsForRequestClass:(GRVHTTPRequestClass)requestClass;
+
+/**
+ * Reset the measurements of all request classes and remove all request
+ * metrics. Queued and running task counts aren't affected.
+ */
+- (void)resetMeasurements;
+
+/**
+ * Summary of the measurements of all request classes, for logging.
+ */
+- (NSString *)measurementsDescription;
+
 @end
@@ -7,6 +7,126 @@
 //
 
 #import "GRVHTTPSessionManager.h"
+#import "GRVHTTPRequestMetrics.h"
+
+/**
+ * Scheduling configuration of a request class.
+ */
+typedef struct {
+    NSUInteger maxConcurrentTasks;
+    float priority; // NSURLSessionTask priority, from 0.0 (low) to 1.0 (high)
+} GRVHTTPRequestClassConfig;
+
+/**
+ * Request class configurations, indexed by GRVHTTPRequestClass.
+ * Priorities are the values of NSURLSessionTaskPriorityHigh/Default/Low, which
+ * aren't available on iOS 7.
+ */
+static const GRVHTTPRequestClassConfig kGRVHTTPRequestClassConfigs[GRVHTTPRequestClassCount] = {
+    {4, 0.75f}, // GRVHTTPRequestClassMetadata
+    {2, 0.75f}, // GRVHTTPRequestClassVideoBytes
+    {4, 0.5f},  // GRVHTTPRequestClassThumbnail
+    {1, 0.5f},  // GRVHTTPRequestClassUpload
+    {1, 0.25f}, // GRVHTTPRequestClassAnalytics
+};
+
+
+@interface GRVHTTPRequestClassStatistics ()
+
+// redefine readonly properties as readwrite
+@property (nonatomic, readwrite) NSUInteger queuedTasksCount;
+@property (nonatomic, readwrite) NSUInteger runningTasksCount;
+@property (nonatomic, readwrite) NSUInteger peakQueuedTasksCount;
+@property (nonatomic, readwrite) NSUInteger completedTasksCount;
+@property (nonatomic, readwrite) NSUInteger failedTasksCount;
+@property (nonatomic, readwrite) NSTimeInterval queueWaitTime;
+@property (nonatomic, readwrite) long long bytesReceived;
+
+@end
+
+@implementation GRVHTTPRequestClassStatistics
+@end
+
+
+/**
+ * A task scheduled by the session manager.
+ */
+@interface GRVHTTPScheduledTask : NSObject
+
+@property (strong, nonatomic) NSURLSessionTask *task;
+@property (nonatomic) GRVHTTPRequestClass requestClass;
+@property (strong, nonatomic) NSDate *enqueueDate;
+@property (copy, nonatomic) void (^didReceiveData)(NSURLSessionDataTask *task, NSData *data);
+
+/**
+ * Completion handler of a streaming task, which AFNetworking doesn't manage.
+ */
+@property (copy, nonatomic) void (^streamingCompletionHandler)(NSURLResponse *response, NSError *error);
+
+/**
+ * When the task was started and when its response was received.
+ */
+@property (strong, nonatomic) NSDate *resumeDate;
+@property (strong, nonatomic) NSDate *responseDate;
+
+/**
+ * The task's metrics, filled in as it runs.
+ */
+@property (strong, nonatomic) GRVHTTPRequestMetrics *metrics;
+
+@end
+
+@implementation GRVHTTPScheduledTask
+@end
+
+
+/**
+ * Waiting tasks and measurements of a request class.
+ */
+@interface GRVHTTPRequestClassQueue : NSObject
+
+@property (strong, nonatomic) NSMutableArray *queuedTasks;
+@property (nonatomic) NSUInteger runningTasksCount;
+@property (strong, nonatomic) GRVHTTPRequestClassStatistics *statistics;
+
+@end
+
+@implementation GRVHTTPRequestClassQueue
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _queuedTasks = [NSMutableArray array];
+        _statistics = [[GRVHTTPRequestClassStatistics alloc] init];
+    }
+    return self;
+}
+
+@end
+
+
+@interface GRVHTTPSessionManager ()
+
+/**
+ * Serial queue that all scheduling state is accessed on.
+ */
+@property (strong, nonatomic) dispatch_queue_t schedulerQueue;
+
+/**
+ * GRVHTTPRequestClassQueue objects indexed by GRVHTTPRequestClass.
+ */
+@property (strong, nonatomic) NSArray *requestClassQueues;
+
+/**
+ * Scheduled tasks that haven't completed, keyed by task identifier.
+ */
+@property (strong, nonatomic) NSMutableDictionary *scheduledTasks;
+
+// redefine readonly properties as readwrite
+@property (strong, nonatomic, readwrite) GRVHTTPMetricsBuffer *metricsBuffer;
+
+@end
 
 @implementation GRVHTTPSessionManager
 
@@ -49,11 +169,286 @@
     return requestMethod;
 }
 
++ (NSUInteger)maxConcurrentTasksForRequestClass:(GRVHTTPRequestClass)requestClass
+{
+    return kGRVHTTPRequestClassConfigs[requestClass].maxConcurrentTasks;
+}
+
+
+#pragma mark - Initialization
+- (instancetype)initWithBaseURL:(NSURL *)url sessionConfiguration:(NSURLSessionConfiguration *)configuration
+{
+    self = [super initWithBaseURL:url sessionConfiguration:configuration];
+    if (self) {
+        _schedulerQueue = dispatch_queue_create("com.nceruchalu.gravvy.httpscheduler", DISPATCH_QUEUE_SERIAL);
+        _scheduledTasks = [NSMutableDictionary dictionary];
+        
+        NSMutableArray *requestClassQueues = [NSMutableArray arrayWithCapacity:GRVHTTPRequestClassCount];
+        for (NSUInteger requestClass = 0; requestClass < GRVHTTPRequestClassCount; requestClass++) {
+            [requestClassQueues addObject:[[GRVHTTPRequestClassQueue alloc] init]];
+        }
+        _requestClassQueues = requestClassQueues;
+        _metricsBuffer = [[GRVHTTPMetricsBuffer alloc] initWithCapacity:kGRVHTTPMetricsBufferCapacity];
+        
+        // Note when responses start, for time to first byte.
+        __weak GRVHTTPSessionManager *weakSelf = self;
+        [self setDataTaskDidReceiveResponseBlock:^NSURLSessionResponseDisposition(NSURLSession *session, NSURLSessionDataTask *dataTask, NSURLResponse *response) {
+            [weakSelf dataTaskDidReceiveResponse:dataTask];
+            return NSURLSessionResponseAllow;
+        }];
+        
+        // Route received data to the scheduled task it belongs to. This is
+        // called on the session's delegate queue.
+        [self setDataTaskDidReceiveDataBlock:^(NSURLSession *session, NSURLSessionDataTask *dataTask, NSData *data) {
+            [weakSelf dataTask:dataTask didReceiveData:data];
+        }];
+        
+        // Streaming tasks have no AFNetworking task delegate to complete them.
+        [self setTaskDidCompleteBlock:^(NSURLSession *session, NSURLSessionTask *task, NSError *error) {
+            [weakSelf streamingTaskDidComplete:task withError:error];
+        }];
+    }
+    return self;
+}
+
+
 #pragma mark - Instance methods
+#pragma mark Private
+/**
+ * Start as many of a request class's queued tasks as its cap allows.
+ *
+ * @warning Call this on the scheduler queue.
+ */
+- (void)startQueuedTasksOfRequestClass:(GRVHTTPRequestClass)requestClass
+{
+    GRVHTTPRequestClassQueue *classQueue = self.requestClassQueues[requestClass];
+    NSUInteger maxConcurrentTasks = kGRVHTTPRequestClassConfigs[requestClass].maxConcurrentTasks;
+    
+    while ([classQueue.queuedTasks count] && (classQueue.runningTasksCount < maxConcurrentTasks)) {
+        GRVHTTPScheduledTask *scheduledTask = [classQueue.queuedTasks firstObject];
+        [classQueue.queuedTasks removeObjectAtIndex:0];
+        
+        if (scheduledTask.task.state != NSURLSessionTaskStateSuspended) {
+            // cancelled before it was even scheduled, so it has completed
+            // without us knowing about it
+            [self.scheduledTasks removeObjectForKey:@(scheduledTask.task.taskIdentifier)];
+            continue;
+        }
+        
+        classQueue.runningTasksCount++;
+        scheduledTask.resumeDate = [NSDate date];
+        scheduledTask.metrics.queueWaitTime = [scheduledTask.resumeDate timeIntervalSinceDate:scheduledTask.enqueueDate];
+        classQueue.statistics.queueWaitTime += scheduledTask.metrics.queueWaitTime;
+        [scheduledTask.task resume];
+    }
+}
+
+/**
+ * Add a task to its request class's queue and start it if the cap allows.
+ */
+- (void)scheduleTask:(NSURLSessionTask *)task
+        requestClass:(GRVHTTPRequestClass)requestClass
+      didReceiveData:(void (^)(NSURLSessionDataTask *task, NSData *data))didReceiveData
+{
+    [self scheduleTask:task requestClass:requestClass didReceiveData:didReceiveData streamingCompletionHandler:nil];
+}
+
+/**
+ * Add a task to its request class's queue and start it if the cap allows.
+ *
+ * @param streamingCompletionHandler
+ *      Completion handler of a task not managed by AFNetworking, or nil.
+ */
+- (void)scheduleTask:(NSURLSessionTask *)task
+        requestClass:(GRVHTTPRequestClass)requestClass
+      didReceiveData:(void (^)(NSURLSessionDataTask *task, NSData *data))didReceiveData
+streamingCompletionHandler:(void (^)(NSURLResponse *response, NSError *error))streamingCompletionHandler
+{
+    if ([task respondsToSelector:@selector(setPriority:)]) {
+        task.priority = kGRVHTTPRequestClassConfigs[requestClass].priority;
+    }
+    
+    GRVHTTPScheduledTask *scheduledTask = [[GRVHTTPScheduledTask alloc] init];
+    scheduledTask.task = task;
+    scheduledTask.requestClass = requestClass;
+    scheduledTask.enqueueDate = [NSDate date];
+    scheduledTask.didReceiveData = didReceiveData;
+    scheduledTask.streamingCompletionHandler = streamingCompletionHandler;
+    
+    GRVHTTPRequestMetrics *metrics = [[GRVHTTPRequestMetrics alloc] init];
+    metrics.endpoint = [GRVHTTPRequestMetrics endpointForRequest:task.originalRequest baseURL:self.baseURL];
+    metrics.requestClass = requestClass;
+    metrics.startDate = scheduledTask.enqueueDate;
+    scheduledTask.metrics = metrics;
+    
+    dispatch_async(self.schedulerQueue, ^{
+        [self.scheduledTasks setObject:scheduledTask forKey:@(task.taskIdentifier)];
+        
+        GRVHTTPRequestClassQueue *classQueue = self.requestClassQueues[requestClass];
+        [classQueue.queuedTasks addObject:scheduledTask];
+        classQueue.statistics.peakQueuedTasksCount = MAX(classQueue.statistics.peakQueuedTasksCount,
+                                                         [classQueue.queuedTasks count]);
+        [self startQueuedTasksOfRequestClass:requestClass];
+    });
+}
+
+/**
+ * Free a completed task's slot and start the next queued task of its class.
+ */
+- (void)finishTask:(NSURLSessionTask *)task withError:(NSError *)error
+{
+    dispatch_async(self.schedulerQueue, ^{
+        GRVHTTPScheduledTask *scheduledTask = [self.scheduledTasks objectForKey:@(task.taskIdentifier)];
+        if (!scheduledTask) return;
+        [self.scheduledTasks removeObjectForKey:@(task.taskIdentifier)];
+        
+        GRVHTTPRequestClassQueue *classQueue = self.requestClassQueues[scheduledTask.requestClass];
+        classQueue.statistics.completedTasksCount++;
+        if (error) classQueue.statistics.failedTasksCount++;
+        
+        if ([classQueue.queuedTasks containsObject:scheduledTask]) {
+            // cancelled before it was started so it never had a slot
+            [classQueue.queuedTasks removeObject:scheduledTask];
+        } else {
+            classQueue.runningTasksCount--;
+            [self startQueuedTasksOfRequestClass:scheduledTask.requestClass];
+        }
+        
+        [self recordMetricsOfScheduledTask:scheduledTask withError:error];
+    });
+}
+
+/**
+ * Complete a finished task's metrics and add them to the metrics buffer.
+ *
+ * @warning Call this on the scheduler queue.
+ */
+- (void)recordMetricsOfScheduledTask:(GRVHTTPScheduledTask *)scheduledTask withError:(NSError *)error
+{
+    NSDate *completionDate = [NSDate date];
+    NSURLSessionTask *task = scheduledTask.task;
+    GRVHTTPRequestMetrics *metrics = scheduledTask.metrics;
+    
+    metrics.failed = (error != nil);
+    if ([task.response isKindOfClass:[NSHTTPURLResponse class]]) {
+        metrics.statusCode = ((NSHTTPURLResponse *)task.response).statusCode;
+    }
+    metrics.bytesSent = task.countOfBytesSent;
+    metrics.bytesReceived = task.countOfBytesReceived;
+    metrics.totalDuration = [completionDate timeIntervalSinceDate:scheduledTask.enqueueDate];
+    
+    // Without detailed metrics, time from the task starting till its response
+    // is the best available time to first byte.
+    if (scheduledTask.responseDate) {
+        if (!metrics.isDetailed && scheduledTask.resumeDate) {
+            metrics.timeToFirstByte = [scheduledTask.responseDate timeIntervalSinceDate:scheduledTask.resumeDate];
+        }
+        metrics.transferDuration = [completionDate timeIntervalSinceDate:scheduledTask.responseDate];
+    }
+    
+    [self.metricsBuffer addMetrics:metrics];
+}
+
+/**
+ * Note when a task's response was received.
+ */
+- (void)dataTaskDidReceiveResponse:(NSURLSessionDataTask *)dataTask
+{
+    NSDate *responseDate = [NSDate date];
+    dispatch_async(self.schedulerQueue, ^{
+        GRVHTTPScheduledTask *scheduledTask = [self.scheduledTasks objectForKey:@(dataTask.taskIdentifier)];
+        scheduledTask.responseDate = responseDate;
+    });
+}
+
+/**
+ * Measure data received by a task and pass it on to the task's data handler.
+ */
+- (void)dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data
+{
+    __block GRVHTTPScheduledTask *scheduledTask = nil;
+    dispatch_sync(self.schedulerQueue, ^{
+        scheduledTask = [self.scheduledTasks objectForKey:@(dataTask.taskIdentifier)];
+        if (scheduledTask) {
+            GRVHTTPRequestClassQueue *classQueue = self.requestClassQueues[scheduledTask.requestClass];
+            classQueue.statistics.bytesReceived += [data length];
+        }
+    });
+    
+    if (scheduledTask.didReceiveData) scheduledTask.didReceiveData(dataTask, data);
+}
+
+/**
+ * Finish a streaming task and call its completion handler. Tasks managed by
+ * AFNetworking are finished by their own completion handlers.
+ */
+- (void)streamingTaskDidComplete:(NSURLSessionTask *)task withError:(NSError *)error
+{
+    __block void (^completionHandler)(NSURLResponse *response, NSError *error) = nil;
+    dispatch_sync(self.schedulerQueue, ^{
+        GRVHTTPScheduledTask *scheduledTask = [self.scheduledTasks objectForKey:@(task.taskIdentifier)];
+        completionHandler = scheduledTask.streamingCompletionHandler;
+    });
+    if (!completionHandler) return;
+    
+    [self finishTask:task withError:error];
+    completionHandler(task.response, error);
+}
+
+/**
+ * Add per-request headers to a request.
+ */
+- (void)addHeaders:(NSDictionary *)headers toRequest:(NSMutableURLRequest *)request
+{
+    [headers enumerateKeysAndObjectsUsingBlock:^(NSString *field, NSString *value, BOOL *stop) {
+        [request setValue:value forHTTPHeaderField:field];
+    }];
+}
+
 #pragma mark Public
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request
+                                 requestClass:(GRVHTTPRequestClass)requestClass
+                               didReceiveData:(void (^)(NSURLSessionDataTask *task, NSData *data))didReceiveData
+                            completionHandler:(void (^)(NSURLResponse *response, id responseObject, NSError *error))completionHandler
+{
+    __block NSURLSessionDataTask *task = [self dataTaskWithRequest:request completionHandler:^(NSURLResponse *response, id responseObject, NSError *error) {
+        [self finishTask:task withError:error];
+        if (completionHandler) completionHandler(response, responseObject, error);
+    }];
+    
+    [self scheduleTask:task requestClass:requestClass didReceiveData:didReceiveData];
+    
+    return task;
+}
+
+- (NSURLSessionDataTask *)streamingDataTaskWithRequest:(NSURLRequest *)request
+                                          requestClass:(GRVHTTPRequestClass)requestClass
+                                        didReceiveData:(void (^)(NSURLSessionDataTask *task, NSData *data))didReceiveData
+                                     completionHandler:(void (^)(NSURLResponse *response, NSError *error))completionHandler
+{
+    // Created on the session directly so AFNetworking doesn't also buffer the
+    // response.
+    NSURLSessionDataTask *task = [self.session dataTaskWithRequest:request];
+    
+    [self scheduleTask:task requestClass:requestClass didReceiveData:didReceiveData streamingCompletionHandler:completionHandler];
+    
+    return task;
+}
+
+- (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
+                           forURL:(NSString *)URLString
+                       parameters:(id)parameters
+                          success:(void (^)(NSURLSessionDataTask *task, id responseObject))success
+                          failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure
+{
+    return [self request:httpMethod forURL:URLString parameters:parameters headers:nil requestClass:GRVHTTPRequestClassMetadata success:success failure:failure];
+}
+
 - (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
                            forURL:(NSString *)URLString
                        parameters:(id)parameters
+                          headers:(NSDictionary *)headers
+                     requestClass:(GRVHTTPRequestClass)requestClass
                           success:(void (^)(NSURLSessionDataTask *task, id responseObject))success
                           failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure
 {
@@ -64,8 +459,9 @@
     // This block of code was common to a lot of functions in AFTTPSessionManager
     // so it made for easy re-use.
     NSMutableURLRequest *request = [self.requestSerializer requestWithMethod:httpRequestMethod URLString:[[NSURL URLWithString:URLString relativeToURL:self.baseURL] absoluteString] parameters:parameters error:nil];
+    [self addHeaders:headers toRequest:request];
     
-    __block NSURLSessionDataTask *task = [self dataTaskWithRequest:request completionHandler:^(NSURLResponse * __unused response, id responseObject, NSError *error) {
+    __block NSURLSessionDataTask *task = [self dataTaskWithRequest:request requestClass:requestClass didReceiveData:nil completionHandler:^(NSURLResponse * __unused response, id responseObject, NSError *error) {
         if (error) {
             if (failure) {
                 failure(task, error, responseObject);
@@ -77,17 +473,25 @@
         }
     }];
     
-    [task resume];
-    
     return task;
 }
 
+- (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
+                           forURL:(NSString *)URLString
+                       parameters:(id)parameters
+        constructingBodyWithBlock:(void (^)(id <AFMultipartFormData> formData))block
+                          success:(void (^)(NSURLSessionDataTask *task, id responseObject))success
+                          failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure
+{
+    return [self request:httpMethod forURL:URLString parameters:parameters headers:nil constructingBodyWithBlock:block success:success failure:failure];
+}
+
 // See Github issue for explanation of this solution
 // https://github.com/AFNetworking/AFNetworking/issues/1398
-// Probably easier & cleaner to just use a HTTPRequestOperation...
 - (NSURLSessionDataTask *)request:(GRVHTTPMethod)httpMethod
                            forURL:(NSString *)URLString
                        parameters:(id)parameters
+                          headers:(NSDictionary *)headers
         constructingBodyWithBlock:(void (^)(id <AFMultipartFormData> formData))block
                           success:(void (^)(NSURLSessionDataTask *task, id responseObject))success
                           failure:(void (^)(NSURLSessionDataTask *task, NSError *error, id responseObject))failure
@@ -102,6 +506,7 @@
     NSString *httpRequestMethod = [GRVHTTPSessionManager httpMethodToString:httpMethod];
     
     NSMutableURLRequest *request = [self.requestSerializer multipartFormRequestWithMethod:httpRequestMethod URLString:[[NSURL URLWithString:URLString relativeToURL:self.baseURL] absoluteString] parameters:parameters constructingBodyWithBlock:block error:nil];
+    [self addHeaders:headers toRequest:request];
     
     // Prepare a temporary file to store the multipart request prior to sending
     // it to the server due to an alleged bug in NSURLSessionTask.
@@ -120,6 +525,8 @@
          // We are, however, forcing the body stream to be read from the temporary
          // file.
          __block NSURLSessionUploadTask *task = [self  uploadTaskWithRequest:request fromFile:tmpFileUrl progress:nil completionHandler:^(NSURLResponse * __unused response, id responseObject, NSError *error) {
+             [self finishTask:task withError:error];
+             
              // Cleanup: remove temporary file.
              [[NSFileManager defaultManager] removeItemAtURL:tmpFileUrl error:nil];
              
@@ -135,12 +542,101 @@
              }
          }];
          
-         // Start the file upload.
-         [task resume];
+         // Start the file upload once an upload slot is free.
+         [self scheduleTask:task requestClass:GRVHTTPRequestClassUpload didReceiveData:nil];
      }];
     
     // this function should return void
     return nil;
 }
 
+#pragma mark Measurements
+- (GRVHTTPRequestClassStatistics *)statisticsForRequestClass:(GRVHTTPRequestClass)requestClass
+{
+    GRVHTTPRequestClassStatistics *snapshot = [[GRVHTTPRequestClassStatistics alloc] init];
+    dispatch_sync(self.schedulerQueue, ^{
+        GRVHTTPRequestClassQueue *classQueue = self.requestClassQueues[requestClass];
+        GRVHTTPRequestClassStatistics *statistics = classQueue.statistics;
+        snapshot.queuedTasksCount = [classQueue.queuedTasks count];
+        snapshot.runningTasksCount = classQueue.runningTasksCount;
+        snapshot.peakQueuedTasksCount = statistics.peakQueuedTasksCount;
+        snapshot.completedTasksCount = statistics.completedTasksCount;
+        snapshot.failedTasksCount = statistics.failedTasksCount;
+        snapshot.queueWaitTime = statistics.queueWaitTime;
+        snapshot.bytesReceived = statistics.bytesReceived;
+    });
+    return snapshot;
+}
+
+- (void)resetMeasurements
+{
+    dispatch_async(self.schedulerQueue, ^{
+        for (GRVHTTPRequestClassQueue *classQueue in self.requestClassQueues) {
+            classQueue.statistics = [[GRVHTTPRequestClassStatistics alloc] init];
+        }
+    });
+    [self.metricsBuffer removeAllMetrics];
+}
+
+- (NSString *)measurementsDescription
+{
+    static NSString *const requestClassNames[GRVHTTPRequestClassCount] = {
+        @"metadata", @"video bytes", @"thumbnail", @"upload", @"analytics"
+    };
+    
+    NSMutableArray *descriptions = [NSMutableArray arrayWithCapacity:GRVHTTPRequestClassCount];
+    for (NSUInteger requestClass = 0; requestClass < GRVHTTPRequestClassCount; requestClass++) {
+        GRVHTTPRequestClassStatistics *statistics = [self statisticsForRequestClass:requestClass];
+        NSTimeInterval averageQueueWaitTime = statistics.completedTasksCount ? (statistics.queueWaitTime / statistics.completedTasksCount) : 0.0;
+        [descriptions addObject:[NSString stringWithFormat:@"%@: %lu running, %lu queued (peak %lu), %lu completed (%lu failed), %.3fs avg wait, %lld bytes",
+                                 requestClassNames[requestClass],
+                                 (unsigned long)statistics.runningTasksCount, (unsigned long)statistics.queuedTasksCount,
+                                 (unsigned long)statistics.peakQueuedTasksCount, (unsigned long)statistics.completedTasksCount,
+                                 (unsigned long)statistics.failedTasksCount, averageQueueWaitTime, statistics.bytesReceived]];
+    }
+    return [NSString stringWithFormat:@"HTTP transport: %@", [descriptions componentsJoinedByString:@"; "]];
+}
+
+
+#pragma mark - NSURLSessionTaskDelegate
+#ifdef __IPHONE_10_0
+// Only called on iOS 10 and later, as NSURLSessionTaskMetrics isn't available
+// earlier. This is called before the task completes.
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)taskMetrics
+{
+    // the last transaction is the one that produced the response
+    NSURLSessionTaskTransactionMetrics *transaction = [taskMetrics.transactionMetrics lastObject];
+    NSUInteger redirectCount = taskMetrics.redirectCount;
+    
+    dispatch_async(self.schedulerQueue, ^{
+        GRVHTTPRequestMetrics *metrics = [[self.scheduledTasks objectForKey:@(task.taskIdentifier)] metrics];
+        if (!metrics || !transaction) return;
+        
+        metrics.detailed = YES;
+        metrics.redirectCount = redirectCount;
+        metrics.fetchedFromCache = (transaction.resourceFetchType == NSURLSessionTaskMetricsResourceFetchTypeLocalCache);
+        metrics.reusedConnection = transaction.isReusedConnection;
+        
+        if (transaction.domainLookupStartDate && transaction.domainLookupEndDate) {
+            metrics.domainLookupDuration = [transaction.domainLookupEndDate timeIntervalSinceDate:transaction.domainLookupStartDate];
+        }
+        if (transaction.connectStartDate && transaction.connectEndDate) {
+            metrics.connectDuration = [transaction.connectEndDate timeIntervalSinceDate:transaction.connectStartDate];
+        }
+        if (transaction.secureConnectionStartDate && transaction.secureConnectionEndDate) {
+            metrics.secureConnectionDuration = [transaction.secureConnectionEndDate timeIntervalSinceDate:transaction.secureConnectionStartDate];
+        }
+        if (metrics.isReusedConnection || metrics.isFetchedFromCache) {
+            // no connection was set up
+            metrics.domainLookupDuration = 0.0;
+            metrics.connectDuration = 0.0;
+            metrics.secureConnectionDuration = 0.0;
+        }
+        if (transaction.requestStartDate && transaction.responseStartDate) {
+            metrics.timeToFirstByte = [transaction.responseStartDate timeIntervalSinceDate:transaction.requestStartDate];
+        }
+    });
+}
+#endif
+
 @end
@@ -0,0 +1,63 @@
+//
+//  GRVJSONListReader.h
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/25/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ * `GRVJSONListReader` is an enumerator over the elements of a JSON list, such
+ * as the `results` list of a REST API list response, read straight from the
+ * response data.
+ *
+ * @discussion Only the list's elements are parsed into Foundation objects, one
+ *      at a time as they are enumerated, so a large response never exists as a
+ *      single Foundation tree. Together with a batched import this means only a
+ *      batch of records is in memory at once.
+ *
+ *      The list's enclosing object is scanned but not parsed, so its other
+ *      members (like `count` and `next`) aren't available.
+ *
+ *      Enumeration ends early on malformed JSON, in which case `error` is set.
+ *      Check it before treating the enumerated elements as the complete list.
+ */
+@interface GRVJSONListReader : NSEnumerator
+
+#pragma mark - Properties
+/**
+ * Number of list elements enumerated so far.
+ */
+@property (nonatomic, readonly) NSUInteger objectsCount;
+
+/**
+ * Description of the malformed JSON that ended enumeration, or nil.
+ */
+@property (strong, nonatomic, readonly) NSError *error;
+
+
+#pragma mark - Class Methods
+/**
+ * Create a reader of a list in JSON data.
+ *
+ * @param data      UTF-8 encoded JSON data, as received from the server.
+ * @param listKey   Key of the list in the top-level JSON object, or nil if the
+ *      top-level JSON value is the list.
+ *
+ * @return An initialized GRVJSONListReader object.
+ */
++ (instancetype)readerWithData:(NSData *)data listKey:(NSString *)listKey;
+
+
+#pragma mark - Instance Methods
+/**
+ * Parse the next element of the list.
+ *
+ * @return the next element's Foundation object, or nil at the end of the list
+ *      or on malformed JSON.
+ */
+- (id)nextObject;
+
+@end
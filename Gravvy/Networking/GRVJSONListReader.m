@@ -0,0 +1,267 @@
+//
+//  GRVJSONListReader.m
+//  Gravvy
+//
+//  Created by Nnoduka Eruchalu on 8/25/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import "GRVJSONListReader.h"
+
+/**
+ * Scanning functions. Each takes the JSON bytes, their length and a position
+ * and returns the position just past what was scanned. A position of length
+ * or more means the data ended before a token did.
+ */
+
+/**
+ * Skip JSON whitespace starting at a position.
+ */
+static NSUInteger GRVJSONSkipWhitespace(const uint8_t *bytes, NSUInteger length, NSUInteger position)
+{
+    while ((position < length) &&
+           ((bytes[position] == ' ') || (bytes[position] == '\t') ||
+            (bytes[position] == '\n') || (bytes[position] == '\r'))) {
+        position++;
+    }
+    return position;
+}
+
+/**
+ * Skip a string whose opening quote is at a position.
+ */
+static NSUInteger GRVJSONSkipString(const uint8_t *bytes, NSUInteger length, NSUInteger position)
+{
+    position++; // opening quote
+    while (position < length) {
+        uint8_t byte = bytes[position++];
+        if (byte == '\\') {
+            position++; // escaped character
+        } else if (byte == '"') {
+            return position;
+        }
+    }
+    return NSNotFound;
+}
+
+/**
+ * Skip a value (object, array, string or literal) starting at a position.
+ * Containers are skipped by tracking nesting depth, so nothing is parsed.
+ */
+static NSUInteger GRVJSONSkipValue(const uint8_t *bytes, NSUInteger length, NSUInteger position)
+{
+    if (position >= length) return NSNotFound;
+
+    uint8_t byte = bytes[position];
+    if (byte == '"') return GRVJSONSkipString(bytes, length, position);
+
+    if ((byte == '{') || (byte == '[')) {
+        NSUInteger depth = 0;
+        while (position < length) {
+            byte = bytes[position];
+            if (byte == '"') {
+                position = GRVJSONSkipString(bytes, length, position);
+                if (position == NSNotFound) return NSNotFound;
+                continue;
+            }
+            if ((byte == '{') || (byte == '[')) {
+                depth++;
+            } else if ((byte == '}') || (byte == ']')) {
+                depth--;
+                if (depth == 0) return position + 1;
+            }
+            position++;
+        }
+        return NSNotFound;
+    }
+
+    // number, true, false or null
+    while ((position < length) && (bytes[position] != ',') &&
+           (bytes[position] != '}') && (bytes[position] != ']') &&
+           (bytes[position] != ' ') && (bytes[position] != '\t') &&
+           (bytes[position] != '\n') && (bytes[position] != '\r')) {
+        position++;
+    }
+    return position;
+}
+
+
+@interface GRVJSONListReader ()
+
+@property (strong, nonatomic) NSData *data;
+@property (copy, nonatomic) NSString *listKey;
+
+/**
+ * Position of the next list element, or of the comma or bracket before it.
+ */
+@property (nonatomic) NSUInteger position;
+
+/**
+ * Has the opening bracket of the list been found yet? Has enumeration ended?
+ */
+@property (nonatomic, getter=isListFound) BOOL listFound;
+@property (nonatomic, getter=isFinished) BOOL finished;
+
+// redefine readonly properties as readwrite
+@property (nonatomic, readwrite) NSUInteger objectsCount;
+@property (strong, nonatomic, readwrite) NSError *error;
+
+@end
+
+@implementation GRVJSONListReader
+
+#pragma mark - Class Methods
++ (instancetype)readerWithData:(NSData *)data listKey:(NSString *)listKey
+{
+    return [[self alloc] initWithData:data listKey:listKey];
+}
+
+
+#pragma mark - Initialization
+- (instancetype)initWithData:(NSData *)data listKey:(NSString *)listKey
+{
+    self = [super init];
+    if (self) {
+        _data = data;
+        _listKey = [listKey copy];
+    }
+    return self;
+}
+
+
+#pragma mark - Instance Methods
+#pragma mark Private
+/**
+ * End enumeration because of malformed JSON.
+ *
+ * @param description   Description of what was malformed.
+ */
+- (void)failWithDescription:(NSString *)description
+{
+    self.finished = YES;
+    self.error = [NSError errorWithDomain:NSCocoaErrorDomain
+                                     code:NSPropertyListReadCorruptError
+                                 userInfo:@{NSLocalizedDescriptionKey : @"The data couldn't be read because it isn't in the correct format.",
+                                            NSLocalizedFailureReasonErrorKey : [NSString stringWithFormat:@"%@ around byte %lu.", description, (unsigned long)self.position]}];
+}
+
+/**
+ * Scan up to the list's opening bracket.
+ *
+ * @return YES if the list was found, NO otherwise.
+ */
+- (BOOL)findList
+{
+    const uint8_t *bytes = [self.data bytes];
+    NSUInteger length = [self.data length];
+    NSUInteger position = GRVJSONSkipWhitespace(bytes, length, 0);
+
+    if (self.listKey) {
+        if ((position >= length) || (bytes[position] != '{')) {
+            [self failWithDescription:@"Expected a top-level object"];
+            return NO;
+        }
+        position++;
+
+        NSData *listKeyData = [self.listKey dataUsingEncoding:NSUTF8StringEncoding];
+        BOOL foundKey = NO;
+        while (!foundKey) {
+            position = GRVJSONSkipWhitespace(bytes, length, position);
+            if ((position < length) && (bytes[position] == ',')) {
+                position = GRVJSONSkipWhitespace(bytes, length, position + 1);
+            }
+            self.position = position;
+            if ((position >= length) || (bytes[position] == '}')) {
+                [self failWithDescription:[NSString stringWithFormat:@"No \"%@\" member", self.listKey]];
+                return NO;
+            }
+            if (bytes[position] != '"') {
+                [self failWithDescription:@"Expected a member name"];
+                return NO;
+            }
+
+            // compare the member name, without its quotes, with the list key
+            NSUInteger keyEnd = GRVJSONSkipString(bytes, length, position);
+            if (keyEnd == NSNotFound) {
+                [self failWithDescription:@"Unterminated string"];
+                return NO;
+            }
+            NSUInteger keyLength = keyEnd - position - 2;
+            foundKey = ((keyLength == [listKeyData length]) &&
+                        (memcmp(bytes + position + 1, [listKeyData bytes], keyLength) == 0));
+
+            position = GRVJSONSkipWhitespace(bytes, length, keyEnd);
+            if ((position >= length) || (bytes[position] != ':')) {
+                self.position = position;
+                [self failWithDescription:@"Expected a colon"];
+                return NO;
+            }
+            position = GRVJSONSkipWhitespace(bytes, length, position + 1);
+
+            if (!foundKey) {
+                position = GRVJSONSkipValue(bytes, length, position);
+                if (position == NSNotFound) {
+                    [self failWithDescription:@"Unterminated value"];
+                    return NO;
+                }
+            }
+        }
+    }
+
+    self.position = position;
+    if ((position >= length) || (bytes[position] != '[')) {
+        [self failWithDescription:@"Expected a list"];
+        return NO;
+    }
+    self.position = position + 1;
+    self.listFound = YES;
+    return YES;
+}
+
+#pragma mark Public
+- (id)nextObject
+{
+    if (self.isFinished) return nil;
+    if (!self.isListFound && ![self findList]) return nil;
+
+    const uint8_t *bytes = [self.data bytes];
+    NSUInteger length = [self.data length];
+    NSUInteger position = GRVJSONSkipWhitespace(bytes, length, self.position);
+
+    if ((position < length) && (bytes[position] == ']')) {
+        self.finished = YES;
+        return nil;
+    }
+    if (self.objectsCount > 0) {
+        if ((position >= length) || (bytes[position] != ',')) {
+            self.position = position;
+            [self failWithDescription:@"Expected a comma"];
+            return nil;
+        }
+        position = GRVJSONSkipWhitespace(bytes, length, position + 1);
+    }
+
+    NSUInteger end = GRVJSONSkipValue(bytes, length, position);
+    if ((end == NSNotFound) || (end == position)) {
+        self.position = position;
+        [self failWithDescription:@"Expected a list element"];
+        return nil;
+    }
+
+    // Parse just this element
+    NSError *error;
+    id object = [NSJSONSerialization JSONObjectWithData:[self.data subdataWithRange:NSMakeRange(position, end - position)]
+                                                options:NSJSONReadingAllowFragments
+                                                  error:&error];
+    if (!object) {
+        self.finished = YES;
+        self.error = error;
+        return nil;
+    }
+
+    self.position = end;
+    self.objectsCount++;
+    return object;
+}
+
+@end
@@ -9,6 +9,8 @@
 
 #import <UIKit/UIKit.h>
 
+@class GRVUserAvatarView;
+
 #pragma mark - Typedefs
 /**
  * Alert banner position
@@ -77,11 +79,9 @@ typedef enum : NSUInteger {
  *      String that appears in receiver's title bar
  * @param message
  *      Descriptive text that provides more details than the title
- * @param avatarThumbnail
- *      Thumbnail image to be used for an avatar view
- * @param userInitials
- *      If thumbnail image isn't available, then create an avatar based off the
- *      user initials
+ * @param avatarView
+ *      Avatar view, such as one from GRVUserViewHelper, whose thumbnail or
+ *      user initials the banner's avatar should show
  * @param tappedBlock
  *      Block to be called upon a tap of the banner. This block has no return
  *      value and takes an argument of the tapped banner.
@@ -92,8 +92,7 @@ typedef enum : NSUInteger {
 + (GRVAlertBannerView *)alertBannerForView:(UIView *)view
                                      title:(NSString *)title
                                    message:(NSString *)message
-                           avatarThumbnail:(UIImage *)avatarThumbnail
-                              withInitials:(NSString *)userInitials
+                                avatarView:(GRVUserAvatarView *)avatarView
                                tappedBlock:(void (^)(GRVAlertBannerView *alertBanner))tappedBlock
                  andCloseButtonTappedBlock:(void (^)(GRVAlertBannerView *alertBanner))closeButtonTappedBlock;
 
@@ -171,16 +171,14 @@ static CGFloat kBannerTextShadowRadius = 0.0f;
 + (GRVAlertBannerView *)alertBannerForView:(UIView *)view
                                      title:(NSString *)title
                                    message:(NSString *)message
-                           avatarThumbnail:(UIImage *)avatarThumbnail
-                              withInitials:(NSString *)userInitials
+                                avatarView:(GRVUserAvatarView *)avatarView
                                tappedBlock:(void (^)(GRVAlertBannerView *alertBanner))tappedBlock
                  andCloseButtonTappedBlock:(void (^)(GRVAlertBannerView *alertBanner))closeButtonTappedBlock
 {
     
     GRVAlertBannerView *alertBanner = [[GRVAlertBannerView alloc] init];
     
-    alertBanner.avatarThumbnailView.userInitials = userInitials;
-    alertBanner.avatarThumbnailView.thumbnail = avatarThumbnail;
+    [alertBanner.avatarThumbnailView setAvatarFromAvatarView:avatarView];
     alertBanner.titleLabel.text = title;
     alertBanner.messageLabel.text = message;
     alertBanner.position = GRVAlertBannerViewPositionTop;
@@ -13,6 +13,10 @@
  * If the user has a thumbnail image then that will be used, else the provided
  * user initials will be presented on a circular background.
  *
+ * The avatar bitmap is rendered in the background by GRVAvatarImageCache and
+ * this view simply displays it once ready. Providing an avatarIdentifier lets
+ * the rendered bitmap be shared across views and reused across cell reloads.
+ *
  * @warning This view's bounds really should be a square rectangle otherwise
  *  things get very odd.
  */
@@ -31,4 +35,39 @@
  */
 @property (copy, nonatomic) NSString *userInitials;
 
+/**
+ * Identity and version of this avatar's source image, such as a user's phone
+ * number paired with their thumbnail URL. Two avatars with the same identifier
+ * must look the same. If this isn't set the avatar is rendered but not cached.
+ */
+@property (copy, nonatomic) NSString *avatarIdentifier;
+
+/**
+ * Address book record ID and modification date of a contact whose thumbnail is
+ * still being loaded by GRVContactThumbnailLoader. While these are set the view
+ * switches to the contact's thumbnail as soon as it's loaded.
+ */
+@property (strong, nonatomic, readonly) NSNumber *pendingContactRecordId;
+@property (strong, nonatomic, readonly) NSDate *pendingContactUpdatedAt;
+
+#pragma mark - Instance Methods
+/**
+ * Show a contact's thumbnail once GRVContactThumbnailLoader has loaded it.
+ * Pass a nil recordId to stop waiting on a thumbnail.
+ *
+ * @param recordId      Record identifier of the contact in the address book
+ * @param updatedAt     Modification date of the contact
+ */
+- (void)showContactThumbnailWhenLoadedForRecordId:(NSNumber *)recordId
+                                        updatedAt:(NSDate *)updatedAt;
+
+/**
+ * Configure this view to show the same avatar as another avatar view, such as
+ * one generated by GRVUserViewHelper, including any contact thumbnail it's
+ * still waiting on.
+ *
+ * @param avatarView    Avatar view to copy
+ */
+- (void)setAvatarFromAvatarView:(GRVUserAvatarView *)avatarView;
+
 @end
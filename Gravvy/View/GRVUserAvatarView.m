@@ -7,35 +7,60 @@
 //
 
 #import "GRVUserAvatarView.h"
+#import "GRVAvatarImageCache.h"
+#import "GRVContactThumbnailLoader.h"
 #import "GRVConstants.h"
 
-#pragma mark - Constants
-// max # of characters in initials.
-static NSUInteger const kMaxUserInitialsLength  = 3;
+@interface GRVUserAvatarView ()
+
+#pragma mark - Properties
+/**
+ * Has the avatar's source changed since the displayed bitmap was requested?
+ */
+@property (nonatomic) BOOL needsAvatarUpdate;
+
+/**
+ * Diameter and scale the displayed bitmap was requested at. A change in either
+ * calls for a new bitmap.
+ */
+@property (nonatomic) CGFloat renderedDiameter;
+@property (nonatomic) CGFloat renderedScale;
 
 /**
- * Avatar view user initials text font size and corresponding diameter, as this
- * font must scale with size
+ * Incremented with each bitmap request so that a late background render for
+ * a reused view doesn't overwrite a newer avatar.
  */
-static CGFloat const kUserAvatarFontSize = 12.0f;
-static CGFloat const kUserAvatarMaxFontSize = 13.0f;
-static CGFloat const kUserAvatarFontScale = 1.0f/28.0;
+@property (nonatomic) NSUInteger avatarRequestGeneration;
 
+// want to make these readwrite privately
+@property (strong, nonatomic, readwrite) NSNumber *pendingContactRecordId;
+@property (strong, nonatomic, readwrite) NSDate *pendingContactUpdatedAt;
+
+@end
 
 @implementation GRVUserAvatarView
 
 #pragma mark - Properties
-// Whenever a property is set, the view needs to be redrawn;
+// Whenever a property is set, the avatar needs to be updated;
 - (void)setThumbnail:(UIImage *)thumbnail
 {
+    if (thumbnail == _thumbnail) return;
     _thumbnail = thumbnail;
-    [self setNeedsDisplay];
+    [self setNeedsAvatarUpdate];
 }
 
 - (void)setUserInitials:(NSString *)userInitials
 {
+    if ((userInitials == _userInitials) || [userInitials isEqualToString:_userInitials]) return;
     _userInitials = [userInitials copy];
-    [self setNeedsDisplay];
+    [self setNeedsAvatarUpdate];
+}
+
+- (void)setAvatarIdentifier:(NSString *)avatarIdentifier
+{
+    if ((avatarIdentifier == _avatarIdentifier) || [avatarIdentifier isEqualToString:_avatarIdentifier]) return;
+    _avatarIdentifier = [avatarIdentifier copy];
+    [self setNeedsAvatarUpdate];
 }
 
 
@@ -45,8 +70,9 @@ static CGFloat const kUserAvatarFontScale = 1.0f/28.0;
     // make transparent (no background color)
     self.backgroundColor = nil;
     self.opaque = NO;
-    // want to redraw whenever bound change
-    self.contentMode = UIViewContentModeRedraw;
+    // bitmaps are rendered at the exact size so never stretch them
+    self.contentMode = UIViewContentModeScaleToFill;
+    self.needsAvatarUpdate = YES;
 }
 
 - (void)awakeFromNib
@@ -64,172 +90,144 @@ static CGFloat const kUserAvatarFontScale = 1.0f/28.0;
     return self;
 }
 
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
 
-#pragma mark - Drawing
-// Only override drawRect: if you perform custom drawing.
-// An empty implementation adversely affects performance during animation.
-- (void)drawRect:(CGRect)rect
+#pragma mark - Layout
+- (void)layoutSubviews
 {
-    // Drawing code
-    
-    // Define the avatar's boundary
-    UIBezierPath *circleBorder = [UIBezierPath bezierPathWithOvalInRect:self.bounds];
-    
-    // Restrict all avatar drawing to this circle
-    [circleBorder addClip];
-    
-    // Set Avatar background color
-    [kGRVUserAvatarBackgroundColor setFill];
-    
-    UIImage *avatarImage = nil;
-    if (self.thumbnail) {
-        // Convert thumbnail to a circular image
-        avatarImage = [self circularImage:self.thumbnail withDiameter:self.bounds.size.width];
-        
-    } else if ([self.userInitials length]) {
-        NSString *initials = self.userInitials;
-        if ([initials length] > kMaxUserInitialsLength) {
-            initials = @"...";
-        }
-        CGFloat diameter = self.bounds.size.width;
-        CGFloat fontSize = kUserAvatarFontSize * diameter *kUserAvatarFontScale;
-        fontSize = MIN(fontSize, kUserAvatarMaxFontSize);
-        UIFont *font = [UIFont boldSystemFontOfSize:fontSize];
-        avatarImage = [self imageWithInitials:initials
-                              backgroundColor:kGRVUserAvatarBackgroundColor
-                                    textColor:kGRVUserAvatarTextColor
-                                         font:font
-                                     diameter:diameter];
-    } else {
-        // No thumbnailor initials?, use a default avatar image
-        avatarImage = [self circularImage:[UIImage imageNamed:@"defaultAvatar"]
-                             withDiameter:self.bounds.size.width];
+    [super layoutSubviews];
+
+    CGFloat diameter = self.bounds.size.width;
+    CGFloat scale = self.window ? self.window.screen.scale : [UIScreen mainScreen].scale;
+    if (self.needsAvatarUpdate || (diameter != self.renderedDiameter) || (scale != self.renderedScale)) {
+        [self updateAvatarImageWithDiameter:diameter scale:scale];
     }
-    [avatarImage drawInRect:self.bounds];
 }
 
 
 #pragma mark - Instance Methods
-#pragma mark Private
-/**
- * Generate a circular image from provided initials
- *
- * Derived from JSQMessagesViewController's
- * jsq_imageWitInitials:backgroundColor:textColor:font:diameter:
- *
- * @param initials          intials to be used to generate an avatar image
- * @param backgroundColor   background color of avatar image.
- * @param textColor         color of initials in avatar image
- * @param font              font of initials in avatar image
- * @param diameter          diameter of avatar image circle.
- *
- * @return a composed UIImage.
- */
-- (UIImage *)imageWithInitials:(NSString *)initials
-               backgroundColor:(UIColor *)backgroundColor
-                     textColor:(UIColor *)textColor
-                          font:(UIFont *)font
-                      diameter:(NSUInteger)diameter
+#pragma mark Public
+- (void)showContactThumbnailWhenLoadedForRecordId:(NSNumber *)recordId
+                                        updatedAt:(NSDate *)updatedAt
 {
-    NSParameterAssert(initials != nil);
-    NSParameterAssert(backgroundColor != nil);
-    NSParameterAssert(textColor != nil);
-    NSParameterAssert(font != nil);
-    NSParameterAssert(diameter > 0);
-    
-    CGRect frame = CGRectMake(0.0f, 0.0f, diameter, diameter);
-    
-    NSString *text = [initials uppercaseStringWithLocale:[NSLocale currentLocale]];
-    
-    NSDictionary *attributes = @{ NSFontAttributeName : font,
-                                  NSForegroundColorAttributeName : textColor };
-    
-    CGRect textFrame = [text boundingRectWithSize:frame.size
-                                          options:(NSStringDrawingUsesLineFragmentOrigin | NSStringDrawingUsesFontLeading)
-                                       attributes:attributes
-                                          context:nil];
-    
-    CGPoint frameMidPoint = CGPointMake(CGRectGetMidX(frame), CGRectGetMidY(frame));
-    CGPoint textFrameMidPoint = CGPointMake(CGRectGetMidX(textFrame), CGRectGetMidY(textFrame));
+    NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+    if (self.pendingContactRecordId) {
+        [notificationCenter removeObserver:self
+                                      name:kGRVContactThumbnailLoadedNotification
+                                    object:nil];
+    }
     
-    CGFloat dx = frameMidPoint.x - textFrameMidPoint.x;
-    CGFloat dy = frameMidPoint.y - textFrameMidPoint.y;
-    CGPoint drawPoint = CGPointMake(dx, dy);
-    UIImage *image = nil;
+    self.pendingContactRecordId = recordId;
+    self.pendingContactUpdatedAt = recordId ? updatedAt : nil;
     
-    UIGraphicsBeginImageContextWithOptions(frame.size, NO, [UIScreen mainScreen].scale);
-    {
-        [self pushContext];
-        
-        [backgroundColor setFill];
-        UIRectFill(frame);
-        [text drawAtPoint:drawPoint withAttributes:attributes];
-        
-        image = UIGraphicsGetImageFromCurrentImageContext();
-        
-        [self pushContext];
+    if (recordId) {
+        [notificationCenter addObserver:self
+                               selector:@selector(contactThumbnailLoaded:)
+                                   name:kGRVContactThumbnailLoadedNotification
+                                 object:nil];
     }
-    UIGraphicsEndImageContext();
-    
-    return [self circularImage:image withDiameter:diameter];
 }
 
+- (void)setAvatarFromAvatarView:(GRVUserAvatarView *)avatarView
+{
+    self.thumbnail = avatarView.thumbnail;
+    self.userInitials = avatarView.userInitials;
+    self.avatarIdentifier = avatarView.avatarIdentifier;
+    [self showContactThumbnailWhenLoadedForRecordId:avatarView.pendingContactRecordId
+                                          updatedAt:avatarView.pendingContactUpdatedAt];
+}
 
+#pragma mark Private
 /**
- * Generate a circular image from provided rectangular image
- *
- * Derived from JSQMessagesViewController's
- * jsq_circularImage:withDiamter:highlightedColor:
- *
- * @param image             Image to be cropped to a circular view.
- * @param diameter          diameter of avatar image circle. Must be > 0.
- *
- * @return a composed UIImage.
+ * Mark the displayed avatar as stale. It gets updated on the next layout pass,
+ * when the view's final size is known.
  */
-- (UIImage *)circularImage:(UIImage *)image
-              withDiameter:(NSUInteger)diameter
+- (void)setNeedsAvatarUpdate
 {
-    NSParameterAssert(image != nil);
-    NSParameterAssert(diameter > 0);
-    
-    CGRect frame = CGRectMake(0.0f, 0.0f, diameter, diameter);
-    UIImage *newImage = nil;
-    
-    UIGraphicsBeginImageContextWithOptions(frame.size, NO, [UIScreen mainScreen].scale);
-    {
-        [self pushContext];
-        
-        UIBezierPath *imgPath = [UIBezierPath bezierPathWithOvalInRect:frame];
-        [imgPath addClip];
-        [image drawInRect:frame];
-        
-        newImage = UIGraphicsGetImageFromCurrentImageContext();
-        
-        [self popContext];
-    }
-    UIGraphicsEndImageContext();
-    
-    return newImage;
+    self.needsAvatarUpdate = YES;
+    [self setNeedsLayout];
 }
 
-
 /**
- * Push current CGContext. This is used in conjunction with `popContext`
+ * Display the avatar bitmap for the current thumbnail/initials. A cached bitmap
+ * is shown right away, otherwise one is rendered in the background and shown
+ * when ready.
+ *
+ * @param diameter  Diameter, in points, of the avatar circle
+ * @param scale     Scale factor of the bitmap
  */
-- (void)pushContext
+- (void)updateAvatarImageWithDiameter:(CGFloat)diameter scale:(CGFloat)scale
 {
-    CGContextRef context = UIGraphicsGetCurrentContext();
-    CGContextSaveGState(context);
+    self.needsAvatarUpdate = NO;
+    self.renderedDiameter = diameter;
+    self.renderedScale = scale;
+    NSUInteger generation = ++self.avatarRequestGeneration;
+
+    if (diameter <= 0) {
+        self.layer.contents = nil;
+        return;
+    }
+
+    GRVAvatarImageCache *avatarCache = [GRVAvatarImageCache sharedCache];
+    NSString *cacheKey = [GRVAvatarImageCache cacheKeyForAvatarIdentifier:self.avatarIdentifier
+                                                                 diameter:diameter
+                                                                    scale:scale];
+    UIImage *avatarImage = [avatarCache avatarImageForKey:cacheKey];
+    if (avatarImage) {
+        [self displayAvatarImage:avatarImage];
+        return;
+    }
+
+    // Clear out whatever a reused view was showing till the render is done
+    self.layer.contents = nil;
+
+    GRVUserAvatarView* __weak weakSelf = self;
+    [avatarCache renderAvatarWithThumbnail:self.thumbnail
+                                  initials:self.userInitials
+                                  diameter:diameter
+                                     scale:scale
+                                  cacheKey:cacheKey
+                                completion:^(UIImage *renderedImage) {
+                                    if (weakSelf.avatarRequestGeneration == generation) {
+                                        [weakSelf displayAvatarImage:renderedImage];
+                                    }
+                                }];
 }
 
 /**
- * Pop most recent CGContext. This is unded in conjunction with `pushContext`
+ * Show a rendered avatar bitmap by handing it straight to the backing layer.
  */
-- (void)popContext
+- (void)displayAvatarImage:(UIImage *)avatarImage
 {
-    CGContextRestoreGState(UIGraphicsGetCurrentContext());
+    self.layer.contentsScale = avatarImage.scale;
+    self.layer.contents = (id)avatarImage.CGImage;
 }
 
 
+#pragma mark - Notification Observer Methods
+/**
+ * An address book contact's thumbnail has been loaded so switch to it if it's
+ * the one this view is waiting on.
+ */
+- (void)contactThumbnailLoaded:(NSNotification *)aNotification
+{
+    NSNumber *recordId = aNotification.userInfo[kGRVContactThumbnailRecordIdKey];
+    if (![self.pendingContactRecordId isEqual:recordId]) return;
+    
+    // The loaded thumbnail could be for a different version of the contact
+    NSDate *updatedAt = self.pendingContactUpdatedAt;
+    UIImage *thumbnail = [[GRVContactThumbnailLoader sharedLoader] cachedThumbnailForRecordId:recordId
+                                                                                    updatedAt:updatedAt];
+    if (!thumbnail) return;
+    
+    [self showContactThumbnailWhenLoadedForRecordId:nil updatedAt:nil];
+    self.thumbnail = thumbnail;
+    self.avatarIdentifier = [GRVContactThumbnailLoader avatarIdentifierForRecordId:recordId
+                                                                         updatedAt:updatedAt];
+}
 
 @end
@@ -25,4 +25,16 @@
 @property (weak, nonatomic) IBOutlet UILabel *currentClipIndexLabel;
 @property (weak, nonatomic) IBOutlet UIButton *likeButton;
 
+/**
+ * URL of the preview image this cell is expecting. Preview images are loaded
+ * asynchronously so this is used to ignore images loaded for a prior use of a
+ * reused cell.
+ */
+@property (copy, nonatomic) NSString *previewImageURL;
+
+/**
+ * Spinner shown over the preview image view while the image loads.
+ */
+@property (strong, nonatomic, readonly) UIActivityIndicatorView *previewImageSpinner;
+
 @end
@@ -10,4 +10,24 @@
 
 @implementation GRVVideoTableViewCell
 
+#pragma mark - Properties
+@synthesize previewImageSpinner = _previewImageSpinner;
+
+// Lazy instantiation
+- (UIActivityIndicatorView *)previewImageSpinner
+{
+    if (!_previewImageSpinner) {
+        _previewImageSpinner = [[UIActivityIndicatorView alloc] initWithActivityIndicatorStyle:UIActivityIndicatorViewStyleWhiteLarge];
+        _previewImageSpinner.hidesWhenStopped = YES;
+        _previewImageSpinner.center = CGPointMake(CGRectGetMidX(self.previewImageView.bounds),
+                                                  CGRectGetMidY(self.previewImageView.bounds));
+        _previewImageSpinner.autoresizingMask = (UIViewAutoresizingFlexibleLeftMargin |
+                                                 UIViewAutoresizingFlexibleRightMargin |
+                                                 UIViewAutoresizingFlexibleTopMargin |
+                                                 UIViewAutoresizingFlexibleBottomMargin);
+        [self.previewImageView addSubview:_previewImageSpinner];
+    }
+    return _previewImageSpinner;
+}
+
 @end
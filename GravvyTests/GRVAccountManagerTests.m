@@ -0,0 +1,201 @@
+//
+//  GRVAccountManagerTests.m
+//  GravvyTests
+//
+//  Created by Nnoduka Eruchalu on 8/26/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+#import <XCTest/XCTest.h>
+#import <objc/runtime.h>
+#import "GRVAccountManager.h"
+#import "GRVHTTPManager.h"
+#import "GRVConstants.h"
+
+#pragma mark - Constants
+/**
+ * Number of concurrent requests rejected as unauthorized.
+ */
+static const size_t kGRVUnauthorizedRequestsCount = 1000;
+
+/**
+ * Time the stubbed authentication request takes.
+ */
+static const NSTimeInterval kGRVAuthenticationDuration = 0.2;
+
+
+/**
+ * Private methods under test.
+ */
+@interface GRVHTTPManager (Testing)
++ (void)reauthenticateIfUnauthorizedTask:(NSURLSessionDataTask *)task withAuthorizationHeaders:(NSDictionary *)authorizationHeaders;
+@end
+
+/**
+ * Data task that completed with a given HTTP status code, without going to
+ * the network.
+ */
+@interface GRVStubDataTask : NSURLSessionDataTask
+@property (nonatomic) NSInteger statusCode;
+@end
+
+@implementation GRVStubDataTask
+
+- (NSURLResponse *)response
+{
+    return [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:kGRVHTTPBaseURL]
+                                       statusCode:self.statusCode
+                                      HTTPVersion:@"HTTP/1.1"
+                                     headerFields:nil];
+}
+
+@end
+
+
+@interface GRVAccountManagerTests : XCTestCase
+
+/**
+ * Original implementations of the stubbed GRVAccountManager methods.
+ */
+@property (nonatomic) IMP phoneNumberIMP;
+@property (nonatomic) IMP passwordIMP;
+@property (nonatomic) IMP authenticateIMP;
+
+/**
+ * Account manager state before the test.
+ */
+@property (nonatomic) BOOL wasAuthenticated;
+@property (copy, nonatomic) NSDictionary *originalAuthorizationHeaders;
+
+/**
+ * Number of authentication requests made, and the block executed when the
+ * stubbed authentication request completes. Only accessed on the main queue.
+ */
+@property (nonatomic) NSUInteger authenticationRequestsCount;
+@property (copy, nonatomic) void (^authenticationCompletion)();
+
+@end
+
+@implementation GRVAccountManagerTests
+
+#pragma mark - Setup
+- (void)setUp
+{
+    [super setUp];
+
+    GRVAccountManager *accountManager = [GRVAccountManager sharedManager];
+    self.wasAuthenticated = accountManager.isAuthenticated;
+    self.originalAuthorizationHeaders = accountManager.authorizationHeaders;
+
+    // Stub the saved credentials and the authentication request so the user's
+    // keychain and the network aren't used. Authentication replaces the
+    // credentials after a short while, like the real request.
+    Class accountManagerClass = [GRVAccountManager class];
+    self.phoneNumberIMP = method_setImplementation(class_getInstanceMethod(accountManagerClass, @selector(phoneNumber)), imp_implementationWithBlock(^NSString *(GRVAccountManager *manager) {
+        return @"+14155550100";
+    }));
+    self.passwordIMP = method_setImplementation(class_getInstanceMethod(accountManagerClass, @selector(password)), imp_implementationWithBlock(^NSString *(GRVAccountManager *manager) {
+        return @"password";
+    }));
+
+    GRVAccountManagerTests* __weak weakSelf = self;
+    SEL authenticateSelector = NSSelectorFromString(@"authenticatePhoneNumber:password:success:failure:");
+    self.authenticateIMP = method_setImplementation(class_getInstanceMethod(accountManagerClass, authenticateSelector), imp_implementationWithBlock(^(GRVAccountManager *manager, NSString *phoneNumber, NSString *password, void (^success)(), void (^failure)(NSUInteger statusCode)) {
+        weakSelf.authenticationRequestsCount++;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kGRVAuthenticationDuration * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            [manager setValue:@{@"Authorization" : @"Token fresh"} forKey:@"authorizationHeaders"];
+            if (success) success();
+            if (weakSelf.authenticationCompletion) weakSelf.authenticationCompletion();
+        });
+    }));
+
+    // Start out authenticated with a token the server will reject
+    [accountManager setValue:@YES forKey:@"authenticated"];
+    [accountManager setValue:@{@"Authorization" : @"Token stale"} forKey:@"authorizationHeaders"];
+}
+
+- (void)tearDown
+{
+    Class accountManagerClass = [GRVAccountManager class];
+    method_setImplementation(class_getInstanceMethod(accountManagerClass, @selector(phoneNumber)), self.phoneNumberIMP);
+    method_setImplementation(class_getInstanceMethod(accountManagerClass, @selector(password)), self.passwordIMP);
+    method_setImplementation(class_getInstanceMethod(accountManagerClass, NSSelectorFromString(@"authenticatePhoneNumber:password:success:failure:")), self.authenticateIMP);
+
+    GRVAccountManager *accountManager = [GRVAccountManager sharedManager];
+    [accountManager setValue:@(self.wasAuthenticated) forKey:@"authenticated"];
+    [accountManager setValue:self.originalAuthorizationHeaders forKey:@"authorizationHeaders"];
+
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+/**
+ * Fail a task with a status code for each of many requests made with the same
+ * authorization headers, concurrently on background threads as the HTTP
+ * session completes requests.
+ */
+- (void)failConcurrentRequestsWithStatusCode:(NSInteger)statusCode authorizationHeaders:(NSDictionary *)authorizationHeaders
+{
+    dispatch_apply(kGRVUnauthorizedRequestsCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        GRVStubDataTask *task = [[GRVStubDataTask alloc] init];
+        task.statusCode = statusCode;
+        [GRVHTTPManager reauthenticateIfUnauthorizedTask:task withAuthorizationHeaders:authorizationHeaders];
+    });
+}
+
+/**
+ * Wait for everything already queued on the main queue to run.
+ */
+- (void)waitForMainQueue
+{
+    XCTestExpectation *drainedExpectation = [self expectationWithDescription:@"main queue drained"];
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [drainedExpectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+
+#pragma mark - Tests
+- (void)testConcurrentUnauthorizedRequestsReauthenticateOnce
+{
+    NSDictionary *staleHeaders = [GRVAccountManager sharedManager].authorizationHeaders;
+
+    XCTestExpectation *authenticatedExpectation = [self expectationWithDescription:@"re-authenticated"];
+    self.authenticationCompletion = ^{
+        [authenticatedExpectation fulfill];
+    };
+    [self failConcurrentRequestsWithStatusCode:GRVHTTPStatusCode401Unauthorized authorizationHeaders:staleHeaders];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    self.authenticationCompletion = nil;
+
+    XCTAssertEqual(self.authenticationRequestsCount, (NSUInteger)1);
+    XCTAssertEqualObjects([GRVAccountManager sharedManager].authorizationHeaders, (@{@"Authorization" : @"Token fresh"}));
+
+    // Requests made with the stale token that are rejected after
+    // re-authenticating don't start another authentication
+    [self failConcurrentRequestsWithStatusCode:GRVHTTPStatusCode401Unauthorized authorizationHeaders:staleHeaders];
+    [self waitForMainQueue];
+    XCTAssertEqual(self.authenticationRequestsCount, (NSUInteger)1);
+}
+
+- (void)testOtherFailuresDontReauthenticate
+{
+    NSDictionary *headers = [GRVAccountManager sharedManager].authorizationHeaders;
+    [self failConcurrentRequestsWithStatusCode:GRVHTTPStatusCode404NotFound authorizationHeaders:headers];
+    [self waitForMainQueue];
+
+    XCTAssertEqual(self.authenticationRequestsCount, (NSUInteger)0);
+    XCTAssertEqualObjects([GRVAccountManager sharedManager].authorizationHeaders, headers);
+}
+
+- (void)testUnauthorizedRequestsWithoutCredentialsDontReauthenticate
+{
+    [self failConcurrentRequestsWithStatusCode:GRVHTTPStatusCode401Unauthorized authorizationHeaders:@{}];
+    [self waitForMainQueue];
+
+    XCTAssertEqual(self.authenticationRequestsCount, (NSUInteger)0);
+}
+
+@end
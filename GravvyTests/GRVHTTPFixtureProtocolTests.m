@@ -0,0 +1,76 @@
+//
+//  GRVHTTPFixtureProtocolTests.m
+//  GravvyTests
+//
+//  Created by Nnoduka Eruchalu on 8/27/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+#import <XCTest/XCTest.h>
+#import "GRVHTTPFixtureProtocol.h"
+
+/**
+ * Private methods under test.
+ */
+@interface GRVHTTPFixtureProtocol (Testing)
++ (NSString *)fixtureNameForRequest:(NSURLRequest *)request;
++ (NSURLRequest *)fixtureRequestForRequest:(NSURLRequest *)request;
+@end
+
+@interface GRVHTTPFixtureProtocolTests : XCTestCase
+
+@end
+
+@implementation GRVHTTPFixtureProtocolTests
+
+#pragma mark - Helpers
+/**
+ * POST request with a JSON body, in HTTPBody or, as NSURLSession hands it to
+ * URL protocols, in HTTPBodyStream.
+ */
+- (NSURLRequest *)postRequestWithJSONObject:(id)JSONObject streamed:(BOOL)streamed
+{
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"https://example.com/api/v1/videos/"]];
+    request.HTTPMethod = @"POST";
+    [request setValue:@"application/json" forHTTPHeaderField:@"Content-Type"];
+    NSData *body = [NSJSONSerialization dataWithJSONObject:JSONObject options:0 error:NULL];
+    if (streamed) {
+        request.HTTPBodyStream = [NSInputStream inputStreamWithData:body];
+    } else {
+        request.HTTPBody = body;
+    }
+    return request;
+}
+
+
+#pragma mark - Tests
+- (void)testPostsWithDifferentBodiesHaveDifferentFixtureNames
+{
+    NSString *fixtureName1 = [GRVHTTPFixtureProtocol fixtureNameForRequest:[self postRequestWithJSONObject:@{@"title" : @"Beach"} streamed:NO]];
+    NSString *fixtureName2 = [GRVHTTPFixtureProtocol fixtureNameForRequest:[self postRequestWithJSONObject:@{@"title" : @"Party"} streamed:NO]];
+    XCTAssertNotEqualObjects(fixtureName1, fixtureName2);
+}
+
+- (void)testPostsWithDifferentStreamedBodiesHaveDifferentFixtureNames
+{
+    NSString *fixtureName1 = [GRVHTTPFixtureProtocol fixtureNameForRequest:[self postRequestWithJSONObject:@{@"title" : @"Beach"} streamed:YES]];
+    NSString *fixtureName2 = [GRVHTTPFixtureProtocol fixtureNameForRequest:[self postRequestWithJSONObject:@{@"title" : @"Party"} streamed:YES]];
+    XCTAssertNotEqualObjects(fixtureName1, fixtureName2);
+}
+
+- (void)testStreamedAndInlineBodiesHaveSameFixtureName
+{
+    NSString *inlineFixtureName = [GRVHTTPFixtureProtocol fixtureNameForRequest:[self postRequestWithJSONObject:@{@"title" : @"Beach"} streamed:NO]];
+    NSString *streamedFixtureName = [GRVHTTPFixtureProtocol fixtureNameForRequest:[self postRequestWithJSONObject:@{@"title" : @"Beach"} streamed:YES]];
+    XCTAssertEqualObjects(inlineFixtureName, streamedFixtureName);
+}
+
+- (void)testFixtureRequestCanBeNamedRepeatedly
+{
+    NSURLRequest *fixtureRequest = [GRVHTTPFixtureProtocol fixtureRequestForRequest:[self postRequestWithJSONObject:@{@"title" : @"Beach"} streamed:YES]];
+    NSString *fixtureName = [GRVHTTPFixtureProtocol fixtureNameForRequest:fixtureRequest];
+    XCTAssertEqualObjects(fixtureName, [GRVHTTPFixtureProtocol fixtureNameForRequest:fixtureRequest]);
+}
+
+@end
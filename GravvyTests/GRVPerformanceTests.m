@@ -0,0 +1,342 @@
+//
+//  GRVPerformanceTests.m
+//  GravvyTests
+//
+//  Created by Nnoduka Eruchalu on 8/28/15.
+//  Copyright (c) 2015 Nnoduka Eruchalu. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+#import <XCTest/XCTest.h>
+#import <CoreData/CoreData.h>
+#import "GRVCoreDataImport.h"
+#import "GRVUser+HTTP.h"
+#import "GRVContact+AddressBook.h"
+#import "GRVContactNameIndex.h"
+#import "GRVVideo+HTTP.h"
+#import "GRVAvatarImageCache.h"
+#import "GRVConstants.h"
+
+#pragma mark - Constants
+/**
+ * Seed of the synthetic data, so every run measures the same data.
+ */
+static const long kGRVPerformanceTestsRandomSeed = 20150828;
+
+/**
+ * Synthetic names. Contacts get a first and last name from these, suffixed
+ * with their index so names are spread like a real address book.
+ */
+static NSString *const kGRVPerformanceTestsFirstNames[] = {
+    @"Ada", @"Ben", @"Chioma", @"David", @"Emeka", @"Fatima", @"Grace", @"Henry",
+    @"Ifeoma", @"John", @"Kate", @"Liam", @"Maria", @"Ngozi", @"Olu", @"Paul"
+};
+static NSString *const kGRVPerformanceTestsLastNames[] = {
+    @"Adams", @"Brown", @"Chukwu", @"Davis", @"Eze", @"Garcia", @"Johnson", @"Kim",
+    @"Lee", @"Martin", @"Nwosu", @"Okafor", @"Smith", @"Taylor", @"Wilson", @"Young"
+};
+static const NSUInteger kGRVPerformanceTestsNamesCount = 16;
+
+
+/**
+ * Private initializer of an index over a context other than the user's.
+ */
+@interface GRVContactNameIndex (Testing)
+- (instancetype)initWithManagedObjectContext:(NSManagedObjectContext *)managedObjectContext;
+@end
+
+
+/**
+ * GRVPerformanceTests times the app's hot paths against seeded synthetic data:
+ * Core Data imports and deletes, contact sync, contact search, avatar
+ * rendering and video reordering.
+ *
+ * Each iteration gets a fresh SQLite store in the temporary directory, so the
+ * user's store is never touched, and only the measured work is timed, not its
+ * setup. Baselines are in the project's shared data, so runs that are more
+ * than 25% slower than the baseline fail.
+ */
+@interface GRVPerformanceTests : XCTestCase
+
+@end
+
+@implementation GRVPerformanceTests
+
+#pragma mark - Helpers
+/**
+ * Create a context on a fresh, empty SQLite store set up like the user's store.
+ */
+- (NSManagedObjectContext *)newScratchContext
+{
+    NSURL *storeDirectoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"GRVPerformanceTests"] isDirectory:YES];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    [fileManager removeItemAtURL:storeDirectoryURL error:NULL];
+    [fileManager createDirectoryAtURL:storeDirectoryURL withIntermediateDirectories:YES attributes:nil error:NULL];
+
+    // Tests are hosted by the app, so its model is in the main bundle
+    NSURL *modelURL = [[NSBundle mainBundle] URLForResource:@"Gravvy" withExtension:@"momd"];
+    NSManagedObjectModel *model = [[NSManagedObjectModel alloc] initWithContentsOfURL:modelURL];
+    NSPersistentStoreCoordinator *coordinator = [[NSPersistentStoreCoordinator alloc] initWithManagedObjectModel:model];
+
+    NSDictionary *options = @{NSSQLitePragmasOption : @{@"journal_mode" : @"WAL"}};
+    NSError *error;
+    NSPersistentStore *store = [coordinator addPersistentStoreWithType:NSSQLiteStoreType
+                                                         configuration:nil
+                                                                   URL:[storeDirectoryURL URLByAppendingPathComponent:@"PerformanceTests.sqlite"]
+                                                               options:options
+                                                                 error:&error];
+    XCTAssertNotNil(store, @"%@", [error localizedDescription]);
+
+    NSManagedObjectContext *context = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
+    context.persistentStoreCoordinator = coordinator;
+    context.undoManager = nil;
+    return context;
+}
+
+/**
+ * Measure a block of Core Data work, each iteration on a fresh store.
+ *
+ * @param setup     Untimed block that seeds the store, which is then saved.
+ *      This is optional.
+ * @param measure   Timed block of work.
+ */
+- (void)measureWithSetup:(void (^)(NSManagedObjectContext *context))setup
+                 measure:(void (^)(NSManagedObjectContext *context))measure
+{
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        NSManagedObjectContext *context = [self newScratchContext];
+        if (setup) {
+            [context performBlockAndWait:^{
+                setup(context);
+                [context save:NULL];
+            }];
+        }
+
+        [self startMeasuring];
+        [context performBlockAndWait:^{
+            measure(context);
+        }];
+        [self stopMeasuring];
+
+        [context performBlockAndWait:^{
+            [context reset];
+        }];
+    }];
+}
+
+#pragma mark Synthetic Data
+/**
+ * E.164 phone number of the synthetic user at an index.
+ */
++ (NSString *)phoneNumberAtIndex:(NSUInteger)index
+{
+    return [NSString stringWithFormat:@"+1415%03lu%04lu",
+            (unsigned long)(200 + (index / 10000) % 800), (unsigned long)(index % 10000)];
+}
+
+/**
+ * User JSON objects, as the server sends them.
+ */
++ (NSArray *)userDictsWithCount:(NSUInteger)count
+{
+    srand48(kGRVPerformanceTestsRandomSeed);
+    NSMutableArray *userDicts = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        NSString *fullName = [NSString stringWithFormat:@"%@ %@",
+                              kGRVPerformanceTestsFirstNames[lrand48() % kGRVPerformanceTestsNamesCount],
+                              kGRVPerformanceTestsLastNames[lrand48() % kGRVPerformanceTestsNamesCount]];
+        [userDicts addObject:@{kGRVRESTUserPhoneNumberKey : [GRVPerformanceTests phoneNumberAtIndex:i],
+                               kGRVRESTUserFullNameKey : fullName,
+                               kGRVRESTUserAvatarThumbnailKey : [NSString stringWithFormat:@"https://example.com/avatars/%lu.jpg", (unsigned long)i],
+                               kGRVRESTUserUpdatedAtKey : @"2015-08-28T12:00:00.000000Z"}];
+    }
+    return userDicts;
+}
+
+/**
+ * Address book contacts as contact info dictionaries, which is what the
+ * contacts sync reads ABPerson records into. ABPerson records can't be created
+ * with record IDs without saving them to the user's address book, so contact
+ * sync is measured from these.
+ */
++ (NSArray *)contactDictsWithCount:(NSUInteger)count
+{
+    srand48(kGRVPerformanceTestsRandomSeed);
+    NSDate *updatedAt = [NSDate dateWithTimeIntervalSince1970:1440763200.0];
+    NSMutableArray *contactDicts = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        NSString *firstName = [NSString stringWithFormat:@"%@%lu", kGRVPerformanceTestsFirstNames[lrand48() % kGRVPerformanceTestsNamesCount], (unsigned long)(i % 97)];
+        NSString *lastName = kGRVPerformanceTestsLastNames[lrand48() % kGRVPerformanceTestsNamesCount];
+        [contactDicts addObject:@{kGRVContactRecordIdKey : @(i + 1),
+                                  kGRVContactFirstNameKey : firstName,
+                                  kGRVContactLastNameKey : lastName,
+                                  kGRVContactUpdatedAtKey : updatedAt,
+                                  kGRVContactPhoneNumbersKey : @[[GRVPerformanceTests phoneNumberAtIndex:i]]}];
+    }
+    return contactDicts;
+}
+
+/**
+ * Import users in batches, as the favorites refresh does.
+ */
++ (void)importUserDicts:(NSArray *)userDicts inManagedObjectContext:(NSManagedObjectContext *)context
+{
+    [GRVCoreDataImport importObjects:userDicts inBatchesOfSize:kGRVCoreDataImportBatchSize inManagedObjectContext:context usingImportBatch:^NSArray *(NSArray *batch, NSManagedObjectContext *context) {
+        return [GRVUser usersWithUserInfoArray:batch inManagedObjectContext:context];
+    }];
+}
+
+/**
+ * Videos with random ordering attributes, left unsaved in the context.
+ */
++ (NSArray *)insertVideosWithCount:(NSUInteger)count inManagedObjectContext:(NSManagedObjectContext *)context
+{
+    srand48(kGRVPerformanceTestsRandomSeed);
+    NSDate *now = [NSDate date];
+    NSMutableArray *videos = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        GRVVideo *video = [NSEntityDescription insertNewObjectForEntityForName:@"GRVVideo" inManagedObjectContext:context];
+        video.hashKey = [NSString stringWithFormat:@"Video%06lu", (unsigned long)i];
+        video.canonicalHashKey = [GRVCoreDataImport canonicalIdentifier:video.hashKey];
+        video.participation = @(lrand48() % 3);
+        video.unseenClipsCount = @(lrand48() % 4);
+        video.unseenLikesCount = @(lrand48() % 4);
+        video.score = @(drand48() * 1000.0);
+        video.updatedAt = [now dateByAddingTimeInterval:-(drand48() * 86400.0 * 30.0)];
+        [videos addObject:video];
+    }
+    return videos;
+}
+
+
+#pragma mark - Core Data Imports
+- (void)testImportInsert100UsersPerformance
+{
+    NSArray *userDicts = [GRVPerformanceTests userDictsWithCount:100];
+    [self measureWithSetup:nil measure:^(NSManagedObjectContext *context) {
+        [GRVPerformanceTests importUserDicts:userDicts inManagedObjectContext:context];
+    }];
+}
+
+- (void)testImportInsert1000UsersPerformance
+{
+    NSArray *userDicts = [GRVPerformanceTests userDictsWithCount:1000];
+    [self measureWithSetup:nil measure:^(NSManagedObjectContext *context) {
+        [GRVPerformanceTests importUserDicts:userDicts inManagedObjectContext:context];
+    }];
+}
+
+- (void)testImportInsert10000UsersPerformance
+{
+    NSArray *userDicts = [GRVPerformanceTests userDictsWithCount:10000];
+    [self measureWithSetup:nil measure:^(NSManagedObjectContext *context) {
+        [GRVPerformanceTests importUserDicts:userDicts inManagedObjectContext:context];
+    }];
+}
+
+- (void)testImportUpdate1000UsersPerformance
+{
+    NSArray *userDicts = [GRVPerformanceTests userDictsWithCount:1000];
+    [self measureWithSetup:^(NSManagedObjectContext *context) {
+        [GRVPerformanceTests importUserDicts:userDicts inManagedObjectContext:context];
+    } measure:^(NSManagedObjectContext *context) {
+        [GRVPerformanceTests importUserDicts:userDicts inManagedObjectContext:context];
+    }];
+}
+
+- (void)testDelete1000UsersPerformance
+{
+    NSArray *userDicts = [GRVPerformanceTests userDictsWithCount:1000];
+    NSArray *keptUserDicts = [userDicts subarrayWithRange:NSMakeRange(0, [userDicts count] / 2)];
+    [self measureWithSetup:^(NSManagedObjectContext *context) {
+        [GRVPerformanceTests importUserDicts:userDicts inManagedObjectContext:context];
+    } measure:^(NSManagedObjectContext *context) {
+        [GRVCoreDataImport deleteObjectsNotInObjectInfoArray:keptUserDicts
+                                      inManagedObjectContext:context
+                                                    forClass:[GRVUser class]
+                                    usingAdditionalPredicate:nil
+                                     withObjectIdentifierKey:@"canonicalPhoneNumber"
+                                        andDictIdentifierKey:kGRVRESTUserPhoneNumberKey];
+        [context save:NULL];
+    }];
+}
+
+
+#pragma mark - Contacts
+- (void)testSync5000ContactsPerformance
+{
+    NSArray *contactDicts = [GRVPerformanceTests contactDictsWithCount:5000];
+    [self measureWithSetup:nil measure:^(NSManagedObjectContext *context) {
+        [GRVContact syncContactsWithContactInfoArray:contactDicts inManagedObjectContext:context];
+    }];
+}
+
+- (void)testResync5000ContactsPerformance
+{
+    // A tenth of the contacts were deleted from the address book and the rest
+    // are unchanged, as on most syncs.
+    NSArray *contactDicts = [GRVPerformanceTests contactDictsWithCount:5000];
+    NSArray *keptContactDicts = [contactDicts subarrayWithRange:NSMakeRange(0, 4500)];
+    [self measureWithSetup:^(NSManagedObjectContext *context) {
+        [GRVContact syncContactsWithContactInfoArray:contactDicts inManagedObjectContext:context];
+    } measure:^(NSManagedObjectContext *context) {
+        [GRVContact syncContactsWithContactInfoArray:keptContactDicts inManagedObjectContext:context];
+    }];
+}
+
+- (void)testSearch5000ContactsPerformance
+{
+    NSArray *contactDicts = [GRVPerformanceTests contactDictsWithCount:5000];
+    // Typing "Chioma1 Eze" one keystroke at a time, one search per keystroke,
+    // against an index built after the contacts sync as the app does.
+    NSString *typedSearchString = @"Chioma1 Eze";
+    __block GRVContactNameIndex *index = nil;
+    [self measureWithSetup:^(NSManagedObjectContext *context) {
+        [GRVContact syncContactsWithContactInfoArray:contactDicts inManagedObjectContext:context];
+        [context save:NULL];
+        // Build the index with a query that matches no one and that the
+        // typed query doesn't extend.
+        index = [[GRVContactNameIndex alloc] initWithManagedObjectContext:context];
+        [index usersMatchingSearchString:@"-"];
+    } measure:^(NSManagedObjectContext *context) {
+        for (NSUInteger length = 1; length <= [typedSearchString length]; length++) {
+            NSString *searchString = [[typedSearchString substringToIndex:length] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+            [index usersMatchingSearchString:searchString];
+        }
+    }];
+    index = nil;
+}
+
+
+#pragma mark - Views
+- (void)testRender200AvatarsPerformance
+{
+    CGFloat scale = [UIScreen mainScreen].scale;
+    [self measureBlock:^{
+        // Avatars are rendered on a background queue and delivered on the main
+        // queue, so wait on an expectation rather than block the main queue.
+        XCTestExpectation *renderedExpectation = [self expectationWithDescription:@"avatars rendered"];
+        __block NSUInteger renderedCount = 0;
+        for (NSUInteger i = 0; i < 200; i++) {
+            NSString *initials = [NSString stringWithFormat:@"%@%@",
+                                  [kGRVPerformanceTestsFirstNames[i % kGRVPerformanceTestsNamesCount] substringToIndex:1],
+                                  [kGRVPerformanceTestsLastNames[(i / kGRVPerformanceTestsNamesCount) % kGRVPerformanceTestsNamesCount] substringToIndex:1]];
+            [[GRVAvatarImageCache sharedCache] renderAvatarWithThumbnail:nil initials:initials diameter:40.0 scale:scale cacheKey:nil completion:^(UIImage *avatarImage) {
+                if (++renderedCount == 200) [renderedExpectation fulfill];
+            }];
+        }
+        [self waitForExpectationsWithTimeout:30.0 handler:nil];
+    }];
+}
+
+- (void)testReorder1000VideosPerformance
+{
+    __block NSArray *videos = nil;
+    [self measureWithSetup:^(NSManagedObjectContext *context) {
+        videos = [GRVPerformanceTests insertVideosWithCount:1000 inManagedObjectContext:context];
+    } measure:^(NSManagedObjectContext *context) {
+        [GRVVideo reorderVideos:videos];
+    }];
+}
+
+@end